@@ -17,5 +17,22 @@
 #define TOG_BIT(REG,BIT)               (REG^=(1<<BIT))                     // toggle a bit in the register
 #define GET_BIT(REG,BIT)               ((REG>>BIT)&1)                      // Output is 0 or 1
 
+/*
+ * Cortex-M4 bit-band: each bit of SRAM (0x20000000 - 0x200FFFFF) and of the peripherals
+ * (0x40000000 - 0x400FFFFF) has a word alias, one store to it changes only that bit in a single
+ * bus transaction that an interrupt cannot split.
+ * - REG must be a variable / register inside these regions (not CCM RAM, AHB2 or the core peripherals),
+ * - not for write-1-to-clear registers (EXTI PR, DMA IFCR ...) the bus rewrites the other bits as read,
+ * - BB_TOG_BIT is a load and a store of the alias, the other bits stay safe.
+ */
+#define BB_ALIAS_ADDR(ADDR,BIT)        ((((u32)(ADDR)) & 0xF0000000UL) + 0x02000000UL + ((((u32)(ADDR)) & 0x000FFFFFUL) << 5) + ((u32)(BIT) << 2))
+#define BB_ALIAS(REG,BIT)              (*(volatile u32 *)BB_ALIAS_ADDR(&(REG),BIT))
+
+#define BB_SET_BIT(REG,BIT)            (BB_ALIAS(REG,BIT) = 1)             // set a bit, one store
+#define BB_CLR_BIT(REG,BIT)            (BB_ALIAS(REG,BIT) = 0)             // clear a bit, one store
+#define BB_TOG_BIT(REG,BIT)            (BB_ALIAS(REG,BIT) ^= 1)            // toggle a bit
+#define BB_GET_BIT(REG,BIT)            (BB_ALIAS(REG,BIT))                 // Output is 0 or 1
+#define BB_WRITE_BIT(REG,BIT,VAL)      (BB_ALIAS(REG,BIT) = ((VAL) != 0))  // bit = VAL, one store
+
 
 #endif /* BIT_MATH_H_ */
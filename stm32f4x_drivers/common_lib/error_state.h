@@ -18,6 +18,7 @@ typedef enum
 	ES_NULL_PTR,
 	ES_FUNC_IS_BUSY,
 	ES_FUNC_IS_IDLE,
+	ES_TIME_OUT,
 }ES_t;
 
 
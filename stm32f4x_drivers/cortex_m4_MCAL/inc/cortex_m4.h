@@ -206,6 +206,55 @@ ES_t MCAL_SysTick_BaisyWait(u32 TimeOut);
 ES_t MCAL_SysTick_SingleTick(void (*CallBackFuc)(void));
 ES_t MCAL_SysTick_PeriodicTick(void (*CallBackFuc)(void));
 
+/*
+ * number of periodic ticks since the periodic tick was started (wraps at 2^32)
+ */
+u32 MCAL_SysTick_GetTicks(void);
+
+
+
+/***********************************************************
+ *
+ *                     DWT
+ *
+ * *********************************************************
+ */
+
+typedef struct
+{
+  __vo u32 CTRL;                   /* DWT Control Register                */
+  __vo u32 CYCCNT;                 /* DWT Cycle Count Register            */
+} DWT_t;
+
+#define DWT                      ((DWT_t *)0xE0001000)
+
+#define SCB_DEMCR   *((__vo u32*)0xE000EDFC)
+
+#define DEMCR_TRCENA                                 24  /* Enables DWT and ITM                   */
+#define DWT_CTRL_CYCCNTENA                           0   /* Enables the cycle counter             */
+
+
+/*
+ * core clock cycle counter (wraps at 2^32), e.g. for timestamps
+ */
+ES_t MCAL_DWT_EnableCycleCounter(void);
+u32  MCAL_DWT_GetCycles(void);
+
+
+
+/***********************************************************
+ *
+ *                     PRIMASK
+ *
+ * *********************************************************
+ */
+
+/*
+ * short critical sections, Disable returns the previous PRIMASK for Restore (they nest)
+ */
+u32  MCAL_PRIMASK_DisableIRQ(void);
+void MCAL_PRIMASK_RestoreIRQ(u32 PriMask);
+
 
 
 #endif /* CORTEX_M4_MCAL_INC_CORTEX_M4_H_ */
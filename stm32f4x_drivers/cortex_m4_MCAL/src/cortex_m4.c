@@ -254,6 +254,8 @@ u8 MCAL_SysTick_Type = MCAL_SYSTICK_BUSY_WAIT;
 void (*SysTick_pfSingleTickCallBack)(void)   = NULL;
 void (*SysTick_pfPeriodicTickCallBack)(void) = NULL;
 
+__vo u32 SysTick_u32Ticks = 0;
+
 
 ES_t MCAL_SysTick_EnableCounter(void)
 {
@@ -382,6 +384,12 @@ ES_t MCAL_SysTick_PeriodicTick(void (*CallBackFuc)(void))
 }
 
 
+u32 MCAL_SysTick_GetTicks(void)
+{
+	return SysTick_u32Ticks;
+}
+
+
 void SysTick_Handler(void)
 {
 
@@ -401,6 +409,9 @@ void SysTick_Handler(void)
 	}
 	else if (MCAL_SysTick_Type == MCAL_SYSTICK_PERIODIC_TICK)
 	{
+		//time base for driver timeouts
+		SysTick_u32Ticks++;
+
 		if( SysTick_pfPeriodicTickCallBack != NULL)
 		{
 			SysTick_pfPeriodicTickCallBack();
@@ -410,3 +421,55 @@ void SysTick_Handler(void)
 }
 
 
+
+/***********************************************************
+ *
+ *                     DWT
+ *
+ * *********************************************************
+ */
+
+ES_t MCAL_DWT_EnableCycleCounter(void)
+{
+	ES_t errorState=ES_NOT_OK;
+
+	SET_BIT(SCB_DEMCR,DEMCR_TRCENA);
+
+	DWT->CYCCNT = 0;
+	SET_BIT(DWT->CTRL,DWT_CTRL_CYCCNTENA);
+
+	errorState = ES_OK;
+
+	return errorState;
+}
+
+
+u32 MCAL_DWT_GetCycles(void)
+{
+	return DWT->CYCCNT;
+}
+
+
+
+/***********************************************************
+ *
+ *                     PRIMASK
+ *
+ * *********************************************************
+ */
+
+u32 MCAL_PRIMASK_DisableIRQ(void)
+{
+	u32 PriMask;
+
+	__asm volatile ("MRS %0, primask" : "=r" (PriMask));
+	__asm volatile ("CPSID i" : : : "memory");
+
+	return PriMask;
+}
+
+
+void MCAL_PRIMASK_RestoreIRQ(u32 PriMask)
+{
+	__asm volatile ("MSR primask, %0" : : "r" (PriMask) : "memory");
+}
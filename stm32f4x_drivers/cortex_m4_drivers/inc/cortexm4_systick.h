@@ -52,5 +52,11 @@ ES_t SysTick_enuInit(SysTic_ClkSrc_t Copy_enuClockSource);
 
 ES_t SysTick_enuStart(SysTick_Handle_t *Copy_pstrSysTickHandle);
 
+/*
+ * Periodic tick counter (SysTick_PeriodicTick must be running), used as time base for timeouts:
+ * elapsed = now - start, wrap safe.
+ */
+ES_t SysTick_enuGetTicks(u32 *Copy_pu32Ticks);
+
 
 #endif /* CORTEX_M4_DRIVERS_INC_CORTEXM4_SYSTICK_H_ */
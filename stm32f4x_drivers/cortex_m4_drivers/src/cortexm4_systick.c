@@ -91,6 +91,17 @@ ES_t SysTick_enuStart(SysTick_Handle_t *Copy_pstrSysTickHandle)
 }
 
 
+ES_t SysTick_enuGetTicks(u32 *Copy_pu32Ticks)
+{
+	if(Copy_pu32Ticks == NULL)
+		return ES_NULL_PTR;
+
+	*Copy_pu32Ticks = MCAL_SysTick_GetTicks();
+
+	return ES_OK;
+}
+
+
 
 
 
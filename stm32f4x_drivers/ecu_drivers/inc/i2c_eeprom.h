@@ -0,0 +1,114 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : i2c_eeprom.h
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef ECU_DRIVERS_INC_I2C_EEPROM_H_
+#define ECU_DRIVERS_INC_I2C_EEPROM_H_
+
+/*
+ * 24-series I2C EEPROM (24LC01 .. 24LC512 and compatibles):
+ * - writes are split on page boundaries, each page is one bus job,
+ * - the end of the write cycle is found by ACK polling from the job callbacks: the device does not
+ *   acknowledge its address while it is busy, so the next page is simply resent until it is accepted
+ *   and the last one is followed by a one byte read,
+ * - reads are one sequential transaction whatever their length.
+ */
+#define EEP_BASE_ADDRESS              0x50
+
+//largest page handled, 24LC512 has 128 bytes pages
+#ifndef EEP_MAX_PAGE_SIZE
+#define EEP_MAX_PAGE_SIZE             128
+#endif
+
+//write cycle is 5 ms max on 24LCxx, counted in SysTick ticks (SysTick_enuGetTicks)
+#ifndef EEP_WRITE_TIMEOUT_TICKS
+#define EEP_WRITE_TIMEOUT_TICKS       10
+#endif
+
+//ACK polls of one write cycle, one per I2C_enuArloService call,
+//the only bound when SysTick is not in periodic mode
+#ifndef EEP_WRITE_POLL_MAX
+#define EEP_WRITE_POLL_MAX            400
+#endif
+
+
+typedef enum
+{
+	EEP_Idle,
+	EEP_BUSY_InRead,
+	EEP_BUSY_InWrite
+}EEP_State_t;
+
+typedef enum
+{
+	EEP_Step_None,
+	EEP_Step_Data,
+	EEP_Step_Poll
+}EEP_Step_t;
+
+
+/*
+ *Handle structure for an EEPROM device
+ * - pI2CHandle must be initialized as master with its event / error IRQs calling
+ *   I2C_EV_IRQHandling / I2C_ER_IRQHandling, the bus may be shared with other job users.
+ *   Each job after the first follows a STOP and is started by I2C_enuArloService, to be called
+ *   periodically (e.g. from the SysTick callback).
+ * - SlaveAddr: EEP_BASE_ADDRESS | A2..A0 (the block bits of small parts are added by the driver).
+ * - AddrSize: I2C_MemAddr_8Bits up to 24LC16, I2C_MemAddr_16Bits from 24LC32.
+ * - Size and PageSize in bytes (PageSize up to EEP_MAX_PAGE_SIZE).
+ */
+typedef struct
+{
+	I2C_Job_t          Job;            //first member, the job callback gets back to its handle
+	I2C_Handle_t       *pI2CHandle;
+	u8                 SlaveAddr;
+	I2C_MemAddrSize_t  AddrSize;
+	u32                Size;
+	u16                PageSize;
+	__vo EEP_State_t   State;
+	EEP_Step_t         Step;
+	ES_t               Result;
+	u32                Addr;
+	u8                 *pData;
+	u32                Len;
+	u32                ChunkLen;
+	u32                PollStart;
+	u16                PollCount;
+	u8                 Buffer[2 + EEP_MAX_PAGE_SIZE];
+	u8                 Dummy;
+	void (*CallBackFunc)(ES_t Result);
+}EEP_Handle_t;
+
+
+/*
+ * Checks the configuration and that the device acknowledges its address (blocking)
+ */
+ES_t EEP_enuInit(EEP_Handle_t *Copy_pstrEEPHandle);
+
+/*
+ * Writes any length, Copy_pu8Data must stay valid until CallBack (may be NULL).
+ * Result is ES_TIME_OUT when the device does not come back within EEP_WRITE_TIMEOUT_TICKS
+ * (or EEP_WRITE_POLL_MAX polls), other bus errors end the write at once with their job result.
+ */
+ES_t EEP_enuWriteIT(EEP_Handle_t *Copy_pstrEEPHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len,
+		void (*CallBack)(ES_t Result));
+
+/*
+ * Reads any length in one transaction, waits for a write cycle in progress the same way
+ */
+ES_t EEP_enuReadIT(EEP_Handle_t *Copy_pstrEEPHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len,
+		void (*CallBack)(ES_t Result));
+
+ES_t EEP_enuGetState(EEP_Handle_t *Copy_pstrEEPHandle, EEP_State_t *Copy_penuState);
+
+
+#endif /* ECU_DRIVERS_INC_I2C_EEPROM_H_ */
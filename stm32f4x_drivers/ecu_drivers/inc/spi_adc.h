@@ -0,0 +1,48 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : spi_adc.h
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef ECU_DRIVERS_INC_SPI_ADC_H_
+#define ECU_DRIVERS_INC_SPI_ADC_H_
+
+/*
+ * Timer paced sampling of an external SPI ADC (one conversion per SPI frame, e.g. AD7476, ADS8320):
+ * - the timer update event requests one DMA write to the SPI which clocks one sample in,
+ * - the timer channel drives CS in PWM mode, low from the update event for CSPulse counts,
+ *   so CS is pulsed for every sample by hardware (SSOE would keep NSS low as long as SPE is set),
+ * - samples land in a circular buffer, CallBackFunc gets each filled half.
+ */
+typedef struct
+{
+	SPI_Handle_t       *pSPIHandle;
+	TIM_Handle_t       *pTIMHandle;
+	DMA_Handle_t       *pTrigDMAHandle;
+	TIM_Channel_t      CSChannel;
+	u32                CSPulse;
+	void (*CallBackFunc)(u8 *pData, u32 Len);
+}SPIADC_Handle_t;
+
+
+/*
+ * - pSPIHandle: initialized master with SPI_DFF matching the ADC word, pRxDMAHandle set, software NSS.
+ * - pTIMHandle: TIMConfig gives the sample period, the CSChannel pin is set to its timer alternate function.
+ * - pTrigDMAHandle: DMAx, Stream and DMA_Channel of the TIMx_UP request, its IRQ is not used.
+ * - CSPulse must cover one SPI frame and stay below the timer period.
+ * - SPI_DMA_IRQHandling must be called from the SPI RX stream IRQ handler.
+ */
+ES_t SPIADC_enuStart(SPIADC_Handle_t *Copy_pstrADCHandle, u8 *Copy_pu8Buffer, u32 Copy_u32Len,
+		void (*CallBack)(u8 *pData, u32 Len));
+
+ES_t SPIADC_enuStop(SPIADC_Handle_t *Copy_pstrADCHandle);
+
+
+#endif /* ECU_DRIVERS_INC_SPI_ADC_H_ */
@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : spi_link.h
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef ECU_DRIVERS_INC_SPI_LINK_H_
+#define ECU_DRIVERS_INC_SPI_LINK_H_
+
+/*
+ * Point to point link between two boards over SPI (one master, one slave):
+ * - every exchange is one full duplex frame of LINK_FRAME_SIZE bytes followed by the hardware CRC,
+ * - DATA frames carry a sequence number, every frame carries the next expected sequence (Ack)
+ *   and the free RX slots of its sender (Credits),
+ * - up to LINK_WINDOW frames are sent without ack, they are resent from the first unacked one (go back N)
+ *   when the ack does not move for LINK_RETRY_EXCHANGES exchanges,
+ * - the slave drives a Ready pin high once its DMA is armed, the master only selects it then.
+ */
+#ifndef LINK_FRAME_SIZE
+#define LINK_FRAME_SIZE               64
+#endif
+
+#define LINK_HEADER_SIZE              8
+#define LINK_PAYLOAD_SIZE             (LINK_FRAME_SIZE - LINK_HEADER_SIZE)
+
+//must be a power of 2, sequence numbers wrap at 256
+#ifndef LINK_WINDOW
+#define LINK_WINDOW                   4
+#endif
+
+#ifndef LINK_RX_QUEUE_LEN
+#define LINK_RX_QUEUE_LEN             4
+#endif
+
+//the ack of a frame comes back at the earliest one exchange later
+#ifndef LINK_RETRY_EXCHANGES
+#define LINK_RETRY_EXCHANGES          4
+#endif
+
+//CRC-16 CCITT, used with 16 bits frames
+#define LINK_CRC_POLYNOMIAL           0x1021
+
+
+/*
+ * @LINK_FrameType
+ */
+typedef enum
+{
+	LINK_Frame_Idle,
+	LINK_Frame_Data
+}LINK_FrameType_t;
+
+/*
+ * @LINK_Role
+ */
+typedef enum
+{
+	LINK_Master,
+	LINK_Slave
+}LINK_Role_t;
+
+
+typedef struct
+{
+	u8  Type;
+	u8  Seq;
+	u8  Ack;
+	u8  Credits;
+	u16 Len;             //keeps the frame half-word aligned for the 16 bits DMA
+	u8  Pending;
+	u8  Reserved;
+	u8  Payload[LINK_PAYLOAD_SIZE];
+}LINK_Frame_t;
+
+
+typedef struct
+{
+	u32 TxFrames;
+	u32 RxFrames;
+	u32 CRCErrors;
+	u32 Retransmits;
+	u32 Dropped;
+}LINK_Stats_t;
+
+
+/*
+ *Handle structure for one end of the link
+ * - pSPIHandle: initialized with SPI_DFF_16Bits, pTxDMAHandle and pRxDMAHandle set,
+ *   SPI_DMA_IRQHandling must be called from both stream IRQ handlers and SPI_IRQHandling
+ *   from the SPI IRQ handler (CRC frame).
+ *   The master uses software NSS and drives CSPort/CSPin, the slave uses hardware NSS.
+ * - ReadyPort/ReadyPin: output on the slave, input on the master.
+ * - ErrorNotifyFunc (may be NULL) is called from the DMA IRQ when the slave fails to re-arm.
+ */
+typedef struct
+{
+	SPI_Handle_t       *pSPIHandle;
+	LINK_Role_t        Role;
+	GPIO_Port_t        CSPort;
+	GPIO_Pin_t         CSPin;
+	GPIO_Port_t        ReadyPort;
+	GPIO_Pin_t         ReadyPin;
+	LINK_Frame_t       TxWindow[LINK_WINDOW];
+	__vo u8            TxNextSeq;
+	u8                 TxSendSeq;
+	u8                 TxHighSeq;
+	u8                 PeerAck;
+	u8                 PeerCredits;
+	u8                 PeerPending;
+	u8                 AckOwed;
+	u8                 NoProgress;
+	LINK_Frame_t       RxQueue[LINK_RX_QUEUE_LEN];
+	__vo u8            RxHead;
+	__vo u8            RxTail;
+	u8                 RxExpectedSeq;
+	LINK_Frame_t       TxFrame;
+	LINK_Frame_t       RxFrame;
+	__vo u8            Busy;
+	__vo u8            FrameDone;
+	LINK_Stats_t       Stats;
+	void (*RxNotifyFunc)(void);
+	void (*ErrorNotifyFunc)(ES_t Error);
+}LINK_Handle_t;
+
+
+/*
+ * Enables the CRC and, on the slave, arms the first exchange.
+ * RxNotify (may be NULL) is called from the DMA IRQ when a frame is queued.
+ */
+ES_t LINK_enuInit(LINK_Handle_t *Copy_pstrLinkHandle, void (*RxNotify)(void));
+
+/*
+ * Queues Copy_u8Len (<= LINK_PAYLOAD_SIZE) bytes, ES_FUNC_IS_BUSY while the window is full
+ */
+ES_t LINK_enuSend(LINK_Handle_t *Copy_pstrLinkHandle, const u8 *Copy_pu8Data, u8 Copy_u8Len);
+
+/*
+ * Copies the oldest received payload, ES_FUNC_IS_IDLE when nothing was received
+ */
+ES_t LINK_enuReceive(LINK_Handle_t *Copy_pstrLinkHandle, u8 *Copy_pu8Data, u8 *Copy_pu8Len);
+
+/*
+ * Master only, starts an exchange when the slave is ready and there is something to send, to ack,
+ * or pending on the slave side, Copy_u8Force polls the slave anyway (to be called periodically).
+ */
+ES_t LINK_enuPoll(LINK_Handle_t *Copy_pstrLinkHandle, u8 Copy_u8Force);
+
+/*
+ * Slave only, to be called from the NSS rising edge EXTI (priority not above the SPI and SPI DMA IRQs),
+ * a frame cut short by the master is dropped and the slave is re-armed, a failed re-arm is retried.
+ */
+ES_t LINK_enuFrameEnd(LINK_Handle_t *Copy_pstrLinkHandle);
+
+ES_t LINK_enuGetStats(LINK_Handle_t *Copy_pstrLinkHandle, LINK_Stats_t *Copy_pstrStats);
+
+
+#endif /* ECU_DRIVERS_INC_SPI_LINK_H_ */
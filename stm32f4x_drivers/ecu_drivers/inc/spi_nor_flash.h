@@ -0,0 +1,149 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : spi_nor_flash.h
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef ECU_DRIVERS_INC_SPI_NOR_FLASH_H_
+#define ECU_DRIVERS_INC_SPI_NOR_FLASH_H_
+
+/*
+ * Generic 25-series SPI NOR flash (3 bytes addressing, up to 16 MB)
+ */
+#define NOR_PAGE_SIZE                 256
+#define NOR_SECTOR_SIZE               4096
+
+/*
+ * Read cache, small reads (e.g. log headers) are served from RAM blocks
+ * that are invalidated by program / erase of the same area.
+ */
+#ifndef NOR_CACHE_BLOCKS
+#define NOR_CACHE_BLOCKS              4
+#endif
+
+#ifndef NOR_CACHE_BLOCK_SIZE
+#define NOR_CACHE_BLOCK_SIZE          256
+#endif
+
+#define NOR_CACHE_INVALID             0xFFFFFFFF
+
+/*
+ * Busy (WIP) timeouts in NOR_enuTick calls from the start of each page program or sector erase
+ * (page program 5 ms, sector erase 400 ms max on common parts), the operation then ends with ES_TIME_OUT
+ */
+#ifndef NOR_PROGRAM_TIMEOUT_TICKS
+#define NOR_PROGRAM_TIMEOUT_TICKS     10
+#endif
+
+#ifndef NOR_ERASE_TIMEOUT_TICKS
+#define NOR_ERASE_TIMEOUT_TICKS       500
+#endif
+
+
+typedef enum
+{
+	NOR_Idle,
+	NOR_BUSY_InRead,
+	NOR_BUSY_InProgram,
+	NOR_BUSY_InErase
+}NOR_State_t;
+
+typedef enum
+{
+	NOR_Step_None,
+	NOR_Step_WriteEnable,
+	NOR_Step_Cmd,
+	NOR_Step_Data,
+	NOR_Step_Poll,
+	NOR_Step_Wait
+}NOR_Step_t;
+
+
+typedef struct
+{
+	u32 Tag;
+	u8  Data[NOR_CACHE_BLOCK_SIZE];
+}NOR_CacheBlock_t;
+
+
+/*
+ *Handle structure for a NOR flash device
+ * - pSPIHandle must be initialized (8 bits frames, mode 0 or 3) and CS pin configured as output.
+ * - DMA handles of the SPI handle are needed for NOR_enuReadDMA, NOR_enuProgramIT and NOR_enuEraseSectorIT,
+ *   SPI_DMA_IRQHandling must be called from their stream IRQ handlers.
+ * - NOR_enuProgramIT and NOR_enuEraseSectorIT need NOR_enuTick to be called periodically.
+ */
+typedef struct
+{
+	SPI_Handle_t       *pSPIHandle;
+	GPIO_Port_t        CSPort;
+	GPIO_Pin_t         CSPin;
+	u8                 ManufacturerID;
+	u8                 MemoryType;
+	u8                 CapacityCode;
+	u32                Size;
+	__vo NOR_State_t   State;
+	__vo NOR_Step_t    Step;
+	ES_t               Result;
+	u32                Addr;
+	u8                 *pData;
+	u32                Len;
+	u32                ChunkLen;
+	u8                 Cmd[5];
+	u8                 Status[2];
+	__vo u32           PollTicks;
+	NOR_CacheBlock_t   Cache[NOR_CACHE_BLOCKS];
+	u8                 CacheNext;
+	void (*CallBackFunc)(ES_t Result);
+}NOR_Handle_t;
+
+
+/*
+ * Probes the JEDEC ID, fails with ES_NOT_OK when no device answers
+ */
+ES_t NOR_enuInit(NOR_Handle_t *Copy_pstrNORHandle);
+
+ES_t NOR_enuReadJEDECID(NOR_Handle_t *Copy_pstrNORHandle, u8 *Copy_pu8ID);
+
+/*
+ * Blocking read, reads up to NOR_CACHE_BLOCK_SIZE go through the cache
+ */
+ES_t NOR_enuRead(NOR_Handle_t *Copy_pstrNORHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len);
+
+/*
+ * Fast read by DMA, CallBack may be NULL
+ */
+ES_t NOR_enuReadDMA(NOR_Handle_t *Copy_pstrNORHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len,
+		void (*CallBack)(ES_t Result));
+
+/*
+ * Programs any length split on page boundaries, WREN, command and data are DMA phases chained
+ * from the DMA interrupts, the status register is then read once per NOR_enuTick and the next
+ * page is started as soon as the previous one is done.
+ * Copy_pu8Data must stay valid until CallBack.
+ */
+ES_t NOR_enuProgramIT(NOR_Handle_t *Copy_pstrNORHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len,
+		void (*CallBack)(ES_t Result));
+
+ES_t NOR_enuEraseSectorIT(NOR_Handle_t *Copy_pstrNORHandle, u32 Copy_u32Addr, void (*CallBack)(ES_t Result));
+
+/*
+ * Paces the busy polling of program / erase: to be called periodically (e.g. from a SysTick
+ * periodic or timer update callback), the period bounds the latency of each page and erase
+ * and scales NOR_PROGRAM_TIMEOUT_TICKS / NOR_ERASE_TIMEOUT_TICKS.
+ */
+ES_t NOR_enuTick(NOR_Handle_t *Copy_pstrNORHandle);
+
+ES_t NOR_enuGetState(NOR_Handle_t *Copy_pstrNORHandle, NOR_State_t *Copy_penuState);
+
+ES_t NOR_enuInvalidateCache(NOR_Handle_t *Copy_pstrNORHandle);
+
+
+#endif /* ECU_DRIVERS_INC_SPI_NOR_FLASH_H_ */
@@ -0,0 +1,129 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : spi_sd.h
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef ECU_DRIVERS_INC_SPI_SD_H_
+#define ECU_DRIVERS_INC_SPI_SD_H_
+
+#define SD_BLOCK_SIZE                 512
+
+/*
+ * Token and busy polling of the asynchronous transfers is done by DMA bursts of SD_POLL_BURST_LEN
+ * bytes (at least 16, CMD12 with its R1 fits in one burst).
+ */
+#ifndef SD_POLL_BURST_LEN
+#define SD_POLL_BURST_LEN             16
+#endif
+
+/*
+ * Blocking identification timeout in polled bytes while waiting for the CSD token
+ */
+#ifndef SD_TOKEN_POLL_MAX
+#define SD_TOKEN_POLL_MAX             100000
+#endif
+
+/*
+ * Asynchronous transfer timeouts in SD_enuTick calls (read access 100 ms, write busy 250 ms max)
+ */
+#ifndef SD_TOKEN_TIMEOUT_TICKS
+#define SD_TOKEN_TIMEOUT_TICKS        100
+#endif
+
+#ifndef SD_BUSY_TIMEOUT_TICKS
+#define SD_BUSY_TIMEOUT_TICKS         500
+#endif
+
+
+typedef enum
+{
+	SD_CardType_Unknown,
+	SD_CardType_SDv1,
+	SD_CardType_SDv2,
+	SD_CardType_SDHC
+}SD_CardType_t;
+
+typedef enum
+{
+	SD_Idle,
+	SD_BUSY_InRead,
+	SD_BUSY_InWrite
+}SD_State_t;
+
+typedef enum
+{
+	SD_Step_None,
+	SD_Step_Token,
+	SD_Step_Data,
+	SD_Step_Resp,
+	SD_Step_Busy,
+	SD_Step_Stop
+}SD_Step_t;
+
+
+/*
+ *Handle structure for an SD card in SPI mode
+ * - pSPIHandle must be initialized as master (8 bits frames, mode 0) with its DMA handles,
+ *   SPI_DMA_IRQHandling must be called from the DMA stream IRQ handlers.
+ * - InitClkSpeed must give at most 400 KHz, FastClkSpeed at most 25 MHz.
+ * - CS pin must be configured as output.
+ * - SD_enuTick must be called periodically (e.g. every 1 ms) while transfers run.
+ */
+typedef struct
+{
+	SPI_Handle_t       *pSPIHandle;
+	GPIO_Port_t        CSPort;
+	GPIO_Pin_t         CSPin;
+	SPI_SclkSpeed_t    InitClkSpeed;
+	SPI_SclkSpeed_t    FastClkSpeed;
+	SD_CardType_t      CardType;
+	u32                BlockCount;
+	__vo SD_State_t    State;
+	__vo SD_Step_t     Step;
+	ES_t               Result;
+	u8                 *pData;
+	u32                BlocksLeft;
+	__vo u32           PollTicks;
+	__vo u8            PollPending;
+	u8                 PollSkip;
+	u8                 PollBuffer[SD_POLL_BURST_LEN];
+	u8                 StopFrame[SD_POLL_BURST_LEN];
+	void (*CallBackFunc)(ES_t Result);
+}SD_Handle_t;
+
+
+/*
+ * Blocking card identification at InitClkSpeed, then switches to FastClkSpeed
+ */
+ES_t SD_enuInit(SD_Handle_t *Copy_pstrSDHandle);
+
+/*
+ * Asynchronous multi-block transfers (CMD18 / CMD25) moved by DMA,
+ * Copy_pu8Data must stay valid until CallBack which is called from interrupt.
+ */
+ES_t SD_enuReadBlocks(SD_Handle_t *Copy_pstrSDHandle, u32 Copy_u32Block, u8 *Copy_pu8Data, u32 Copy_u32Count,
+		void (*CallBack)(ES_t Result));
+
+ES_t SD_enuWriteBlocks(SD_Handle_t *Copy_pstrSDHandle, u32 Copy_u32Block, u8 *Copy_pu8Data, u32 Copy_u32Count,
+		void (*CallBack)(ES_t Result));
+
+/*
+ * Time base of the asynchronous transfers: counts their timeouts and paces the write busy
+ * polling to one burst per call.
+ */
+ES_t SD_enuTick(SD_Handle_t *Copy_pstrSDHandle);
+
+ES_t SD_enuGetState(SD_Handle_t *Copy_pstrSDHandle, SD_State_t *Copy_penuState);
+
+ES_t SD_enuGetBlockCount(SD_Handle_t *Copy_pstrSDHandle, u32 *Copy_pu32BlockCount);
+
+
+#endif /* ECU_DRIVERS_INC_SPI_SD_H_ */
@@ -0,0 +1,101 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : spi_tft.h
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef ECU_DRIVERS_INC_SPI_TFT_H_
+#define ECU_DRIVERS_INC_SPI_TFT_H_
+
+/*
+ * ILI9341 / ST7789 panels in RGB565 (MIPI DCS command set)
+ */
+#ifndef TFT_MAX_DIRTY_RECTS
+#define TFT_MAX_DIRTY_RECTS           8
+#endif
+
+//must be a power of 2
+#ifndef TFT_FLUSH_QUEUE_LEN
+#define TFT_FLUSH_QUEUE_LEN           4
+#endif
+
+//limited by the DMA counter
+#define TFT_MAX_TILE_PIXELS           0xFFFF
+
+
+typedef struct
+{
+	u16 X;
+	u16 Y;
+	u16 Width;
+	u16 Height;
+}TFT_Window_t;
+
+typedef struct
+{
+	TFT_Window_t Window;
+	u16          *pPixels;
+}TFT_Flush_t;
+
+
+/*
+ *Handle structure for a TFT panel
+ * - pSPIHandle must be initialized as master (8 bits frames) with its DMA handles,
+ *   SPI_DMA_IRQHandling must be called from the DMA stream IRQ handlers.
+ * - CS and DC pins must be configured as outputs, the panel must already be
+ *   initialized (sleep out, pixel format 16 bits, display on).
+ * - FlushDoneFunc is called from interrupt with the pixel buffer that can be reused,
+ *   Result is ES_NOT_OK when the tile could not be sent (then it may also be called from
+ *   TFT_enuQueueFlush), the queue goes on with the next tile.
+ */
+typedef struct
+{
+	SPI_Handle_t       *pSPIHandle;
+	GPIO_Port_t        CSPort;
+	GPIO_Pin_t         CSPin;
+	GPIO_Port_t        DCPort;
+	GPIO_Pin_t         DCPin;
+	u16                Width;
+	u16                Height;
+	TFT_Window_t       Dirty[TFT_MAX_DIRTY_RECTS];
+	u8                 DirtyCount;
+	TFT_Flush_t        Queue[TFT_FLUSH_QUEUE_LEN];
+	__vo u8            QueueHead;
+	__vo u8            QueueTail;
+	__vo u8            Busy;
+	void (*FlushDoneFunc)(u16 *pPixels, ES_t Result);
+}TFT_Handle_t;
+
+
+ES_t TFT_enuInit(TFT_Handle_t *Copy_pstrTFTHandle);
+
+/*
+ * Adds an area to redraw, overlapping or touching areas are merged
+ */
+ES_t TFT_enuMarkDirty(TFT_Handle_t *Copy_pstrTFTHandle, TFT_Window_t *Copy_pstrWindow);
+
+/*
+ * Pops the next tile to render out of the dirty areas, whole rows of at most Copy_u32MaxPixels,
+ * returns ES_NOT_OK when nothing is left to redraw.
+ * Copy_u32MaxPixels must hold at least one full display line.
+ */
+ES_t TFT_enuGetNextDirtyTile(TFT_Handle_t *Copy_pstrTFTHandle, u32 Copy_u32MaxPixels, TFT_Window_t *Copy_pstrTile);
+
+/*
+ * Queues a rendered tile, it is sent by DMA as soon as the previous ones are done,
+ * returns ES_FUNC_IS_BUSY when the queue is full.
+ * Must be called from thread mode only.
+ */
+ES_t TFT_enuQueueFlush(TFT_Handle_t *Copy_pstrTFTHandle, TFT_Window_t *Copy_pstrWindow, u16 *Copy_pu16Pixels);
+
+ES_t TFT_enuIsBusy(TFT_Handle_t *Copy_pstrTFTHandle, u8 *Copy_pu8Busy);
+
+
+#endif /* ECU_DRIVERS_INC_SPI_TFT_H_ */
@@ -0,0 +1,304 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : i2c_eeprom.c
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+
+#include "stm32f4xxx_gpio_exti.h"
+#include "stm32f4xxx_dma.h"
+#include "stm32f4xxx_i2c.h"
+#include "cortexm4_systick.h"
+#include "i2c_eeprom.h"
+
+
+static u8   eep_slave_addr(EEP_Handle_t *pEEPHandle, u32 Addr);
+static u8   eep_set_addr(EEP_Handle_t *pEEPHandle, u32 Addr);
+static void eep_start_page(EEP_Handle_t *pEEPHandle);
+static void eep_start_poll(EEP_Handle_t *pEEPHandle);
+static void eep_submit(EEP_Handle_t *pEEPHandle);
+static void eep_finish(EEP_Handle_t *pEEPHandle, ES_t Result);
+static void eep_job_done(I2C_Job_t *pJob);
+static ES_t eep_start_async(EEP_Handle_t *pEEPHandle, EEP_State_t State, u32 Addr, u8 *pData, u32 Len,
+		void (*CallBack)(ES_t Result));
+
+
+ES_t EEP_enuInit(EEP_Handle_t *Copy_pstrEEPHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrEEPHandle==NULL || Copy_pstrEEPHandle->pI2CHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrEEPHandle->Size == 0 || Copy_pstrEEPHandle->PageSize == 0 ||
+			Copy_pstrEEPHandle->PageSize > EEP_MAX_PAGE_SIZE ||
+			(Copy_pstrEEPHandle->AddrSize != I2C_MemAddr_8Bits && Copy_pstrEEPHandle->AddrSize != I2C_MemAddr_16Bits))
+		return ES_NOT_OK;
+
+	//8 bits parts address the upper 3 bits through the slave address (24LC16 at most)
+	if(Copy_pstrEEPHandle->AddrSize == I2C_MemAddr_8Bits && Copy_pstrEEPHandle->Size > 2048)
+		return ES_NOT_OK;
+
+	Copy_pstrEEPHandle->State = EEP_Idle;
+	Copy_pstrEEPHandle->Step = EEP_Step_None;
+	Copy_pstrEEPHandle->CallBackFunc = NULL;
+
+	//a current address read of one byte, only an absent (or busy) device NACKs it
+	Local_enuErrorState = I2C_enuMasterReceiveData(Copy_pstrEEPHandle->pI2CHandle, &Copy_pstrEEPHandle->Dummy, 1,
+			Copy_pstrEEPHandle->SlaveAddr, I2C_DisableRepStart);
+
+	return Local_enuErrorState;
+}
+
+
+ES_t EEP_enuWriteIT(EEP_Handle_t *Copy_pstrEEPHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len,
+		void (*CallBack)(ES_t Result))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrEEPHandle==NULL || Copy_pu8Data==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u32Len == 0 || Copy_u32Addr >= Copy_pstrEEPHandle->Size || Copy_u32Len > Copy_pstrEEPHandle->Size - Copy_u32Addr)
+		return ES_NOT_OK;
+
+	Local_enuErrorState = eep_start_async(Copy_pstrEEPHandle, EEP_BUSY_InWrite, Copy_u32Addr, Copy_pu8Data, Copy_u32Len, CallBack);
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		eep_start_page(Copy_pstrEEPHandle);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t EEP_enuReadIT(EEP_Handle_t *Copy_pstrEEPHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len,
+		void (*CallBack)(ES_t Result))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrEEPHandle==NULL || Copy_pu8Data==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u32Len == 0 || Copy_u32Addr >= Copy_pstrEEPHandle->Size || Copy_u32Len > Copy_pstrEEPHandle->Size - Copy_u32Addr)
+		return ES_NOT_OK;
+
+	Local_enuErrorState = eep_start_async(Copy_pstrEEPHandle, EEP_BUSY_InRead, Copy_u32Addr, Copy_pu8Data, Copy_u32Len, CallBack);
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		//address write, repeated START then the whole length, the address counter crosses pages on reads
+		Copy_pstrEEPHandle->Job.SlaveAddr = eep_slave_addr(Copy_pstrEEPHandle, Copy_u32Addr);
+		Copy_pstrEEPHandle->Job.pTxData = Copy_pstrEEPHandle->Buffer;
+		Copy_pstrEEPHandle->Job.TxLen = eep_set_addr(Copy_pstrEEPHandle, Copy_u32Addr);
+		Copy_pstrEEPHandle->Job.pRxData = Copy_pu8Data;
+		Copy_pstrEEPHandle->Job.RxLen = Copy_u32Len;
+		Copy_pstrEEPHandle->Step = EEP_Step_Data;
+
+		eep_submit(Copy_pstrEEPHandle);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t EEP_enuGetState(EEP_Handle_t *Copy_pstrEEPHandle, EEP_State_t *Copy_penuState)
+{
+	if(Copy_pstrEEPHandle==NULL || Copy_penuState==NULL)
+		return ES_NULL_PTR;
+
+	*Copy_penuState = Copy_pstrEEPHandle->State;
+
+	return ES_OK;
+}
+
+
+//some helper function implementations
+
+static u8 eep_slave_addr(EEP_Handle_t *Copy_pstrEEPHandle, u32 Copy_u32Addr)
+{
+	if(Copy_pstrEEPHandle->AddrSize == I2C_MemAddr_8Bits)
+	{
+		//block select bits take the place of A2..A0
+		return (Copy_pstrEEPHandle->SlaveAddr | ((Copy_u32Addr >> 8) & 0x07));
+	}
+
+	return Copy_pstrEEPHandle->SlaveAddr;
+}
+
+/*
+ * Word address at the head of Buffer (MSB first), returns its length
+ */
+static u8 eep_set_addr(EEP_Handle_t *Copy_pstrEEPHandle, u32 Copy_u32Addr)
+{
+	if(Copy_pstrEEPHandle->AddrSize == I2C_MemAddr_16Bits)
+	{
+		Copy_pstrEEPHandle->Buffer[0] = (u8)(Copy_u32Addr >> 8);
+		Copy_pstrEEPHandle->Buffer[1] = (u8)Copy_u32Addr;
+		return 2;
+	}
+
+	Copy_pstrEEPHandle->Buffer[0] = (u8)Copy_u32Addr;
+	return 1;
+}
+
+static void eep_start_page(EEP_Handle_t *Copy_pstrEEPHandle)
+{
+	u32 Local_u32PageLeft = Copy_pstrEEPHandle->PageSize - (Copy_pstrEEPHandle->Addr % Copy_pstrEEPHandle->PageSize);
+	u8  Local_u8AddrLen = eep_set_addr(Copy_pstrEEPHandle, Copy_pstrEEPHandle->Addr);
+
+	Copy_pstrEEPHandle->ChunkLen = (Copy_pstrEEPHandle->Len > Local_u32PageLeft)? Local_u32PageLeft : Copy_pstrEEPHandle->Len;
+
+	//address and data must go out as one job
+	for(u32 Local_u32Index = 0 ; Local_u32Index < Copy_pstrEEPHandle->ChunkLen ; Local_u32Index++)
+	{
+		Copy_pstrEEPHandle->Buffer[Local_u8AddrLen + Local_u32Index] = Copy_pstrEEPHandle->pData[Local_u32Index];
+	}
+
+	Copy_pstrEEPHandle->Job.SlaveAddr = eep_slave_addr(Copy_pstrEEPHandle, Copy_pstrEEPHandle->Addr);
+	Copy_pstrEEPHandle->Job.pTxData = Copy_pstrEEPHandle->Buffer;
+	Copy_pstrEEPHandle->Job.TxLen = Local_u8AddrLen + Copy_pstrEEPHandle->ChunkLen;
+	Copy_pstrEEPHandle->Job.pRxData = NULL;
+	Copy_pstrEEPHandle->Job.RxLen = 0;
+	Copy_pstrEEPHandle->Step = EEP_Step_Data;
+
+	eep_submit(Copy_pstrEEPHandle);
+}
+
+static void eep_start_poll(EEP_Handle_t *Copy_pstrEEPHandle)
+{
+	Copy_pstrEEPHandle->Job.SlaveAddr = Copy_pstrEEPHandle->SlaveAddr;
+	Copy_pstrEEPHandle->Job.pTxData = NULL;
+	Copy_pstrEEPHandle->Job.TxLen = 0;
+	Copy_pstrEEPHandle->Job.pRxData = &Copy_pstrEEPHandle->Dummy;
+	Copy_pstrEEPHandle->Job.RxLen = 1;
+	Copy_pstrEEPHandle->Step = EEP_Step_Poll;
+
+	eep_submit(Copy_pstrEEPHandle);
+}
+
+static void eep_submit(EEP_Handle_t *Copy_pstrEEPHandle)
+{
+	//the device acts on STOP, the bus is never kept for the next job
+	Copy_pstrEEPHandle->Job.Sr = I2C_DisableRepStart;
+	Copy_pstrEEPHandle->Job.Priority = 0;
+	Copy_pstrEEPHandle->Job.Deadline = 0;
+	Copy_pstrEEPHandle->Job.CallBackFunc = eep_job_done;
+
+	if(I2C_enuSubmitJob(Copy_pstrEEPHandle->pI2CHandle, &Copy_pstrEEPHandle->Job) != ES_OK)
+	{
+		eep_finish(Copy_pstrEEPHandle, ES_NOT_OK);
+	}
+}
+
+static void eep_finish(EEP_Handle_t *Copy_pstrEEPHandle, ES_t Copy_enuResult)
+{
+	Copy_pstrEEPHandle->Step = EEP_Step_None;
+	Copy_pstrEEPHandle->Result = Copy_enuResult;
+	Copy_pstrEEPHandle->State = EEP_Idle;
+
+	if(Copy_pstrEEPHandle->CallBackFunc != NULL)
+	{
+		Copy_pstrEEPHandle->CallBackFunc(Copy_enuResult);
+	}
+}
+
+/*
+ * Job completion (I2C event / error interrupt), drives the read / write state machines
+ */
+static void eep_job_done(I2C_Job_t *Copy_pstrJob)
+{
+	EEP_Handle_t *Local_pstrEEPHandle = (EEP_Handle_t *)Copy_pstrJob;
+
+	u32 Local_u32Now = 0;
+
+	SysTick_enuGetTicks(&Local_u32Now);
+
+	if(Copy_pstrJob->Result != ES_OK)
+	{
+		//only a NACKed address is the device in its write cycle, anything else ends the transfer
+		if(Copy_pstrJob->Result != ES_NOT_OK || ! Copy_pstrJob->AddrNack)
+		{
+			eep_finish(Local_pstrEEPHandle, Copy_pstrJob->Result);
+		}
+		//the same job is the next poll, the tick count only moves with a periodic SysTick
+		else if((Local_u32Now - Local_pstrEEPHandle->PollStart) < EEP_WRITE_TIMEOUT_TICKS &&
+				Local_pstrEEPHandle->PollCount < EEP_WRITE_POLL_MAX)
+		{
+			Local_pstrEEPHandle->PollCount++;
+
+			eep_submit(Local_pstrEEPHandle);
+		}
+		else
+		{
+			eep_finish(Local_pstrEEPHandle, ES_TIME_OUT);
+		}
+
+		return;
+	}
+
+	switch(Local_pstrEEPHandle->Step)
+	{
+	case EEP_Step_Data:
+		if(Local_pstrEEPHandle->State == EEP_BUSY_InRead)
+		{
+			eep_finish(Local_pstrEEPHandle, ES_OK);
+			break;
+		}
+
+		Local_pstrEEPHandle->pData += Local_pstrEEPHandle->ChunkLen;
+		Local_pstrEEPHandle->Addr += Local_pstrEEPHandle->ChunkLen;
+		Local_pstrEEPHandle->Len -= Local_pstrEEPHandle->ChunkLen;
+
+		//the write cycle starts on this STOP
+		Local_pstrEEPHandle->PollStart = Local_u32Now;
+		Local_pstrEEPHandle->PollCount = 0;
+
+		if(Local_pstrEEPHandle->Len > 0)
+		{
+			//the next page is its own ACK poll, it is accepted as soon as the cycle ends
+			eep_start_page(Local_pstrEEPHandle);
+		}
+		else
+		{
+			eep_start_poll(Local_pstrEEPHandle);
+		}
+		break;
+
+	case EEP_Step_Poll:
+		eep_finish(Local_pstrEEPHandle, ES_OK);
+		break;
+
+	default:
+		break;
+	}
+}
+
+static ES_t eep_start_async(EEP_Handle_t *Copy_pstrEEPHandle, EEP_State_t Copy_enuState, u32 Copy_u32Addr, u8 *Copy_pu8Data,
+		u32 Copy_u32Len, void (*CallBack)(ES_t Result))
+{
+	if(Copy_pstrEEPHandle->State != EEP_Idle)
+		return ES_FUNC_IS_BUSY;
+
+	Copy_pstrEEPHandle->State = Copy_enuState;
+	Copy_pstrEEPHandle->Addr = Copy_u32Addr;
+	Copy_pstrEEPHandle->pData = Copy_pu8Data;
+	Copy_pstrEEPHandle->Len = Copy_u32Len;
+	Copy_pstrEEPHandle->CallBackFunc = CallBack;
+
+	//a write cycle started before (e.g. by the previous write) is waited for from now
+	SysTick_enuGetTicks(&Copy_pstrEEPHandle->PollStart);
+	Copy_pstrEEPHandle->PollCount = 0;
+
+	return ES_OK;
+}
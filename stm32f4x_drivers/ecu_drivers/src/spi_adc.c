@@ -0,0 +1,83 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : spi_adc.c
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+
+#include "stm32f4xxx_dma.h"
+#include "stm32f4xxx_spi.h"
+#include "stm32f4xxx_tim.h"
+#include "spi_adc.h"
+
+
+ES_t SPIADC_enuStart(SPIADC_Handle_t *Copy_pstrADCHandle, u8 *Copy_pu8Buffer, u32 Copy_u32Len,
+		void (*CallBack)(u8 *pData, u32 Len))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrADCHandle==NULL || Copy_pstrADCHandle->pSPIHandle==NULL || Copy_pstrADCHandle->pTIMHandle==NULL ||
+			Copy_pstrADCHandle->pTrigDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrADCHandle->CSPulse == 0 || Copy_pstrADCHandle->CSPulse > Copy_pstrADCHandle->pTIMHandle->TIMConfig.TIM_Period)
+		return ES_NOT_OK;
+
+	Copy_pstrADCHandle->CallBackFunc = CallBack;
+
+	Local_enuErrorState = TIM_enuInit(Copy_pstrADCHandle->pTIMHandle);
+
+	if(Local_enuErrorState != ES_OK)
+		return Local_enuErrorState;
+
+	//CS is active (low) while the counter is below CSPulse, i.e. from each update event
+	Local_enuErrorState = TIM_enuConfigOutputCompare(Copy_pstrADCHandle->pTIMHandle, Copy_pstrADCHandle->CSChannel,
+			TIM_OCMode_PWM1, TIM_OCPolarity_Low, Copy_pstrADCHandle->CSPulse);
+
+	if(Local_enuErrorState != ES_OK)
+		return Local_enuErrorState;
+
+	//the SPI and its DMA streams must be armed before the first request
+	Local_enuErrorState = SPI_enuTriggeredRxStart(Copy_pstrADCHandle->pSPIHandle, Copy_pstrADCHandle->pTrigDMAHandle,
+			Copy_pu8Buffer, Copy_u32Len, CallBack);
+
+	if(Local_enuErrorState != ES_OK)
+	{
+		TIM_enuDisableOutputCompare(Copy_pstrADCHandle->pTIMHandle, Copy_pstrADCHandle->CSChannel);
+		return Local_enuErrorState;
+	}
+
+	TIM_enuUpdateDMAControl(Copy_pstrADCHandle->pTIMHandle, ENABLE);
+
+	Local_enuErrorState = TIM_enuStart(Copy_pstrADCHandle->pTIMHandle);
+
+	return Local_enuErrorState;
+}
+
+
+ES_t SPIADC_enuStop(SPIADC_Handle_t *Copy_pstrADCHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrADCHandle==NULL)
+		return ES_NULL_PTR;
+
+	TIM_enuStop(Copy_pstrADCHandle->pTIMHandle);
+
+	TIM_enuUpdateDMAControl(Copy_pstrADCHandle->pTIMHandle, DISABLE);
+
+	TIM_enuDisableOutputCompare(Copy_pstrADCHandle->pTIMHandle, Copy_pstrADCHandle->CSChannel);
+
+	Local_enuErrorState = SPI_enuTriggeredRxStop(Copy_pstrADCHandle->pSPIHandle);
+
+	return Local_enuErrorState;
+}
@@ -0,0 +1,422 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : spi_link.c
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+
+#include "stm32f4xxx_gpio_exti.h"
+#include "stm32f4xxx_dma.h"
+#include "stm32f4xxx_spi.h"
+#include "spi_link.h"
+
+
+static u8   link_rx_free(LINK_Handle_t *pLinkHandle);
+static void link_build_tx(LINK_Handle_t *pLinkHandle);
+static void link_process_rx(LINK_Handle_t *pLinkHandle);
+static ES_t link_start_exchange(LINK_Handle_t *pLinkHandle);
+static void link_spi_done(void);
+
+//SPI callbacks carry no context, one link per board
+static LINK_Handle_t *link_active = NULL;
+
+
+ES_t LINK_enuInit(LINK_Handle_t *Copy_pstrLinkHandle, void (*RxNotify)(void))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrLinkHandle==NULL || Copy_pstrLinkHandle->pSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrLinkHandle->Role > LINK_Slave)
+		return ES_NOT_OK;
+
+	//the CRC frame size follows SPI_DFF, 16 bits frames give CRC-16
+	if(Copy_pstrLinkHandle->pSPIHandle->SPIConfig.SPI_DFF != SPI_DFF_16Bits)
+		return ES_NOT_OK;
+
+	Copy_pstrLinkHandle->TxNextSeq = 0;
+	Copy_pstrLinkHandle->TxSendSeq = 0;
+	Copy_pstrLinkHandle->TxHighSeq = 0;
+	Copy_pstrLinkHandle->PeerAck = 0;
+	//nothing is sent before the first credits are known
+	Copy_pstrLinkHandle->PeerCredits = 0;
+	Copy_pstrLinkHandle->PeerPending = 0;
+	Copy_pstrLinkHandle->AckOwed = 0;
+	Copy_pstrLinkHandle->NoProgress = 0;
+	Copy_pstrLinkHandle->RxHead = 0;
+	Copy_pstrLinkHandle->RxTail = 0;
+	Copy_pstrLinkHandle->RxExpectedSeq = 0;
+	Copy_pstrLinkHandle->Busy = 0;
+	Copy_pstrLinkHandle->FrameDone = 0;
+	Copy_pstrLinkHandle->Stats.TxFrames = 0;
+	Copy_pstrLinkHandle->Stats.RxFrames = 0;
+	Copy_pstrLinkHandle->Stats.CRCErrors = 0;
+	Copy_pstrLinkHandle->Stats.Retransmits = 0;
+	Copy_pstrLinkHandle->Stats.Dropped = 0;
+	Copy_pstrLinkHandle->RxNotifyFunc = RxNotify;
+
+	link_active = Copy_pstrLinkHandle;
+
+	Local_enuErrorState = SPI_enuCRCControl(Copy_pstrLinkHandle->pSPIHandle, LINK_CRC_POLYNOMIAL, ENABLE);
+
+	if(Local_enuErrorState != ES_OK)
+		return Local_enuErrorState;
+
+	if(Copy_pstrLinkHandle->Role == LINK_Master)
+	{
+		GPIO_enuWriteToOutputPin(Copy_pstrLinkHandle->CSPort, Copy_pstrLinkHandle->CSPin, GPIO_HIGH);
+	}
+	else
+	{
+		GPIO_enuWriteToOutputPin(Copy_pstrLinkHandle->ReadyPort, Copy_pstrLinkHandle->ReadyPin, GPIO_LOW);
+
+		link_build_tx(Copy_pstrLinkHandle);
+		Local_enuErrorState = link_start_exchange(Copy_pstrLinkHandle);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t LINK_enuSend(LINK_Handle_t *Copy_pstrLinkHandle, const u8 *Copy_pu8Data, u8 Copy_u8Len)
+{
+	if(Copy_pstrLinkHandle==NULL || Copy_pu8Data==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u8Len == 0 || Copy_u8Len > LINK_PAYLOAD_SIZE)
+		return ES_NOT_OK;
+
+	u8 Local_u8Seq = Copy_pstrLinkHandle->TxNextSeq;
+
+	//the slot is reused only once its frame is acked
+	if((u8)(Local_u8Seq - Copy_pstrLinkHandle->PeerAck) >= LINK_WINDOW)
+		return ES_FUNC_IS_BUSY;
+
+	LINK_Frame_t *Local_pstrFrame = &Copy_pstrLinkHandle->TxWindow[Local_u8Seq & (LINK_WINDOW - 1)];
+
+	Local_pstrFrame->Type = LINK_Frame_Data;
+	Local_pstrFrame->Seq = Local_u8Seq;
+	Local_pstrFrame->Len = Copy_u8Len;
+
+	for(u8 Local_u8Index = 0; Local_u8Index < Copy_u8Len; Local_u8Index++)
+	{
+		Local_pstrFrame->Payload[Local_u8Index] = Copy_pu8Data[Local_u8Index];
+	}
+
+	//published last, the IRQ side only looks below TxNextSeq
+	Copy_pstrLinkHandle->TxNextSeq = Local_u8Seq + 1;
+
+	return ES_OK;
+}
+
+
+ES_t LINK_enuReceive(LINK_Handle_t *Copy_pstrLinkHandle, u8 *Copy_pu8Data, u8 *Copy_pu8Len)
+{
+	if(Copy_pstrLinkHandle==NULL || Copy_pu8Data==NULL || Copy_pu8Len==NULL)
+		return ES_NULL_PTR;
+
+	u8 Local_u8Tail = Copy_pstrLinkHandle->RxTail;
+
+	if(Local_u8Tail == Copy_pstrLinkHandle->RxHead)
+		return ES_FUNC_IS_IDLE;
+
+	LINK_Frame_t *Local_pstrFrame = &Copy_pstrLinkHandle->RxQueue[Local_u8Tail % LINK_RX_QUEUE_LEN];
+
+	for(u16 Local_u16Index = 0; Local_u16Index < Local_pstrFrame->Len; Local_u16Index++)
+	{
+		Copy_pu8Data[Local_u16Index] = Local_pstrFrame->Payload[Local_u16Index];
+	}
+
+	*Copy_pu8Len = (u8)Local_pstrFrame->Len;
+
+	Copy_pstrLinkHandle->RxTail = Local_u8Tail + 1;
+
+	return ES_OK;
+}
+
+
+ES_t LINK_enuPoll(LINK_Handle_t *Copy_pstrLinkHandle, u8 Copy_u8Force)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	GPIO_PinState_t Local_enuReady = GPIO_LOW;
+
+	if(Copy_pstrLinkHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrLinkHandle->Role != LINK_Master)
+		return ES_NOT_OK;
+
+	if(Copy_pstrLinkHandle->Busy)
+		return ES_FUNC_IS_BUSY;
+
+	GPIO_enuReadFromInputPin(Copy_pstrLinkHandle->ReadyPort, Copy_pstrLinkHandle->ReadyPin, &Local_enuReady);
+
+	if(Local_enuReady != GPIO_HIGH)
+		return ES_FUNC_IS_BUSY;
+
+	if( ! Copy_u8Force && Copy_pstrLinkHandle->TxNextSeq == Copy_pstrLinkHandle->PeerAck &&
+			! Copy_pstrLinkHandle->PeerPending && ! Copy_pstrLinkHandle->AckOwed)
+		return ES_FUNC_IS_IDLE;
+
+	link_build_tx(Copy_pstrLinkHandle);
+
+	GPIO_enuWriteToOutputPin(Copy_pstrLinkHandle->CSPort, Copy_pstrLinkHandle->CSPin, GPIO_LOW);
+
+	Local_enuErrorState = link_start_exchange(Copy_pstrLinkHandle);
+
+	if(Local_enuErrorState != ES_OK)
+	{
+		GPIO_enuWriteToOutputPin(Copy_pstrLinkHandle->CSPort, Copy_pstrLinkHandle->CSPin, GPIO_HIGH);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t LINK_enuFrameEnd(LINK_Handle_t *Copy_pstrLinkHandle)
+{
+	ES_t Local_enuErrorState = ES_OK;
+
+	if(Copy_pstrLinkHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrLinkHandle->Role != LINK_Slave)
+		return ES_NOT_OK;
+
+	//a complete frame was already handled by link_spi_done, the next one is armed
+	if(Copy_pstrLinkHandle->FrameDone)
+	{
+		Copy_pstrLinkHandle->FrameDone = 0;
+		return ES_OK;
+	}
+
+	if( ! Copy_pstrLinkHandle->Busy)
+	{
+		//the re-arm from link_spi_done failed, try again
+		link_build_tx(Copy_pstrLinkHandle);
+		return link_start_exchange(Copy_pstrLinkHandle);
+	}
+
+	//is the DMA still waiting for frames of the deselected exchange
+	if(Copy_pstrLinkHandle->pSPIHandle->RxState == SPI_BUSY_InDMA)
+	{
+		GPIO_enuWriteToOutputPin(Copy_pstrLinkHandle->ReadyPort, Copy_pstrLinkHandle->ReadyPin, GPIO_LOW);
+
+		SPI_enuAbortDMA(Copy_pstrLinkHandle->pSPIHandle);
+		Copy_pstrLinkHandle->Busy = 0;
+		Copy_pstrLinkHandle->Stats.Dropped++;
+
+		//the master saw no ack for the frame it sent, a sent DATA frame is resent by the window
+		link_build_tx(Copy_pstrLinkHandle);
+		Local_enuErrorState = link_start_exchange(Copy_pstrLinkHandle);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t LINK_enuGetStats(LINK_Handle_t *Copy_pstrLinkHandle, LINK_Stats_t *Copy_pstrStats)
+{
+	if(Copy_pstrLinkHandle==NULL || Copy_pstrStats==NULL)
+		return ES_NULL_PTR;
+
+	*Copy_pstrStats = Copy_pstrLinkHandle->Stats;
+
+	return ES_OK;
+}
+
+
+/*
+ * Helper functions
+ */
+static u8 link_rx_free(LINK_Handle_t *pLinkHandle)
+{
+	return LINK_RX_QUEUE_LEN - (u8)(pLinkHandle->RxHead - pLinkHandle->RxTail);
+}
+
+
+static void link_build_tx(LINK_Handle_t *pLinkHandle)
+{
+	LINK_Frame_t *Local_pstrFrame = &pLinkHandle->TxFrame;
+
+	u8 Local_u8Limit = (pLinkHandle->PeerCredits < LINK_WINDOW)? pLinkHandle->PeerCredits : LINK_WINDOW;
+
+	u8 Local_u8Seq = pLinkHandle->TxSendSeq;
+
+	if(Local_u8Seq != pLinkHandle->TxNextSeq && (u8)(Local_u8Seq - pLinkHandle->PeerAck) < Local_u8Limit)
+	{
+		*Local_pstrFrame = pLinkHandle->TxWindow[Local_u8Seq & (LINK_WINDOW - 1)];
+
+		//below the highest sequence ever sent means go back N rewound
+		if((u8)(pLinkHandle->TxHighSeq - Local_u8Seq - 1) < LINK_WINDOW)
+		{
+			pLinkHandle->Stats.Retransmits++;
+		}
+		else
+		{
+			pLinkHandle->TxHighSeq = Local_u8Seq + 1;
+		}
+
+		pLinkHandle->TxSendSeq = Local_u8Seq + 1;
+		pLinkHandle->Stats.TxFrames++;
+	}
+	else
+	{
+		Local_pstrFrame->Type = LINK_Frame_Idle;
+		Local_pstrFrame->Seq = 0;
+		Local_pstrFrame->Len = 0;
+	}
+
+	//every frame carries the ack, nothing is owed anymore
+	Local_pstrFrame->Ack = pLinkHandle->RxExpectedSeq;
+	Local_pstrFrame->Credits = link_rx_free(pLinkHandle);
+	Local_pstrFrame->Pending = (pLinkHandle->TxNextSeq != pLinkHandle->PeerAck)? 1 : 0;
+	pLinkHandle->AckOwed = 0;
+}
+
+
+static void link_process_rx(LINK_Handle_t *pLinkHandle)
+{
+	LINK_Frame_t *Local_pstrFrame = &pLinkHandle->RxFrame;
+
+	u8 Local_u8CRCError = 0;
+
+	SPI_enuGetCRCError(pLinkHandle->pSPIHandle, &Local_u8CRCError);
+
+	if(Local_u8CRCError)
+	{
+		//nothing in the frame can be trusted, the missing ack triggers the resend
+		pLinkHandle->Stats.CRCErrors++;
+	}
+	else
+	{
+		u8 Local_u8Ack = Local_pstrFrame->Ack;
+
+		//only acks of frames that were sent are taken
+		if(Local_u8Ack != pLinkHandle->PeerAck &&
+				(u8)(Local_u8Ack - pLinkHandle->PeerAck) <= (u8)(pLinkHandle->TxHighSeq - pLinkHandle->PeerAck))
+		{
+			pLinkHandle->PeerAck = Local_u8Ack;
+			pLinkHandle->NoProgress = 0;
+
+			//a rewind may be behind the new ack
+			if((u8)(pLinkHandle->TxSendSeq - Local_u8Ack) > (u8)(pLinkHandle->TxHighSeq - Local_u8Ack))
+			{
+				pLinkHandle->TxSendSeq = Local_u8Ack;
+			}
+		}
+
+		pLinkHandle->PeerCredits = Local_pstrFrame->Credits;
+		pLinkHandle->PeerPending = Local_pstrFrame->Pending;
+
+		if(Local_pstrFrame->Type == LINK_Frame_Data)
+		{
+			if(Local_pstrFrame->Seq == pLinkHandle->RxExpectedSeq && Local_pstrFrame->Len <= LINK_PAYLOAD_SIZE &&
+					link_rx_free(pLinkHandle) > 0)
+			{
+				pLinkHandle->RxQueue[pLinkHandle->RxHead % LINK_RX_QUEUE_LEN] = *Local_pstrFrame;
+				pLinkHandle->RxHead++;
+				pLinkHandle->RxExpectedSeq++;
+				pLinkHandle->Stats.RxFrames++;
+
+				if(pLinkHandle->RxNotifyFunc != NULL)
+				{
+					pLinkHandle->RxNotifyFunc();
+				}
+			}
+			else
+			{
+				//out of order (a lost frame before it) or no room, the sender goes back to RxExpectedSeq
+				pLinkHandle->Stats.Dropped++;
+			}
+
+			//the ack has to reach the sender even with nothing to send back
+			pLinkHandle->AckOwed = 1;
+		}
+	}
+
+	if(pLinkHandle->PeerAck != pLinkHandle->TxSendSeq)
+	{
+		if(++pLinkHandle->NoProgress >= LINK_RETRY_EXCHANGES)
+		{
+			pLinkHandle->TxSendSeq = pLinkHandle->PeerAck;
+			pLinkHandle->NoProgress = 0;
+		}
+	}
+	else
+	{
+		pLinkHandle->NoProgress = 0;
+	}
+}
+
+
+static ES_t link_start_exchange(LINK_Handle_t *pLinkHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	pLinkHandle->Busy = 1;
+
+	Local_enuErrorState = SPI_enuTransceiveDMA(pLinkHandle->pSPIHandle, (u8*)&pLinkHandle->TxFrame,
+			(u8*)&pLinkHandle->RxFrame, LINK_FRAME_SIZE, link_spi_done);
+
+	if(Local_enuErrorState != ES_OK)
+	{
+		pLinkHandle->Busy = 0;
+	}
+	else if(pLinkHandle->Role == LINK_Slave)
+	{
+		//the master may clock as soon as it sees Ready
+		GPIO_enuWriteToOutputPin(pLinkHandle->ReadyPort, pLinkHandle->ReadyPin, GPIO_HIGH);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+static void link_spi_done(void)
+{
+	LINK_Handle_t *Local_pstrLinkHandle = link_active;
+	ES_t Local_enuErrorState;
+
+	if(Local_pstrLinkHandle == NULL)
+		return;
+
+	if(Local_pstrLinkHandle->Role == LINK_Master)
+	{
+		GPIO_enuWriteToOutputPin(Local_pstrLinkHandle->CSPort, Local_pstrLinkHandle->CSPin, GPIO_HIGH);
+
+		link_process_rx(Local_pstrLinkHandle);
+
+		Local_pstrLinkHandle->Busy = 0;
+	}
+	else
+	{
+		//not ready until the next frame is armed
+		GPIO_enuWriteToOutputPin(Local_pstrLinkHandle->ReadyPort, Local_pstrLinkHandle->ReadyPin, GPIO_LOW);
+
+		link_process_rx(Local_pstrLinkHandle);
+
+		Local_pstrLinkHandle->Busy = 0;
+		Local_pstrLinkHandle->FrameDone = 1;
+
+		link_build_tx(Local_pstrLinkHandle);
+		Local_enuErrorState = link_start_exchange(Local_pstrLinkHandle);
+
+		//Ready stays low so the master does not clock, LINK_enuFrameEnd retries
+		if(Local_enuErrorState != ES_OK && Local_pstrLinkHandle->ErrorNotifyFunc != NULL)
+		{
+			Local_pstrLinkHandle->ErrorNotifyFunc(Local_enuErrorState);
+		}
+	}
+}
@@ -0,0 +1,561 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : spi_nor_flash.c
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+
+#include "stm32f4xxx_gpio_exti.h"
+#include "stm32f4xxx_dma.h"
+#include "stm32f4xxx_spi.h"
+#include "spi_nor_flash.h"
+
+/*
+ * Commands
+ */
+#define NOR_CMD_WRITE_ENABLE          0x06
+#define NOR_CMD_READ_STATUS           0x05
+#define NOR_CMD_FAST_READ             0x0B
+#define NOR_CMD_PAGE_PROGRAM          0x02
+#define NOR_CMD_SECTOR_ERASE          0x20
+#define NOR_CMD_JEDEC_ID              0x9F
+
+#define NOR_STATUS_WIP                0
+
+//largest capacity reachable with 3 bytes addressing
+#define NOR_MAX_CAPACITY_CODE         24
+
+#define NOR_DMA_MAX_LEN               0xFFFF
+
+
+static void nor_select(NOR_Handle_t *pNORHandle);
+static void nor_deselect(NOR_Handle_t *pNORHandle);
+static void nor_set_cmd(NOR_Handle_t *pNORHandle, u8 Cmd, u32 Addr);
+static void nor_send_cmd(NOR_Handle_t *pNORHandle, u8 Cmd, u32 Addr, u8 CmdLen);
+static void nor_start_xfer(NOR_Handle_t *pNORHandle, NOR_Step_t Step, u8 *pTxData, u8 *pRxData, u32 Len);
+static void nor_start_read_chunk(NOR_Handle_t *pNORHandle);
+static void nor_start_write_enable(NOR_Handle_t *pNORHandle);
+static void nor_start_page(NOR_Handle_t *pNORHandle);
+static void nor_start_poll(NOR_Handle_t *pNORHandle);
+static void nor_finish(NOR_Handle_t *pNORHandle, ES_t Result);
+static void nor_spi_done(void);
+static void nor_cache_invalidate_range(NOR_Handle_t *pNORHandle, u32 Addr, u32 Len);
+static ES_t nor_read_direct(NOR_Handle_t *pNORHandle, u32 Addr, u8 *pData, u32 Len);
+static ES_t nor_start_async(NOR_Handle_t *pNORHandle, NOR_State_t State, u32 Addr, u8 *pData, u32 Len,
+		void (*CallBack)(ES_t Result));
+
+//SPI callbacks carry no context, only one asynchronous operation runs at a time
+static NOR_Handle_t *nor_active = NULL;
+
+
+ES_t NOR_enuInit(NOR_Handle_t *Copy_pstrNORHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	u8 Local_au8ID[3];
+
+	if(Copy_pstrNORHandle==NULL || Copy_pstrNORHandle->pSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	nor_deselect(Copy_pstrNORHandle);
+
+	Copy_pstrNORHandle->State = NOR_Idle;
+	Copy_pstrNORHandle->Step = NOR_Step_None;
+	Copy_pstrNORHandle->CallBackFunc = NULL;
+
+	NOR_enuInvalidateCache(Copy_pstrNORHandle);
+
+	Local_enuErrorState = NOR_enuReadJEDECID(Copy_pstrNORHandle, Local_au8ID);
+
+	if(Local_enuErrorState != ES_OK)
+		return Local_enuErrorState;
+
+	//a floating or shorted MISO reads all 0s or all 1s
+	if((Local_au8ID[0] == 0x00 || Local_au8ID[0] == 0xFF) ||
+			Local_au8ID[2] > NOR_MAX_CAPACITY_CODE || Local_au8ID[2] < 16)
+		return ES_NOT_OK;
+
+	Copy_pstrNORHandle->ManufacturerID = Local_au8ID[0];
+	Copy_pstrNORHandle->MemoryType = Local_au8ID[1];
+	Copy_pstrNORHandle->CapacityCode = Local_au8ID[2];
+	Copy_pstrNORHandle->Size = 1UL << Local_au8ID[2];
+
+	return Local_enuErrorState;
+}
+
+
+ES_t NOR_enuReadJEDECID(NOR_Handle_t *Copy_pstrNORHandle, u8 *Copy_pu8ID)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	u8 Local_au8Buffer[4] = {NOR_CMD_JEDEC_ID, 0xFF, 0xFF, 0xFF};
+
+	if(Copy_pstrNORHandle==NULL || Copy_pu8ID==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrNORHandle->State != NOR_Idle)
+		return ES_FUNC_IS_BUSY;
+
+	nor_select(Copy_pstrNORHandle);
+	Local_enuErrorState = SPI_enuTransceiveBurst(Copy_pstrNORHandle->pSPIHandle, Local_au8Buffer, Local_au8Buffer, 4);
+	nor_deselect(Copy_pstrNORHandle);
+
+	Copy_pu8ID[0] = Local_au8Buffer[1];
+	Copy_pu8ID[1] = Local_au8Buffer[2];
+	Copy_pu8ID[2] = Local_au8Buffer[3];
+
+	return Local_enuErrorState;
+}
+
+
+ES_t NOR_enuRead(NOR_Handle_t *Copy_pstrNORHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrNORHandle==NULL || Copy_pu8Data==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrNORHandle->State != NOR_Idle)
+		return ES_FUNC_IS_BUSY;
+
+	if(Copy_u32Addr >= Copy_pstrNORHandle->Size || Copy_u32Len > Copy_pstrNORHandle->Size - Copy_u32Addr)
+		return ES_NOT_OK;
+
+	if(Copy_u32Len > NOR_CACHE_BLOCK_SIZE)
+		return nor_read_direct(Copy_pstrNORHandle, Copy_u32Addr, Copy_pu8Data, Copy_u32Len);
+
+	Local_enuErrorState = ES_OK;
+
+	//the request spans at most two blocks
+	while(Copy_u32Len > 0 && Local_enuErrorState == ES_OK)
+	{
+		u32 Local_u32Tag = Copy_u32Addr - (Copy_u32Addr % NOR_CACHE_BLOCK_SIZE);
+		u32 Local_u32Offset = Copy_u32Addr - Local_u32Tag;
+		u32 Local_u32Count = NOR_CACHE_BLOCK_SIZE - Local_u32Offset;
+		NOR_CacheBlock_t *Local_pstrBlock = NULL;
+		u8 Local_u8Index;
+
+		if(Local_u32Count > Copy_u32Len)
+			Local_u32Count = Copy_u32Len;
+
+		for(Local_u8Index = 0 ; Local_u8Index < NOR_CACHE_BLOCKS ; Local_u8Index++)
+		{
+			if(Copy_pstrNORHandle->Cache[Local_u8Index].Tag == Local_u32Tag)
+			{
+				Local_pstrBlock = &Copy_pstrNORHandle->Cache[Local_u8Index];
+				break;
+			}
+		}
+
+		if(Local_pstrBlock == NULL)
+		{
+			//miss, replace blocks in round robin
+			Local_pstrBlock = &Copy_pstrNORHandle->Cache[Copy_pstrNORHandle->CacheNext];
+			Copy_pstrNORHandle->CacheNext = (Copy_pstrNORHandle->CacheNext + 1) % NOR_CACHE_BLOCKS;
+
+			Local_pstrBlock->Tag = NOR_CACHE_INVALID;
+			Local_enuErrorState = nor_read_direct(Copy_pstrNORHandle, Local_u32Tag, Local_pstrBlock->Data, NOR_CACHE_BLOCK_SIZE);
+
+			if(Local_enuErrorState == ES_OK)
+				Local_pstrBlock->Tag = Local_u32Tag;
+		}
+
+		if(Local_enuErrorState == ES_OK)
+		{
+			for(u32 Local_u32Index = 0 ; Local_u32Index < Local_u32Count ; Local_u32Index++)
+			{
+				Copy_pu8Data[Local_u32Index] = Local_pstrBlock->Data[Local_u32Offset + Local_u32Index];
+			}
+
+			Copy_pu8Data += Local_u32Count;
+			Copy_u32Addr += Local_u32Count;
+			Copy_u32Len -= Local_u32Count;
+		}
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t NOR_enuReadDMA(NOR_Handle_t *Copy_pstrNORHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len,
+		void (*CallBack)(ES_t Result))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrNORHandle==NULL || Copy_pu8Data==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u32Len == 0 || Copy_u32Addr >= Copy_pstrNORHandle->Size || Copy_u32Len > Copy_pstrNORHandle->Size - Copy_u32Addr)
+		return ES_NOT_OK;
+
+	Local_enuErrorState = nor_start_async(Copy_pstrNORHandle, NOR_BUSY_InRead, Copy_u32Addr, Copy_pu8Data, Copy_u32Len, CallBack);
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		nor_select(Copy_pstrNORHandle);
+		nor_send_cmd(Copy_pstrNORHandle, NOR_CMD_FAST_READ, Copy_u32Addr, 5);
+		nor_start_read_chunk(Copy_pstrNORHandle);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t NOR_enuProgramIT(NOR_Handle_t *Copy_pstrNORHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len,
+		void (*CallBack)(ES_t Result))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrNORHandle==NULL || Copy_pu8Data==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u32Len == 0 || Copy_u32Addr >= Copy_pstrNORHandle->Size || Copy_u32Len > Copy_pstrNORHandle->Size - Copy_u32Addr)
+		return ES_NOT_OK;
+
+	Local_enuErrorState = nor_start_async(Copy_pstrNORHandle, NOR_BUSY_InProgram, Copy_u32Addr, Copy_pu8Data, Copy_u32Len, CallBack);
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		nor_cache_invalidate_range(Copy_pstrNORHandle, Copy_u32Addr, Copy_u32Len);
+		nor_start_page(Copy_pstrNORHandle);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t NOR_enuEraseSectorIT(NOR_Handle_t *Copy_pstrNORHandle, u32 Copy_u32Addr, void (*CallBack)(ES_t Result))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrNORHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u32Addr >= Copy_pstrNORHandle->Size)
+		return ES_NOT_OK;
+
+	Copy_u32Addr -= Copy_u32Addr % NOR_SECTOR_SIZE;
+
+	Local_enuErrorState = nor_start_async(Copy_pstrNORHandle, NOR_BUSY_InErase, Copy_u32Addr, NULL, 0, CallBack);
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		nor_cache_invalidate_range(Copy_pstrNORHandle, Copy_u32Addr, NOR_SECTOR_SIZE);
+		nor_start_write_enable(Copy_pstrNORHandle);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t NOR_enuTick(NOR_Handle_t *Copy_pstrNORHandle)
+{
+	if(Copy_pstrNORHandle==NULL)
+		return ES_NULL_PTR;
+
+	//one status read per tick while the device is busy, nothing runs in between
+	if(Copy_pstrNORHandle->Step == NOR_Step_Wait)
+	{
+		Copy_pstrNORHandle->PollTicks++;
+
+		nor_start_poll(Copy_pstrNORHandle);
+	}
+
+	return ES_OK;
+}
+
+
+ES_t NOR_enuGetState(NOR_Handle_t *Copy_pstrNORHandle, NOR_State_t *Copy_penuState)
+{
+	if(Copy_pstrNORHandle==NULL || Copy_penuState==NULL)
+		return ES_NULL_PTR;
+
+	*Copy_penuState = Copy_pstrNORHandle->State;
+
+	return ES_OK;
+}
+
+
+ES_t NOR_enuInvalidateCache(NOR_Handle_t *Copy_pstrNORHandle)
+{
+	if(Copy_pstrNORHandle==NULL)
+		return ES_NULL_PTR;
+
+	for(u8 Local_u8Index = 0 ; Local_u8Index < NOR_CACHE_BLOCKS ; Local_u8Index++)
+	{
+		Copy_pstrNORHandle->Cache[Local_u8Index].Tag = NOR_CACHE_INVALID;
+	}
+
+	Copy_pstrNORHandle->CacheNext = 0;
+
+	return ES_OK;
+}
+
+
+//some helper function implementations
+
+static void nor_select(NOR_Handle_t *Copy_pstrNORHandle)
+{
+	GPIO_enuWriteToOutputPin(Copy_pstrNORHandle->CSPort, Copy_pstrNORHandle->CSPin, GPIO_LOW);
+}
+
+static void nor_deselect(NOR_Handle_t *Copy_pstrNORHandle)
+{
+	GPIO_enuWriteToOutputPin(Copy_pstrNORHandle->CSPort, Copy_pstrNORHandle->CSPin, GPIO_HIGH);
+}
+
+/*
+ * Command, 3 address bytes and (for fast read) one dummy byte
+ */
+static void nor_set_cmd(NOR_Handle_t *Copy_pstrNORHandle, u8 Copy_u8Cmd, u32 Copy_u32Addr)
+{
+	Copy_pstrNORHandle->Cmd[0] = Copy_u8Cmd;
+	Copy_pstrNORHandle->Cmd[1] = (u8)(Copy_u32Addr >> 16);
+	Copy_pstrNORHandle->Cmd[2] = (u8)(Copy_u32Addr >> 8);
+	Copy_pstrNORHandle->Cmd[3] = (u8)Copy_u32Addr;
+	Copy_pstrNORHandle->Cmd[4] = 0xFF;
+}
+
+/*
+ * Blocking command phase, CS must already be low
+ */
+static void nor_send_cmd(NOR_Handle_t *Copy_pstrNORHandle, u8 Copy_u8Cmd, u32 Copy_u32Addr, u8 Copy_u8CmdLen)
+{
+	nor_set_cmd(Copy_pstrNORHandle, Copy_u8Cmd, Copy_u32Addr);
+
+	SPI_enuTransceiveBurst(Copy_pstrNORHandle->pSPIHandle, Copy_pstrNORHandle->Cmd, NULL, Copy_u8CmdLen);
+}
+
+/*
+ * One DMA phase of the asynchronous operations with CS low, Step tells nor_spi_done what comes next
+ */
+static void nor_start_xfer(NOR_Handle_t *Copy_pstrNORHandle, NOR_Step_t Copy_enuStep, u8 *Copy_pu8TxData,
+		u8 *Copy_pu8RxData, u32 Copy_u32Len)
+{
+	Copy_pstrNORHandle->Step = Copy_enuStep;
+
+	nor_select(Copy_pstrNORHandle);
+
+	if(SPI_enuTransceiveDMA(Copy_pstrNORHandle->pSPIHandle, Copy_pu8TxData, Copy_pu8RxData,
+			Copy_u32Len, nor_spi_done) != ES_OK)
+	{
+		nor_deselect(Copy_pstrNORHandle);
+		nor_finish(Copy_pstrNORHandle, ES_NOT_OK);
+	}
+}
+
+static void nor_start_read_chunk(NOR_Handle_t *Copy_pstrNORHandle)
+{
+	//fast read streams as long as CS is low, long reads are only split in DMA sized chunks
+	Copy_pstrNORHandle->ChunkLen = (Copy_pstrNORHandle->Len > NOR_DMA_MAX_LEN)? NOR_DMA_MAX_LEN : Copy_pstrNORHandle->Len;
+
+	nor_start_xfer(Copy_pstrNORHandle, NOR_Step_Data, NULL, Copy_pstrNORHandle->pData, Copy_pstrNORHandle->ChunkLen);
+}
+
+/*
+ * Program and erase start with WREN, the command phase follows from nor_spi_done
+ */
+static void nor_start_write_enable(NOR_Handle_t *Copy_pstrNORHandle)
+{
+	Copy_pstrNORHandle->Cmd[0] = NOR_CMD_WRITE_ENABLE;
+
+	nor_start_xfer(Copy_pstrNORHandle, NOR_Step_WriteEnable, Copy_pstrNORHandle->Cmd, NULL, 1);
+}
+
+static void nor_start_page(NOR_Handle_t *Copy_pstrNORHandle)
+{
+	u32 Local_u32PageLeft = NOR_PAGE_SIZE - (Copy_pstrNORHandle->Addr % NOR_PAGE_SIZE);
+
+	Copy_pstrNORHandle->ChunkLen = (Copy_pstrNORHandle->Len > Local_u32PageLeft)? Local_u32PageLeft : Copy_pstrNORHandle->Len;
+
+	nor_start_write_enable(Copy_pstrNORHandle);
+}
+
+static void nor_start_poll(NOR_Handle_t *Copy_pstrNORHandle)
+{
+	Copy_pstrNORHandle->Cmd[0] = NOR_CMD_READ_STATUS;
+	Copy_pstrNORHandle->Cmd[1] = 0xFF;
+
+	nor_start_xfer(Copy_pstrNORHandle, NOR_Step_Poll, Copy_pstrNORHandle->Cmd, Copy_pstrNORHandle->Status, 2);
+}
+
+static void nor_finish(NOR_Handle_t *Copy_pstrNORHandle, ES_t Copy_enuResult)
+{
+	Copy_pstrNORHandle->Step = NOR_Step_None;
+	Copy_pstrNORHandle->Result = Copy_enuResult;
+	Copy_pstrNORHandle->State = NOR_Idle;
+	nor_active = NULL;
+
+	if(Copy_pstrNORHandle->CallBackFunc != NULL)
+	{
+		Copy_pstrNORHandle->CallBackFunc(Copy_enuResult);
+	}
+}
+
+/*
+ * SPI DMA completion, drives read / program / erase state machines
+ */
+static void nor_spi_done(void)
+{
+	NOR_Handle_t *Local_pstrNORHandle = nor_active;
+
+	if(Local_pstrNORHandle == NULL)
+		return;
+
+	switch(Local_pstrNORHandle->Step)
+	{
+	case NOR_Step_WriteEnable:
+		//CS rising edge latches WEL
+		nor_deselect(Local_pstrNORHandle);
+
+		nor_set_cmd(Local_pstrNORHandle,
+				(Local_pstrNORHandle->State == NOR_BUSY_InProgram)? NOR_CMD_PAGE_PROGRAM : NOR_CMD_SECTOR_ERASE,
+				Local_pstrNORHandle->Addr);
+		nor_start_xfer(Local_pstrNORHandle, NOR_Step_Cmd, Local_pstrNORHandle->Cmd, NULL, 4);
+		break;
+
+	case NOR_Step_Cmd:
+		if(Local_pstrNORHandle->State == NOR_BUSY_InProgram)
+		{
+			//page data follows the address with CS kept low
+			nor_start_xfer(Local_pstrNORHandle, NOR_Step_Data, Local_pstrNORHandle->pData, NULL,
+					Local_pstrNORHandle->ChunkLen);
+		}
+		else
+		{
+			//CS rising edge starts the internal erase
+			nor_deselect(Local_pstrNORHandle);
+			Local_pstrNORHandle->PollTicks = 0;
+			Local_pstrNORHandle->Step = NOR_Step_Wait;
+		}
+		break;
+
+	case NOR_Step_Data:
+		Local_pstrNORHandle->pData += Local_pstrNORHandle->ChunkLen;
+		Local_pstrNORHandle->Addr += Local_pstrNORHandle->ChunkLen;
+		Local_pstrNORHandle->Len -= Local_pstrNORHandle->ChunkLen;
+
+		if(Local_pstrNORHandle->State == NOR_BUSY_InRead)
+		{
+			if(Local_pstrNORHandle->Len > 0)
+			{
+				nor_start_read_chunk(Local_pstrNORHandle);
+			}
+			else
+			{
+				nor_deselect(Local_pstrNORHandle);
+				nor_finish(Local_pstrNORHandle, ES_OK);
+			}
+		}
+		else
+		{
+			//CS rising edge starts the internal page program
+			nor_deselect(Local_pstrNORHandle);
+			Local_pstrNORHandle->PollTicks = 0;
+			Local_pstrNORHandle->Step = NOR_Step_Wait;
+		}
+		break;
+
+	case NOR_Step_Poll:
+		nor_deselect(Local_pstrNORHandle);
+
+		if(GET_BIT(Local_pstrNORHandle->Status[1], NOR_STATUS_WIP))
+		{
+			//a device that never gets ready or MISO stuck high
+			if(Local_pstrNORHandle->PollTicks >= ((Local_pstrNORHandle->State == NOR_BUSY_InErase)?
+					NOR_ERASE_TIMEOUT_TICKS : NOR_PROGRAM_TIMEOUT_TICKS))
+			{
+				nor_finish(Local_pstrNORHandle, ES_TIME_OUT);
+			}
+			else
+			{
+				//still busy, NOR_enuTick reads the status again
+				Local_pstrNORHandle->Step = NOR_Step_Wait;
+			}
+		}
+		else if(Local_pstrNORHandle->State == NOR_BUSY_InProgram && Local_pstrNORHandle->Len > 0)
+		{
+			nor_start_page(Local_pstrNORHandle);
+		}
+		else
+		{
+			nor_finish(Local_pstrNORHandle, ES_OK);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+static void nor_cache_invalidate_range(NOR_Handle_t *Copy_pstrNORHandle, u32 Copy_u32Addr, u32 Copy_u32Len)
+{
+	for(u8 Local_u8Index = 0 ; Local_u8Index < NOR_CACHE_BLOCKS ; Local_u8Index++)
+	{
+		u32 Local_u32Tag = Copy_pstrNORHandle->Cache[Local_u8Index].Tag;
+
+		if(Local_u32Tag != NOR_CACHE_INVALID &&
+				Local_u32Tag < Copy_u32Addr + Copy_u32Len && Copy_u32Addr < Local_u32Tag + NOR_CACHE_BLOCK_SIZE)
+		{
+			Copy_pstrNORHandle->Cache[Local_u8Index].Tag = NOR_CACHE_INVALID;
+		}
+	}
+}
+
+/*
+ * Blocking read, by DMA when the SPI handle has DMA streams otherwise by the polling burst path
+ */
+static ES_t nor_read_direct(NOR_Handle_t *Copy_pstrNORHandle, u32 Copy_u32Addr, u8 *Copy_pu8Data, u32 Copy_u32Len)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrNORHandle->pSPIHandle->pTxDMAHandle != NULL && Copy_pstrNORHandle->pSPIHandle->pRxDMAHandle != NULL)
+	{
+		Local_enuErrorState = NOR_enuReadDMA(Copy_pstrNORHandle, Copy_u32Addr, Copy_pu8Data, Copy_u32Len, NULL);
+
+		if(Local_enuErrorState == ES_OK)
+		{
+			while(Copy_pstrNORHandle->State != NOR_Idle);
+
+			Local_enuErrorState = Copy_pstrNORHandle->Result;
+		}
+	}
+	else
+	{
+		nor_select(Copy_pstrNORHandle);
+		nor_send_cmd(Copy_pstrNORHandle, NOR_CMD_FAST_READ, Copy_u32Addr, 5);
+		Local_enuErrorState = SPI_enuTransceiveBurst(Copy_pstrNORHandle->pSPIHandle, NULL, Copy_pu8Data, Copy_u32Len);
+		nor_deselect(Copy_pstrNORHandle);
+	}
+
+	return Local_enuErrorState;
+}
+
+static ES_t nor_start_async(NOR_Handle_t *Copy_pstrNORHandle, NOR_State_t Copy_enuState, u32 Copy_u32Addr, u8 *Copy_pu8Data,
+		u32 Copy_u32Len, void (*CallBack)(ES_t Result))
+{
+	if(Copy_pstrNORHandle->pSPIHandle->pTxDMAHandle == NULL || Copy_pstrNORHandle->pSPIHandle->pRxDMAHandle == NULL)
+		return ES_NULL_PTR;
+
+	if(nor_active != NULL || Copy_pstrNORHandle->State != NOR_Idle)
+		return ES_FUNC_IS_BUSY;
+
+	nor_active = Copy_pstrNORHandle;
+
+	Copy_pstrNORHandle->State = Copy_enuState;
+	Copy_pstrNORHandle->Addr = Copy_u32Addr;
+	Copy_pstrNORHandle->pData = Copy_pu8Data;
+	Copy_pstrNORHandle->Len = Copy_u32Len;
+	Copy_pstrNORHandle->CallBackFunc = CallBack;
+
+	return ES_OK;
+}
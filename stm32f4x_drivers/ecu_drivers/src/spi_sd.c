@@ -0,0 +1,684 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : spi_sd.c
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+
+#include "stm32f4xxx_gpio_exti.h"
+#include "stm32f4xxx_dma.h"
+#include "stm32f4xxx_spi.h"
+#include "spi_sd.h"
+
+/*
+ * Commands
+ */
+#define SD_CMD0_GO_IDLE               0
+#define SD_CMD8_SEND_IF_COND          8
+#define SD_CMD9_SEND_CSD              9
+#define SD_CMD12_STOP                 12
+#define SD_CMD16_SET_BLOCKLEN         16
+#define SD_CMD18_READ_MULTIPLE        18
+#define SD_CMD25_WRITE_MULTIPLE       25
+#define SD_CMD55_APP_CMD              55
+#define SD_CMD58_READ_OCR             58
+#define SD_ACMD41_SEND_OP_COND        41
+
+/*
+ * R1 response
+ */
+#define SD_R1_READY                   0x00
+#define SD_R1_IDLE                    0x01
+#define SD_R1_ILLEGAL_CMD             0x04
+
+/*
+ * Tokens
+ */
+#define SD_TOKEN_START_BLOCK          0xFE
+#define SD_TOKEN_START_MULTI_WRITE    0xFC
+#define SD_TOKEN_STOP_TRAN            0xFD
+#define SD_DATA_RESP_MASK             0x1F
+#define SD_DATA_RESP_ACCEPTED         0x05
+
+#define SD_OCR_CCS                    6
+
+#define SD_INIT_RETRIES               2000
+#define SD_READY_POLL_MAX             50000
+#define SD_R1_POLL_MAX                10
+
+
+static void sd_select(SD_Handle_t *pSDHandle);
+static void sd_deselect(SD_Handle_t *pSDHandle);
+static u8   sd_xfer_byte(SD_Handle_t *pSDHandle, u8 Data);
+static u8   sd_wait_ready(SD_Handle_t *pSDHandle);
+static void sd_set_cmd_frame(u8 *pFrame, u8 Cmd, u32 Arg);
+static u8   sd_send_cmd(SD_Handle_t *pSDHandle, u8 Cmd, u32 Arg);
+static ES_t sd_read_csd(SD_Handle_t *pSDHandle);
+static void sd_start_poll(SD_Handle_t *pSDHandle, SD_Step_t Step, u8 *pTxData, u8 Skip);
+static void sd_start_wait(SD_Handle_t *pSDHandle, SD_Step_t Step, u8 *pTxData, u8 Skip);
+static void sd_start_data(SD_Handle_t *pSDHandle, u32 Offset);
+static void sd_next_block(SD_Handle_t *pSDHandle);
+static void sd_stop(SD_Handle_t *pSDHandle, ES_t Result);
+static void sd_finish(SD_Handle_t *pSDHandle, ES_t Result);
+static void sd_spi_done(void);
+static ES_t sd_start_async(SD_Handle_t *pSDHandle, SD_State_t State, u32 Block, u8 *pData, u32 Count,
+		void (*CallBack)(ES_t Result));
+
+//SPI callbacks carry no context, one card per application
+static SD_Handle_t *sd_active = NULL;
+
+
+ES_t SD_enuInit(SD_Handle_t *Copy_pstrSDHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	u8 Local_u8R1;
+	u8 Local_au8Resp[4];
+	u32 Local_u32Retry;
+
+	if(Copy_pstrSDHandle==NULL || Copy_pstrSDHandle->pSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	Copy_pstrSDHandle->CardType = SD_CardType_Unknown;
+	Copy_pstrSDHandle->BlockCount = 0;
+	Copy_pstrSDHandle->State = SD_Idle;
+	Copy_pstrSDHandle->Step = SD_Step_None;
+
+	SPI_enuSetClkSpeed(Copy_pstrSDHandle->pSPIHandle, Copy_pstrSDHandle->InitClkSpeed);
+
+	//1. at least 74 clocks with CS high to enter native mode
+	GPIO_enuWriteToOutputPin(Copy_pstrSDHandle->CSPort, Copy_pstrSDHandle->CSPin, GPIO_HIGH);
+	for(u8 Local_u8Index = 0 ; Local_u8Index < 10 ; Local_u8Index++)
+	{
+		sd_xfer_byte(Copy_pstrSDHandle, 0xFF);
+	}
+
+	//2. CMD0 with CS low switches the card to SPI mode
+	for(Local_u32Retry = 0 ; Local_u32Retry < 10 ; Local_u32Retry++)
+	{
+		sd_select(Copy_pstrSDHandle);
+		Local_u8R1 = sd_send_cmd(Copy_pstrSDHandle, SD_CMD0_GO_IDLE, 0);
+		sd_deselect(Copy_pstrSDHandle);
+
+		if(Local_u8R1 == SD_R1_IDLE)
+			break;
+	}
+
+	if(Local_u8R1 != SD_R1_IDLE)
+		return ES_NOT_OK;
+
+	//3. CMD8 tells v2 cards from v1 ones
+	sd_select(Copy_pstrSDHandle);
+	Local_u8R1 = sd_send_cmd(Copy_pstrSDHandle, SD_CMD8_SEND_IF_COND, 0x1AA);
+
+	if(Local_u8R1 == SD_R1_IDLE)
+	{
+		for(u8 Local_u8Index = 0 ; Local_u8Index < 4 ; Local_u8Index++)
+		{
+			Local_au8Resp[Local_u8Index] = sd_xfer_byte(Copy_pstrSDHandle, 0xFF);
+		}
+		sd_deselect(Copy_pstrSDHandle);
+
+		if((Local_au8Resp[2] & 0x0F) != 0x01 || Local_au8Resp[3] != 0xAA)
+			return ES_NOT_OK;
+
+		Copy_pstrSDHandle->CardType = SD_CardType_SDv2;
+	}
+	else if(Local_u8R1 & SD_R1_ILLEGAL_CMD)
+	{
+		sd_deselect(Copy_pstrSDHandle);
+		Copy_pstrSDHandle->CardType = SD_CardType_SDv1;
+	}
+	else
+	{
+		sd_deselect(Copy_pstrSDHandle);
+		return ES_NOT_OK;
+	}
+
+	//4. ACMD41 until the card leaves idle state, HCS is set for v2 cards
+	for(Local_u32Retry = 0 ; Local_u32Retry < SD_INIT_RETRIES ; Local_u32Retry++)
+	{
+		sd_select(Copy_pstrSDHandle);
+		sd_send_cmd(Copy_pstrSDHandle, SD_CMD55_APP_CMD, 0);
+		Local_u8R1 = sd_send_cmd(Copy_pstrSDHandle, SD_ACMD41_SEND_OP_COND,
+				(Copy_pstrSDHandle->CardType == SD_CardType_SDv2)? 0x40000000 : 0);
+		sd_deselect(Copy_pstrSDHandle);
+
+		if(Local_u8R1 == SD_R1_READY)
+			break;
+	}
+
+	if(Local_u8R1 != SD_R1_READY)
+		return ES_NOT_OK;
+
+	//5. CCS tells block addressing (SDHC / SDXC) from byte addressing
+	if(Copy_pstrSDHandle->CardType == SD_CardType_SDv2)
+	{
+		sd_select(Copy_pstrSDHandle);
+		Local_u8R1 = sd_send_cmd(Copy_pstrSDHandle, SD_CMD58_READ_OCR, 0);
+
+		for(u8 Local_u8Index = 0 ; Local_u8Index < 4 ; Local_u8Index++)
+		{
+			Local_au8Resp[Local_u8Index] = sd_xfer_byte(Copy_pstrSDHandle, 0xFF);
+		}
+		sd_deselect(Copy_pstrSDHandle);
+
+		if(Local_u8R1 != SD_R1_READY)
+			return ES_NOT_OK;
+
+		if(GET_BIT(Local_au8Resp[0], SD_OCR_CCS))
+		{
+			Copy_pstrSDHandle->CardType = SD_CardType_SDHC;
+		}
+	}
+
+	if(Copy_pstrSDHandle->CardType != SD_CardType_SDHC)
+	{
+		sd_select(Copy_pstrSDHandle);
+		Local_u8R1 = sd_send_cmd(Copy_pstrSDHandle, SD_CMD16_SET_BLOCKLEN, SD_BLOCK_SIZE);
+		sd_deselect(Copy_pstrSDHandle);
+
+		if(Local_u8R1 != SD_R1_READY)
+			return ES_NOT_OK;
+	}
+
+	Local_enuErrorState = sd_read_csd(Copy_pstrSDHandle);
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		//6. identification done, data transfer may run at full speed
+		Local_enuErrorState = SPI_enuSetClkSpeed(Copy_pstrSDHandle->pSPIHandle, Copy_pstrSDHandle->FastClkSpeed);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t SD_enuReadBlocks(SD_Handle_t *Copy_pstrSDHandle, u32 Copy_u32Block, u8 *Copy_pu8Data, u32 Copy_u32Count,
+		void (*CallBack)(ES_t Result))
+{
+	ES_t Local_enuErrorState = sd_start_async(Copy_pstrSDHandle, SD_BUSY_InRead, Copy_u32Block, Copy_pu8Data,
+			Copy_u32Count, CallBack);
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		u32 Local_u32Arg = (Copy_pstrSDHandle->CardType == SD_CardType_SDHC)? Copy_u32Block : Copy_u32Block * SD_BLOCK_SIZE;
+
+		sd_select(Copy_pstrSDHandle);
+
+		if(sd_send_cmd(Copy_pstrSDHandle, SD_CMD18_READ_MULTIPLE, Local_u32Arg) != SD_R1_READY)
+		{
+			sd_deselect(Copy_pstrSDHandle);
+			sd_finish(Copy_pstrSDHandle, ES_NOT_OK);
+			return ES_NOT_OK;
+		}
+
+		sd_start_wait(Copy_pstrSDHandle, SD_Step_Token, NULL, 0);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t SD_enuWriteBlocks(SD_Handle_t *Copy_pstrSDHandle, u32 Copy_u32Block, u8 *Copy_pu8Data, u32 Copy_u32Count,
+		void (*CallBack)(ES_t Result))
+{
+	ES_t Local_enuErrorState = sd_start_async(Copy_pstrSDHandle, SD_BUSY_InWrite, Copy_u32Block, Copy_pu8Data,
+			Copy_u32Count, CallBack);
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		u32 Local_u32Arg = (Copy_pstrSDHandle->CardType == SD_CardType_SDHC)? Copy_u32Block : Copy_u32Block * SD_BLOCK_SIZE;
+
+		sd_select(Copy_pstrSDHandle);
+
+		if(sd_send_cmd(Copy_pstrSDHandle, SD_CMD25_WRITE_MULTIPLE, Local_u32Arg) != SD_R1_READY)
+		{
+			sd_deselect(Copy_pstrSDHandle);
+			sd_finish(Copy_pstrSDHandle, ES_NOT_OK);
+			return ES_NOT_OK;
+		}
+
+		//one byte gap before the first data token
+		sd_xfer_byte(Copy_pstrSDHandle, 0xFF);
+		sd_start_data(Copy_pstrSDHandle, 0);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t SD_enuTick(SD_Handle_t *Copy_pstrSDHandle)
+{
+	if(Copy_pstrSDHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSDHandle->State != SD_Idle)
+	{
+		Copy_pstrSDHandle->PollTicks++;
+
+		//busy waits poll one burst per tick
+		if(Copy_pstrSDHandle->PollPending)
+		{
+			Copy_pstrSDHandle->PollPending = 0;
+			sd_start_poll(Copy_pstrSDHandle, Copy_pstrSDHandle->Step, NULL, 0);
+		}
+	}
+
+	return ES_OK;
+}
+
+
+ES_t SD_enuGetState(SD_Handle_t *Copy_pstrSDHandle, SD_State_t *Copy_penuState)
+{
+	if(Copy_pstrSDHandle==NULL || Copy_penuState==NULL)
+		return ES_NULL_PTR;
+
+	*Copy_penuState = Copy_pstrSDHandle->State;
+
+	return ES_OK;
+}
+
+
+ES_t SD_enuGetBlockCount(SD_Handle_t *Copy_pstrSDHandle, u32 *Copy_pu32BlockCount)
+{
+	if(Copy_pstrSDHandle==NULL || Copy_pu32BlockCount==NULL)
+		return ES_NULL_PTR;
+
+	*Copy_pu32BlockCount = Copy_pstrSDHandle->BlockCount;
+
+	return ES_OK;
+}
+
+
+//some helper function implementations
+
+static void sd_select(SD_Handle_t *Copy_pstrSDHandle)
+{
+	GPIO_enuWriteToOutputPin(Copy_pstrSDHandle->CSPort, Copy_pstrSDHandle->CSPin, GPIO_LOW);
+}
+
+/*
+ * The card only releases MISO on the clock edge that follows CS going high
+ */
+static void sd_deselect(SD_Handle_t *Copy_pstrSDHandle)
+{
+	GPIO_enuWriteToOutputPin(Copy_pstrSDHandle->CSPort, Copy_pstrSDHandle->CSPin, GPIO_HIGH);
+	sd_xfer_byte(Copy_pstrSDHandle, 0xFF);
+}
+
+static u8 sd_xfer_byte(SD_Handle_t *Copy_pstrSDHandle, u8 Copy_u8Data)
+{
+	SPI_enuTransceiveBurst(Copy_pstrSDHandle->pSPIHandle, &Copy_u8Data, &Copy_u8Data, 1);
+
+	return Copy_u8Data;
+}
+
+static u8 sd_wait_ready(SD_Handle_t *Copy_pstrSDHandle)
+{
+	for(u32 Local_u32Count = 0 ; Local_u32Count < SD_READY_POLL_MAX ; Local_u32Count++)
+	{
+		if(sd_xfer_byte(Copy_pstrSDHandle, 0xFF) == 0xFF)
+			return 1;
+	}
+
+	return 0;
+}
+
+static void sd_set_cmd_frame(u8 *Copy_pu8Frame, u8 Copy_u8Cmd, u32 Copy_u32Arg)
+{
+	Copy_pu8Frame[0] = 0x40 | Copy_u8Cmd;
+	Copy_pu8Frame[1] = (u8)(Copy_u32Arg >> 24);
+	Copy_pu8Frame[2] = (u8)(Copy_u32Arg >> 16);
+	Copy_pu8Frame[3] = (u8)(Copy_u32Arg >> 8);
+	Copy_pu8Frame[4] = (u8)Copy_u32Arg;
+
+	//CRC is only checked for CMD0 and CMD8 in SPI mode
+	if(Copy_u8Cmd == SD_CMD0_GO_IDLE)
+		Copy_pu8Frame[5] = 0x95;
+	else if(Copy_u8Cmd == SD_CMD8_SEND_IF_COND)
+		Copy_pu8Frame[5] = 0x87;
+	else
+		Copy_pu8Frame[5] = 0x01;
+}
+
+/*
+ * Sends a command frame and returns R1 (0xFF on timeout), CS must already be low
+ */
+static u8 sd_send_cmd(SD_Handle_t *Copy_pstrSDHandle, u8 Copy_u8Cmd, u32 Copy_u32Arg)
+{
+	u8 Local_au8Frame[6];
+	u8 Local_u8R1 = 0xFF;
+
+	if(!sd_wait_ready(Copy_pstrSDHandle))
+		return 0xFF;
+
+	sd_set_cmd_frame(Local_au8Frame, Copy_u8Cmd, Copy_u32Arg);
+
+	SPI_enuTransceiveBurst(Copy_pstrSDHandle->pSPIHandle, Local_au8Frame, NULL, 6);
+
+	for(u8 Local_u8Count = 0 ; Local_u8Count < SD_R1_POLL_MAX ; Local_u8Count++)
+	{
+		Local_u8R1 = sd_xfer_byte(Copy_pstrSDHandle, 0xFF);
+
+		if(!GET_BIT(Local_u8R1, 7))
+			break;
+	}
+
+	return Local_u8R1;
+}
+
+static ES_t sd_read_csd(SD_Handle_t *Copy_pstrSDHandle)
+{
+	u8 Local_au8CSD[18];
+	u8 Local_u8Token = 0xFF;
+
+	sd_select(Copy_pstrSDHandle);
+
+	if(sd_send_cmd(Copy_pstrSDHandle, SD_CMD9_SEND_CSD, 0) != SD_R1_READY)
+	{
+		sd_deselect(Copy_pstrSDHandle);
+		return ES_NOT_OK;
+	}
+
+	for(u32 Local_u32Count = 0 ; Local_u32Count < SD_TOKEN_POLL_MAX && Local_u8Token == 0xFF ; Local_u32Count++)
+	{
+		Local_u8Token = sd_xfer_byte(Copy_pstrSDHandle, 0xFF);
+	}
+
+	if(Local_u8Token != SD_TOKEN_START_BLOCK)
+	{
+		sd_deselect(Copy_pstrSDHandle);
+		return ES_NOT_OK;
+	}
+
+	//16 bytes CSD and 2 bytes CRC
+	SPI_enuTransceiveBurst(Copy_pstrSDHandle->pSPIHandle, NULL, Local_au8CSD, 18);
+	sd_deselect(Copy_pstrSDHandle);
+
+	if((Local_au8CSD[0] >> 6) == 1)
+	{
+		//CSD version 2.0: capacity = (C_SIZE + 1) * 512 KB
+		u32 Local_u32CSize = ((u32)(Local_au8CSD[7] & 0x3F) << 16) | ((u32)Local_au8CSD[8] << 8) | Local_au8CSD[9];
+
+		Copy_pstrSDHandle->BlockCount = (Local_u32CSize + 1) << 10;
+	}
+	else
+	{
+		//CSD version 1.0: capacity = (C_SIZE + 1) * 2^(C_SIZE_MULT + 2) * 2^READ_BL_LEN
+		u32 Local_u32CSize = ((u32)(Local_au8CSD[6] & 0x03) << 10) | ((u32)Local_au8CSD[7] << 2) | (Local_au8CSD[8] >> 6);
+		u8 Local_u8CSizeMult = ((Local_au8CSD[9] & 0x03) << 1) | (Local_au8CSD[10] >> 7);
+		u8 Local_u8ReadBlLen = Local_au8CSD[5] & 0x0F;
+
+		Copy_pstrSDHandle->BlockCount = (Local_u32CSize + 1) << (Local_u8CSizeMult + 2 + Local_u8ReadBlLen - 9);
+	}
+
+	return ES_OK;
+}
+
+/*
+ * One burst of SD_POLL_BURST_LEN bytes by DMA into PollBuffer (0xFF sent when Copy_pu8TxData is NULL),
+ * the first Copy_u8Skip bytes are not part of the wait (CRC of the previous block).
+ */
+static void sd_start_poll(SD_Handle_t *Copy_pstrSDHandle, SD_Step_t Copy_enuStep, u8 *Copy_pu8TxData, u8 Copy_u8Skip)
+{
+	Copy_pstrSDHandle->Step = Copy_enuStep;
+	Copy_pstrSDHandle->PollSkip = Copy_u8Skip;
+
+	if(SPI_enuTransceiveDMA(Copy_pstrSDHandle->pSPIHandle, Copy_pu8TxData, Copy_pstrSDHandle->PollBuffer,
+			SD_POLL_BURST_LEN, sd_spi_done) != ES_OK)
+	{
+		sd_deselect(Copy_pstrSDHandle);
+		sd_finish(Copy_pstrSDHandle, ES_NOT_OK);
+	}
+}
+
+/*
+ * First burst of a wait, its timeout is counted in SD_enuTick calls from here
+ */
+static void sd_start_wait(SD_Handle_t *Copy_pstrSDHandle, SD_Step_t Copy_enuStep, u8 *Copy_pu8TxData, u8 Copy_u8Skip)
+{
+	Copy_pstrSDHandle->PollTicks = 0;
+	Copy_pstrSDHandle->PollPending = 0;
+
+	sd_start_poll(Copy_pstrSDHandle, Copy_enuStep, Copy_pu8TxData, Copy_u8Skip);
+}
+
+/*
+ * Block data by DMA, a read may already have Copy_u32Offset bytes of the block from the token burst
+ */
+static void sd_start_data(SD_Handle_t *Copy_pstrSDHandle, u32 Copy_u32Offset)
+{
+	ES_t Local_enuErrorState;
+
+	Copy_pstrSDHandle->Step = SD_Step_Data;
+
+	if(Copy_pstrSDHandle->State == SD_BUSY_InWrite)
+	{
+		sd_xfer_byte(Copy_pstrSDHandle, SD_TOKEN_START_MULTI_WRITE);
+		Local_enuErrorState = SPI_enuTransceiveDMA(Copy_pstrSDHandle->pSPIHandle, Copy_pstrSDHandle->pData, NULL,
+				SD_BLOCK_SIZE, sd_spi_done);
+	}
+	else
+	{
+		Local_enuErrorState = SPI_enuTransceiveDMA(Copy_pstrSDHandle->pSPIHandle, NULL,
+				Copy_pstrSDHandle->pData + Copy_u32Offset, SD_BLOCK_SIZE - Copy_u32Offset, sd_spi_done);
+	}
+
+	if(Local_enuErrorState != ES_OK)
+	{
+		sd_deselect(Copy_pstrSDHandle);
+		sd_finish(Copy_pstrSDHandle, ES_NOT_OK);
+	}
+}
+
+static void sd_next_block(SD_Handle_t *Copy_pstrSDHandle)
+{
+	if(Copy_pstrSDHandle->BlocksLeft > 0)
+	{
+		sd_start_data(Copy_pstrSDHandle, 0);
+	}
+	else
+	{
+		sd_stop(Copy_pstrSDHandle, ES_OK);
+	}
+}
+
+/*
+ * Ends a multi-block transfer: CMD12 (with its stuff byte and R1) or the stop token is sent
+ * by DMA in a burst that also covers the start of busy, then busy is polled from SD_enuTick.
+ */
+static void sd_stop(SD_Handle_t *Copy_pstrSDHandle, ES_t Copy_enuResult)
+{
+	Copy_pstrSDHandle->Result = Copy_enuResult;
+
+	for(u8 Local_u8Index = 0 ; Local_u8Index < SD_POLL_BURST_LEN ; Local_u8Index++)
+	{
+		Copy_pstrSDHandle->StopFrame[Local_u8Index] = 0xFF;
+	}
+
+	if(Copy_pstrSDHandle->State == SD_BUSY_InRead)
+	{
+		//CMD12 is sent while the card is still streaming data
+		sd_set_cmd_frame(Copy_pstrSDHandle->StopFrame, SD_CMD12_STOP, 0);
+	}
+	else
+	{
+		Copy_pstrSDHandle->StopFrame[0] = SD_TOKEN_STOP_TRAN;
+	}
+
+	sd_start_wait(Copy_pstrSDHandle, SD_Step_Stop, Copy_pstrSDHandle->StopFrame, 0);
+}
+
+static void sd_finish(SD_Handle_t *Copy_pstrSDHandle, ES_t Copy_enuResult)
+{
+	Copy_pstrSDHandle->Step = SD_Step_None;
+	Copy_pstrSDHandle->PollPending = 0;
+	Copy_pstrSDHandle->Result = Copy_enuResult;
+	Copy_pstrSDHandle->State = SD_Idle;
+	sd_active = NULL;
+
+	if(Copy_pstrSDHandle->CallBackFunc != NULL)
+	{
+		Copy_pstrSDHandle->CallBackFunc(Copy_enuResult);
+	}
+}
+
+/*
+ * SPI DMA completion, drives the CMD18 / CMD25 state machines
+ */
+static void sd_spi_done(void)
+{
+	SD_Handle_t *Local_pstrSDHandle = sd_active;
+	u8 *Local_pu8Poll;
+	u8 Local_u8Ready;
+
+	if(Local_pstrSDHandle == NULL)
+		return;
+
+	Local_pu8Poll = Local_pstrSDHandle->PollBuffer;
+
+	//the card releases busy by driving MISO high, so the last byte of a burst tells if it is done
+	Local_u8Ready = (Local_pu8Poll[SD_POLL_BURST_LEN - 1] == 0xFF);
+
+	switch(Local_pstrSDHandle->Step)
+	{
+	case SD_Step_Token:
+	{
+		u8 Local_u8Index = Local_pstrSDHandle->PollSkip;
+
+		while(Local_u8Index < SD_POLL_BURST_LEN && Local_pu8Poll[Local_u8Index] == 0xFF)
+		{
+			Local_u8Index++;
+		}
+
+		if(Local_u8Index == SD_POLL_BURST_LEN)
+		{
+			//read access time is short, bursts follow each other until the token or the timeout
+			if(Local_pstrSDHandle->PollTicks >= SD_TOKEN_TIMEOUT_TICKS)
+				sd_stop(Local_pstrSDHandle, ES_TIME_OUT);
+			else
+				sd_start_poll(Local_pstrSDHandle, SD_Step_Token, NULL, 0);
+		}
+		else if(Local_pu8Poll[Local_u8Index] == SD_TOKEN_START_BLOCK)
+		{
+			//bytes clocked after the token are the start of the block
+			u32 Local_u32Offset = SD_POLL_BURST_LEN - 1 - Local_u8Index;
+
+			for(u32 Local_u32Count = 0 ; Local_u32Count < Local_u32Offset ; Local_u32Count++)
+			{
+				Local_pstrSDHandle->pData[Local_u32Count] = Local_pu8Poll[Local_u8Index + 1 + Local_u32Count];
+			}
+
+			sd_start_data(Local_pstrSDHandle, Local_u32Offset);
+		}
+		else
+		{
+			//data error token
+			sd_stop(Local_pstrSDHandle, ES_NOT_OK);
+		}
+		break;
+	}
+
+	case SD_Step_Data:
+		Local_pstrSDHandle->pData += SD_BLOCK_SIZE;
+		Local_pstrSDHandle->BlocksLeft--;
+
+		if(Local_pstrSDHandle->State == SD_BUSY_InRead)
+		{
+			//CRC is not checked, its 2 bytes open the next token burst
+			if(Local_pstrSDHandle->BlocksLeft > 0)
+				sd_start_wait(Local_pstrSDHandle, SD_Step_Token, NULL, 2);
+			else
+				sd_stop(Local_pstrSDHandle, ES_OK);
+		}
+		else
+		{
+			//CRC, data response then the start of busy in one burst
+			sd_start_wait(Local_pstrSDHandle, SD_Step_Resp, NULL, 0);
+		}
+		break;
+
+	case SD_Step_Resp:
+		if((Local_pu8Poll[2] & SD_DATA_RESP_MASK) != SD_DATA_RESP_ACCEPTED)
+		{
+			sd_stop(Local_pstrSDHandle, ES_NOT_OK);
+		}
+		else if(Local_u8Ready)
+		{
+			sd_next_block(Local_pstrSDHandle);
+		}
+		else
+		{
+			Local_pstrSDHandle->Step = SD_Step_Busy;
+			Local_pstrSDHandle->PollPending = 1;
+		}
+		break;
+
+	case SD_Step_Busy:
+		if(Local_u8Ready)
+		{
+			sd_next_block(Local_pstrSDHandle);
+		}
+		else if(Local_pstrSDHandle->PollTicks >= SD_BUSY_TIMEOUT_TICKS)
+		{
+			sd_stop(Local_pstrSDHandle, ES_TIME_OUT);
+		}
+		else
+		{
+			Local_pstrSDHandle->PollPending = 1;
+		}
+		break;
+
+	case SD_Step_Stop:
+		if(Local_u8Ready || Local_pstrSDHandle->PollTicks >= SD_BUSY_TIMEOUT_TICKS)
+		{
+			sd_deselect(Local_pstrSDHandle);
+			sd_finish(Local_pstrSDHandle, Local_u8Ready? Local_pstrSDHandle->Result : ES_TIME_OUT);
+		}
+		else
+		{
+			Local_pstrSDHandle->PollPending = 1;
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+static ES_t sd_start_async(SD_Handle_t *Copy_pstrSDHandle, SD_State_t Copy_enuState, u32 Copy_u32Block, u8 *Copy_pu8Data,
+		u32 Copy_u32Count, void (*CallBack)(ES_t Result))
+{
+	if(Copy_pstrSDHandle==NULL || Copy_pu8Data==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSDHandle->pSPIHandle->pTxDMAHandle == NULL || Copy_pstrSDHandle->pSPIHandle->pRxDMAHandle == NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSDHandle->CardType == SD_CardType_Unknown || Copy_u32Count == 0 ||
+			Copy_u32Block >= Copy_pstrSDHandle->BlockCount || Copy_u32Count > Copy_pstrSDHandle->BlockCount - Copy_u32Block)
+		return ES_NOT_OK;
+
+	if(sd_active != NULL || Copy_pstrSDHandle->State != SD_Idle)
+		return ES_FUNC_IS_BUSY;
+
+	sd_active = Copy_pstrSDHandle;
+
+	Copy_pstrSDHandle->State = Copy_enuState;
+	Copy_pstrSDHandle->pData = Copy_pu8Data;
+	Copy_pstrSDHandle->BlocksLeft = Copy_u32Count;
+	Copy_pstrSDHandle->Result = ES_OK;
+	Copy_pstrSDHandle->CallBackFunc = CallBack;
+
+	return ES_OK;
+}
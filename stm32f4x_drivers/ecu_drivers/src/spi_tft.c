@@ -0,0 +1,332 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : spi_tft.c
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU
+ * @brief          : External devices connected to the MCU,
+ *                   this layer uses only the ECU / Board layer drivers
+ *                   and is not aware of any register.
+ ******************************************************************************
+ ******************************************************************************
+ */
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+
+#include "stm32f4xxx_gpio_exti.h"
+#include "stm32f4xxx_dma.h"
+#include "stm32f4xxx_spi.h"
+#include "spi_tft.h"
+
+/*
+ * Commands
+ */
+#define TFT_CMD_COLUMN_ADDR_SET       0x2A
+#define TFT_CMD_PAGE_ADDR_SET         0x2B
+#define TFT_CMD_MEMORY_WRITE          0x2C
+
+#define TFT_QUEUE_MASK                (TFT_FLUSH_QUEUE_LEN - 1)
+
+
+static void tft_write_cmd(TFT_Handle_t *pTFTHandle, u8 Cmd, u16 Start, u16 End, u8 ParamLen);
+static void tft_start_next(TFT_Handle_t *pTFTHandle);
+static void tft_spi_done(void);
+static u8   tft_touch(TFT_Window_t *pA, TFT_Window_t *pB);
+static void tft_merge(TFT_Window_t *pDest, TFT_Window_t *pSrc);
+static u32  tft_area(TFT_Window_t *pWindow);
+
+//SPI callbacks carry no context, one panel per application
+static TFT_Handle_t *tft_active = NULL;
+
+
+ES_t TFT_enuInit(TFT_Handle_t *Copy_pstrTFTHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrTFTHandle==NULL || Copy_pstrTFTHandle->pSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrTFTHandle->Width == 0 || Copy_pstrTFTHandle->Height == 0)
+		return ES_NOT_OK;
+
+	GPIO_enuWriteToOutputPin(Copy_pstrTFTHandle->CSPort, Copy_pstrTFTHandle->CSPin, GPIO_HIGH);
+	GPIO_enuWriteToOutputPin(Copy_pstrTFTHandle->DCPort, Copy_pstrTFTHandle->DCPin, GPIO_HIGH);
+
+	Copy_pstrTFTHandle->DirtyCount = 0;
+	Copy_pstrTFTHandle->QueueHead = 0;
+	Copy_pstrTFTHandle->QueueTail = 0;
+	Copy_pstrTFTHandle->Busy = 0;
+
+	tft_active = Copy_pstrTFTHandle;
+
+	Local_enuErrorState = SPI_enuSetDataFrameFormat(Copy_pstrTFTHandle->pSPIHandle, SPI_DFF_8Bits);
+
+	return Local_enuErrorState;
+}
+
+
+ES_t TFT_enuMarkDirty(TFT_Handle_t *Copy_pstrTFTHandle, TFT_Window_t *Copy_pstrWindow)
+{
+	TFT_Window_t Local_strWindow;
+
+	if(Copy_pstrTFTHandle==NULL || Copy_pstrWindow==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrWindow->X >= Copy_pstrTFTHandle->Width || Copy_pstrWindow->Y >= Copy_pstrTFTHandle->Height ||
+			Copy_pstrWindow->Width == 0 || Copy_pstrWindow->Height == 0)
+		return ES_NOT_OK;
+
+	//clip to the panel
+	Local_strWindow = *Copy_pstrWindow;
+
+	if(Local_strWindow.Width > Copy_pstrTFTHandle->Width - Local_strWindow.X)
+		Local_strWindow.Width = Copy_pstrTFTHandle->Width - Local_strWindow.X;
+
+	if(Local_strWindow.Height > Copy_pstrTFTHandle->Height - Local_strWindow.Y)
+		Local_strWindow.Height = Copy_pstrTFTHandle->Height - Local_strWindow.Y;
+
+	//merge with every area it touches, a merge may make it touch others
+	u8 Local_u8Index = 0;
+
+	while(Local_u8Index < Copy_pstrTFTHandle->DirtyCount)
+	{
+		if(tft_touch(&Copy_pstrTFTHandle->Dirty[Local_u8Index], &Local_strWindow))
+		{
+			tft_merge(&Local_strWindow, &Copy_pstrTFTHandle->Dirty[Local_u8Index]);
+
+			Copy_pstrTFTHandle->DirtyCount--;
+			Copy_pstrTFTHandle->Dirty[Local_u8Index] = Copy_pstrTFTHandle->Dirty[Copy_pstrTFTHandle->DirtyCount];
+			Local_u8Index = 0;
+		}
+		else
+		{
+			Local_u8Index++;
+		}
+	}
+
+	if(Copy_pstrTFTHandle->DirtyCount == TFT_MAX_DIRTY_RECTS)
+	{
+		//no room left, merge into the area that grows the least
+		u8 Local_u8Best = 0;
+		u32 Local_u32BestGrowth = 0xFFFFFFFF;
+
+		for(Local_u8Index = 0 ; Local_u8Index < TFT_MAX_DIRTY_RECTS ; Local_u8Index++)
+		{
+			TFT_Window_t Local_strUnion = Copy_pstrTFTHandle->Dirty[Local_u8Index];
+
+			tft_merge(&Local_strUnion, &Local_strWindow);
+
+			u32 Local_u32Growth = tft_area(&Local_strUnion) - tft_area(&Copy_pstrTFTHandle->Dirty[Local_u8Index]);
+
+			if(Local_u32Growth < Local_u32BestGrowth)
+			{
+				Local_u32BestGrowth = Local_u32Growth;
+				Local_u8Best = Local_u8Index;
+			}
+		}
+
+		tft_merge(&Copy_pstrTFTHandle->Dirty[Local_u8Best], &Local_strWindow);
+	}
+	else
+	{
+		Copy_pstrTFTHandle->Dirty[Copy_pstrTFTHandle->DirtyCount++] = Local_strWindow;
+	}
+
+	return ES_OK;
+}
+
+
+ES_t TFT_enuGetNextDirtyTile(TFT_Handle_t *Copy_pstrTFTHandle, u32 Copy_u32MaxPixels, TFT_Window_t *Copy_pstrTile)
+{
+	if(Copy_pstrTFTHandle==NULL || Copy_pstrTile==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u32MaxPixels > TFT_MAX_TILE_PIXELS)
+		Copy_u32MaxPixels = TFT_MAX_TILE_PIXELS;
+
+	if(Copy_u32MaxPixels < Copy_pstrTFTHandle->Width)
+		return ES_NOT_OK;
+
+	if(Copy_pstrTFTHandle->DirtyCount == 0)
+		return ES_NOT_OK;
+
+	TFT_Window_t *Local_pstrDirty = &Copy_pstrTFTHandle->Dirty[0];
+
+	u16 Local_u16Rows = Copy_u32MaxPixels / Local_pstrDirty->Width;
+
+	if(Local_u16Rows > Local_pstrDirty->Height)
+		Local_u16Rows = Local_pstrDirty->Height;
+
+	Copy_pstrTile->X = Local_pstrDirty->X;
+	Copy_pstrTile->Y = Local_pstrDirty->Y;
+	Copy_pstrTile->Width = Local_pstrDirty->Width;
+	Copy_pstrTile->Height = Local_u16Rows;
+
+	Local_pstrDirty->Y += Local_u16Rows;
+	Local_pstrDirty->Height -= Local_u16Rows;
+
+	if(Local_pstrDirty->Height == 0)
+	{
+		Copy_pstrTFTHandle->DirtyCount--;
+		Copy_pstrTFTHandle->Dirty[0] = Copy_pstrTFTHandle->Dirty[Copy_pstrTFTHandle->DirtyCount];
+	}
+
+	return ES_OK;
+}
+
+
+ES_t TFT_enuQueueFlush(TFT_Handle_t *Copy_pstrTFTHandle, TFT_Window_t *Copy_pstrWindow, u16 *Copy_pu16Pixels)
+{
+	if(Copy_pstrTFTHandle==NULL || Copy_pstrWindow==NULL || Copy_pu16Pixels==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrWindow->Width == 0 || Copy_pstrWindow->Height == 0 ||
+			(u32)Copy_pstrWindow->Width * Copy_pstrWindow->Height > TFT_MAX_TILE_PIXELS ||
+			Copy_pstrWindow->X + Copy_pstrWindow->Width > Copy_pstrTFTHandle->Width ||
+			Copy_pstrWindow->Y + Copy_pstrWindow->Height > Copy_pstrTFTHandle->Height)
+		return ES_NOT_OK;
+
+	u8 Local_u8Head = Copy_pstrTFTHandle->QueueHead;
+
+	if(((Local_u8Head - Copy_pstrTFTHandle->QueueTail) & 0xFF) >= TFT_FLUSH_QUEUE_LEN)
+		return ES_FUNC_IS_BUSY;
+
+	Copy_pstrTFTHandle->Queue[Local_u8Head & TFT_QUEUE_MASK].Window = *Copy_pstrWindow;
+	Copy_pstrTFTHandle->Queue[Local_u8Head & TFT_QUEUE_MASK].pPixels = Copy_pu16Pixels;
+
+	//publish the entry before looking at Busy, the DMA interrupt either sees it or has already gone idle
+	Copy_pstrTFTHandle->QueueHead = Local_u8Head + 1;
+
+	if(Copy_pstrTFTHandle->Busy == 0)
+	{
+		Copy_pstrTFTHandle->Busy = 1;
+		tft_start_next(Copy_pstrTFTHandle);
+	}
+
+	return ES_OK;
+}
+
+
+ES_t TFT_enuIsBusy(TFT_Handle_t *Copy_pstrTFTHandle, u8 *Copy_pu8Busy)
+{
+	if(Copy_pstrTFTHandle==NULL || Copy_pu8Busy==NULL)
+		return ES_NULL_PTR;
+
+	*Copy_pu8Busy = Copy_pstrTFTHandle->Busy;
+
+	return ES_OK;
+}
+
+
+//some helper function implementations
+
+/*
+ * Command byte with DC low then big endian 16 bits parameters with DC high (8 bits frames)
+ */
+static void tft_write_cmd(TFT_Handle_t *Copy_pstrTFTHandle, u8 Copy_u8Cmd, u16 Copy_u16Start, u16 Copy_u16End, u8 Copy_u8ParamLen)
+{
+	u8 Local_au8Param[4] = {(u8)(Copy_u16Start >> 8), (u8)Copy_u16Start, (u8)(Copy_u16End >> 8), (u8)Copy_u16End};
+
+	GPIO_enuWriteToOutputPin(Copy_pstrTFTHandle->DCPort, Copy_pstrTFTHandle->DCPin, GPIO_LOW);
+	SPI_enuTransceiveBurst(Copy_pstrTFTHandle->pSPIHandle, &Copy_u8Cmd, NULL, 1);
+	GPIO_enuWriteToOutputPin(Copy_pstrTFTHandle->DCPort, Copy_pstrTFTHandle->DCPin, GPIO_HIGH);
+
+	if(Copy_u8ParamLen > 0)
+	{
+		SPI_enuTransceiveBurst(Copy_pstrTFTHandle->pSPIHandle, Local_au8Param, NULL, Copy_u8ParamLen);
+	}
+}
+
+/*
+ * Sets the address window then streams the tile pixels as 16 bits frames by DMA,
+ * RGB565 words are sent MSB first so no byte swapping is needed.
+ * Goes idle once the queue is empty.
+ */
+static void tft_start_next(TFT_Handle_t *Copy_pstrTFTHandle)
+{
+	while(Copy_pstrTFTHandle->QueueTail != Copy_pstrTFTHandle->QueueHead)
+	{
+		TFT_Flush_t *Local_pstrFlush = &Copy_pstrTFTHandle->Queue[Copy_pstrTFTHandle->QueueTail & TFT_QUEUE_MASK];
+		TFT_Window_t *Local_pstrWindow = &Local_pstrFlush->Window;
+		u16 *Local_pu16Pixels = Local_pstrFlush->pPixels;
+
+		SPI_enuSetDataFrameFormat(Copy_pstrTFTHandle->pSPIHandle, SPI_DFF_8Bits);
+
+		GPIO_enuWriteToOutputPin(Copy_pstrTFTHandle->CSPort, Copy_pstrTFTHandle->CSPin, GPIO_LOW);
+
+		tft_write_cmd(Copy_pstrTFTHandle, TFT_CMD_COLUMN_ADDR_SET, Local_pstrWindow->X,
+				Local_pstrWindow->X + Local_pstrWindow->Width - 1, 4);
+		tft_write_cmd(Copy_pstrTFTHandle, TFT_CMD_PAGE_ADDR_SET, Local_pstrWindow->Y,
+				Local_pstrWindow->Y + Local_pstrWindow->Height - 1, 4);
+		tft_write_cmd(Copy_pstrTFTHandle, TFT_CMD_MEMORY_WRITE, 0, 0, 0);
+
+		SPI_enuSetDataFrameFormat(Copy_pstrTFTHandle->pSPIHandle, SPI_DFF_16Bits);
+
+		if(SPI_enuTransceiveDMA(Copy_pstrTFTHandle->pSPIHandle, (u8*)Local_pu16Pixels, NULL,
+				(u32)Local_pstrWindow->Width * Local_pstrWindow->Height * 2, tft_spi_done) == ES_OK)
+			return;
+
+		//the tile is dropped but its buffer goes back to the application, then the next one is tried
+		GPIO_enuWriteToOutputPin(Copy_pstrTFTHandle->CSPort, Copy_pstrTFTHandle->CSPin, GPIO_HIGH);
+		Copy_pstrTFTHandle->QueueTail++;
+
+		if(Copy_pstrTFTHandle->FlushDoneFunc != NULL)
+		{
+			Copy_pstrTFTHandle->FlushDoneFunc(Local_pu16Pixels, ES_NOT_OK);
+		}
+	}
+
+	Copy_pstrTFTHandle->Busy = 0;
+}
+
+static void tft_spi_done(void)
+{
+	TFT_Handle_t *Local_pstrTFTHandle = tft_active;
+
+	if(Local_pstrTFTHandle == NULL)
+		return;
+
+	u16 *Local_pu16Pixels = Local_pstrTFTHandle->Queue[Local_pstrTFTHandle->QueueTail & TFT_QUEUE_MASK].pPixels;
+
+	GPIO_enuWriteToOutputPin(Local_pstrTFTHandle->CSPort, Local_pstrTFTHandle->CSPin, GPIO_HIGH);
+
+	Local_pstrTFTHandle->QueueTail++;
+
+	tft_start_next(Local_pstrTFTHandle);
+
+	if(Local_pstrTFTHandle->FlushDoneFunc != NULL)
+	{
+		Local_pstrTFTHandle->FlushDoneFunc(Local_pu16Pixels, ES_OK);
+	}
+}
+
+static u8 tft_touch(TFT_Window_t *Copy_pstrA, TFT_Window_t *Copy_pstrB)
+{
+	return (Copy_pstrA->X <= Copy_pstrB->X + Copy_pstrB->Width) && (Copy_pstrB->X <= Copy_pstrA->X + Copy_pstrA->Width) &&
+			(Copy_pstrA->Y <= Copy_pstrB->Y + Copy_pstrB->Height) && (Copy_pstrB->Y <= Copy_pstrA->Y + Copy_pstrA->Height);
+}
+
+static void tft_merge(TFT_Window_t *Copy_pstrDest, TFT_Window_t *Copy_pstrSrc)
+{
+	u16 Local_u16X0 = (Copy_pstrDest->X < Copy_pstrSrc->X)? Copy_pstrDest->X : Copy_pstrSrc->X;
+	u16 Local_u16Y0 = (Copy_pstrDest->Y < Copy_pstrSrc->Y)? Copy_pstrDest->Y : Copy_pstrSrc->Y;
+	u16 Local_u16X1 = Copy_pstrDest->X + Copy_pstrDest->Width;
+	u16 Local_u16Y1 = Copy_pstrDest->Y + Copy_pstrDest->Height;
+
+	if(Copy_pstrSrc->X + Copy_pstrSrc->Width > Local_u16X1)
+		Local_u16X1 = Copy_pstrSrc->X + Copy_pstrSrc->Width;
+
+	if(Copy_pstrSrc->Y + Copy_pstrSrc->Height > Local_u16Y1)
+		Local_u16Y1 = Copy_pstrSrc->Y + Copy_pstrSrc->Height;
+
+	Copy_pstrDest->X = Local_u16X0;
+	Copy_pstrDest->Y = Local_u16Y0;
+	Copy_pstrDest->Width = Local_u16X1 - Local_u16X0;
+	Copy_pstrDest->Height = Local_u16Y1 - Local_u16Y0;
+}
+
+static u32 tft_area(TFT_Window_t *Copy_pstrWindow)
+{
+	return (u32)Copy_pstrWindow->Width * Copy_pstrWindow->Height;
+}
@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : stm32f407x_dma.h
+ * @author         : Rezk Ahmed
+ * @Layer          : MCAL
+ * @brief          : Ensure that all hardware information is gathered and abstracted
+ *                   from the drivers layer (ECU or Board layer), and provide higher
+ *                   layer APIs with access and control over the peripheral drivers.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef STM32F407X_MCAL_INC_STM32F407X_DMA_H_
+#define STM32F407X_MCAL_INC_STM32F407X_DMA_H_
+
+
+/*
+ * Memory map and register definitions
+ */
+
+#define DMA1_BASEADDR         0x40026000
+#define DMA2_BASEADDR         0x40026400
+
+
+typedef struct
+{
+	__vo u32 CR;         /*Address offset: 0x10 + 0x18 * Stream */
+	__vo u32 NDTR;       /*Address offset: 0x14 + 0x18 * Stream */
+	__vo u32 PAR;        /*Address offset: 0x18 + 0x18 * Stream */
+	__vo u32 M0AR;       /*Address offset: 0x1C + 0x18 * Stream */
+	__vo u32 M1AR;       /*Address offset: 0x20 + 0x18 * Stream */
+	__vo u32 FCR;        /*Address offset: 0x24 + 0x18 * Stream */
+} DMA_StreamRegDef_t;
+
+typedef struct
+{
+	__vo u32 LISR;       /*Address offset: 0x00 */
+	__vo u32 HISR;       /*Address offset: 0x04 */
+	__vo u32 LIFCR;      /*Address offset: 0x08 */
+	__vo u32 HIFCR;      /*Address offset: 0x0C */
+	DMA_StreamRegDef_t S[8];
+} DMA_RegDef_t;
+
+
+#define DMA1      ((DMA_RegDef_t*)DMA1_BASEADDR)
+#define DMA2      ((DMA_RegDef_t*)DMA2_BASEADDR)
+
+/******************************************************************************************
+ *Bit position definitions of DMA peripheral
+ ******************************************************************************************/
+/*
+ * Bit position definitions DMA_SxCR
+ */
+#define MCAL_DMA_CR_EN     				 	0
+#define MCAL_DMA_CR_DMEIE     				1
+#define MCAL_DMA_CR_TEIE     				2
+#define MCAL_DMA_CR_HTIE     				3
+#define MCAL_DMA_CR_TCIE     				4
+#define MCAL_DMA_CR_PFCTRL     				5
+#define MCAL_DMA_CR_DIR     				6
+#define MCAL_DMA_CR_CIRC     				8
+#define MCAL_DMA_CR_PINC     				9
+#define MCAL_DMA_CR_MINC     				10
+#define MCAL_DMA_CR_PSIZE     				11
+#define MCAL_DMA_CR_MSIZE     				13
+#define MCAL_DMA_CR_PINCOS     				15
+#define MCAL_DMA_CR_PL     				 	16
+#define MCAL_DMA_CR_DBM     				18
+#define MCAL_DMA_CR_CT     				 	19
+#define MCAL_DMA_CR_PBURST     				21
+#define MCAL_DMA_CR_MBURST     				23
+#define MCAL_DMA_CR_CHSEL     				25
+
+/*
+ * Bit position definitions DMA_SxFCR
+ */
+#define MCAL_DMA_FCR_FTH     				0
+#define MCAL_DMA_FCR_DMDIS     				2
+#define MCAL_DMA_FCR_FEIE     				7
+
+/*
+ * @DMA_Direction
+ */
+#define MCAL_DMA_DIR_PERIPH_TO_MEM       0
+#define MCAL_DMA_DIR_MEM_TO_PERIPH       1
+#define MCAL_DMA_DIR_MEM_TO_MEM          2
+
+/*
+ * @DMA_DataSize
+ */
+#define MCAL_DMA_SIZE_BYTE               0
+#define MCAL_DMA_SIZE_HALF_WORD          1
+#define MCAL_DMA_SIZE_WORD               2
+
+/*
+ * @DMA_Mode
+ */
+#define MCAL_DMA_MODE_NORMAL             0
+#define MCAL_DMA_MODE_CIRCULAR           1
+#define MCAL_DMA_MODE_DOUBLE_BUFFER      2
+
+/*
+ * @DMA_Priority
+ */
+#define MCAL_DMA_PRIORITY_LOW            0
+#define MCAL_DMA_PRIORITY_MED            1
+#define MCAL_DMA_PRIORITY_HIGH           2
+#define MCAL_DMA_PRIORITY_VERY_HIGH      3
+
+/*
+ * @DMA_Increment
+ */
+#define MCAL_DMA_INC_DISABLE             0
+#define MCAL_DMA_INC_ENABLE              1
+
+/*
+ * DMA related status flags definitions (normalized to stream 0 positions)
+ */
+#define MCAL_DMA_FLAG_FE                 (1 << 0)
+#define MCAL_DMA_FLAG_DME                (1 << 2)
+#define MCAL_DMA_FLAG_TE                 (1 << 3)
+#define MCAL_DMA_FLAG_HT                 (1 << 4)
+#define MCAL_DMA_FLAG_TC                 (1 << 5)
+#define MCAL_DMA_FLAG_ALL                (MCAL_DMA_FLAG_FE | MCAL_DMA_FLAG_DME | MCAL_DMA_FLAG_TE |\
+		                                  MCAL_DMA_FLAG_HT | MCAL_DMA_FLAG_TC)
+
+/*
+ * DMA related interrupt sources
+ */
+#define MCAL_DMA_DME_INT                 MCAL_DMA_CR_DMEIE
+#define MCAL_DMA_TE_INT                  MCAL_DMA_CR_TEIE
+#define MCAL_DMA_HT_INT                  MCAL_DMA_CR_HTIE
+#define MCAL_DMA_TC_INT                  MCAL_DMA_CR_TCIE
+
+
+#define MCAL_DMA_CODE_TO_BASADDR(x)         ( (x == 0)?DMA1:\
+		                                      (x == 1)?DMA2:0)
+
+
+void MCAL_DMA_EnableStream(DMA_RegDef_t *pDMAx, u8 Stream);
+void MCAL_DMA_DisableStream(DMA_RegDef_t *pDMAx, u8 Stream);
+u8 MCAL_DMA_GetStreamStatus(DMA_RegDef_t *pDMAx, u8 Stream);
+
+void MCAL_DMA_SetChannel(DMA_RegDef_t *pDMAx, u8 Stream, u8 Channel);
+void MCAL_DMA_SetDirection(DMA_RegDef_t *pDMAx, u8 Stream, u8 Direction);
+void MCAL_DMA_SetDataSize(DMA_RegDef_t *pDMAx, u8 Stream, u8 PeriphSize, u8 MemSize);
+void MCAL_DMA_SetIncrement(DMA_RegDef_t *pDMAx, u8 Stream, u8 PeriphInc, u8 MemInc);
+void MCAL_DMA_SetMode(DMA_RegDef_t *pDMAx, u8 Stream, u8 Mode);
+void MCAL_DMA_SetPriority(DMA_RegDef_t *pDMAx, u8 Stream, u8 Priority);
+
+void MCAL_DMA_SetPeriphAddress(DMA_RegDef_t *pDMAx, u8 Stream, u32 Address);
+void MCAL_DMA_SetMemoryAddress(DMA_RegDef_t *pDMAx, u8 Stream, u8 Target, u32 Address);
+void MCAL_DMA_SetDataCounter(DMA_RegDef_t *pDMAx, u8 Stream, u16 Count);
+u16 MCAL_DMA_GetDataCounter(DMA_RegDef_t *pDMAx, u8 Stream);
+u8 MCAL_DMA_GetCurrentTarget(DMA_RegDef_t *pDMAx, u8 Stream);
+
+void MCAL_DMA_InterruptControl(DMA_RegDef_t *pDMAx, u8 Stream, u8 InterruptName, u8 EnOrDi);
+
+u8 MCAL_DMA_GetFlags(DMA_RegDef_t *pDMAx, u8 Stream);
+void MCAL_DMA_ClearFlags(DMA_RegDef_t *pDMAx, u8 Stream, u8 Flags);
+
+
+#endif /* STM32F407X_MCAL_INC_STM32F407X_DMA_H_ */
@@ -88,6 +88,24 @@ typedef struct
 #define SYSCFG				((SYSCFG_RegDef_t*)SYSCFG_BASEADDR)
 
 
+/*
+ * Configuration of several pins of one port, for each register the bits of Mask are replaced by Value
+ */
+typedef struct
+{
+	u32 ModeMask;
+	u32 ModeValue;
+	u16 OTypeMask;
+	u16 OTypeValue;
+	u32 SpeedMask;
+	u32 SpeedValue;
+	u32 PuPdMask;
+	u32 PuPdValue;
+	u32 AltFunMask[2];
+	u32 AltFunValue[2];
+}GPIO_PortRegCfg_t;
+
+
 #define MCAL_GPIO_PORTA               0
 #define MCAL_GPIO_PORTB               1
 #define MCAL_GPIO_PORTC               2
@@ -97,6 +115,20 @@ typedef struct
 #define MCAL_GPIO_PORTG               6
 #define MCAL_GPIO_PORTH               7
 
+#define MCAL_GPIO_PORTS_NUM           8
+
+/*
+ * port code to base address in one load, the code must be checked by the caller
+ */
+extern GPIO_RegDef_t * const MCAL_GPIO_PortBaseAddr[MCAL_GPIO_PORTS_NUM];
+
+#define MCAL_GPIO_CODE_TO_BASADDR(x)        (MCAL_GPIO_PortBaseAddr[(x)])
+
+/*
+ * same mapping by address arithmetic, folds to a constant for a constant code (compile-time pins)
+ */
+#define MCAL_GPIO_CODE_TO_CONST_BASADDR(x)  ((GPIO_RegDef_t*)(GPIOA_BASEADDR + 0x400U * (x)))
+
 #define MCAL_GPIO_MODE_INPUT               0
 #define MCAL_GPIO_MODE_OUTPUT              1
 #define MCAL_GPIO_MODE_ALTFUN              2
@@ -128,11 +160,59 @@ ES_t MCAL_GPIO_WritePin(GPIO_RegDef_t *GPIO_BaseAddr, u8 PinNum,u8 Value);
 ES_t MCAL_GPIO_ReadPin(GPIO_RegDef_t *GPIO_BaseAddr, u8 PinNum,u8 *Value);
 ES_t MCAL_GPIO_TogglePin(GPIO_RegDef_t *GPIO_BaseAddr, u8 PinNum);
 
+/*
+ * Whole port configuration, one read-modify-write per register, MODER last
+ */
+ES_t MCAL_GPIO_ConfigPort(GPIO_RegDef_t *GPIO_BaseAddr, const GPIO_PortRegCfg_t *PortCfg);
+
+/*
+ * Whole port access, one bus access each: BSRR sets the pins of Mask to Value (other pins untouched,
+ * no read-modify-write), IDR gives the 16 pins
+ */
+ES_t MCAL_GPIO_WritePortMasked(GPIO_RegDef_t *GPIO_BaseAddr, u16 Mask, u16 Value);
+ES_t MCAL_GPIO_ReadPort(GPIO_RegDef_t *GPIO_BaseAddr, u16 *Value);
+
+/*
+ * Inline pin access for pins known at compile time, with constant arguments each one is a single
+ * store to BSRR / load of IDR (toggle: load of ODR then store to BSRR)
+ */
+static inline void MCAL_GPIO_SetPinsInline(GPIO_RegDef_t *GPIO_BaseAddr, u16 Mask)
+{
+	GPIO_BaseAddr->BSRR = Mask;
+}
+
+static inline void MCAL_GPIO_ResetPinsInline(GPIO_RegDef_t *GPIO_BaseAddr, u16 Mask)
+{
+	GPIO_BaseAddr->BSRR = (u32)Mask << 16;
+}
+
+static inline void MCAL_GPIO_WritePinsInline(GPIO_RegDef_t *GPIO_BaseAddr, u16 Mask, u8 Value)
+{
+	GPIO_BaseAddr->BSRR = Value ? (u32)Mask : ((u32)Mask << 16);
+}
+
+static inline void MCAL_GPIO_TogglePinsInline(GPIO_RegDef_t *GPIO_BaseAddr, u16 Mask)
+{
+	u32 Local_u32ODR = GPIO_BaseAddr->ODR;
+
+	GPIO_BaseAddr->BSRR = ((Local_u32ODR & Mask) << 16) | (~Local_u32ODR & Mask);
+}
+
+static inline u8 MCAL_GPIO_ReadPinsInline(GPIO_RegDef_t *GPIO_BaseAddr, u16 Mask)
+{
+	return (GPIO_BaseAddr->IDR & Mask) != 0;
+}
+
 ES_t MCAL_SYSCFG_SellectEXTIChannel(u8 GPIO_Port,u8 PinNum);
 
 ES_t MCAL_EXTI_SetEdgeTrig(u8 PinNum,u8 Mode);
 ES_t MCAL_EXTI_EnableLine(u8 PinNum);
 ES_t MCAL_EXTI_SetCallBack(u8 Line, void (*callBackFun)(void));
 
+/*
+ * count of the interrupts handled on a line since reset (callback or not)
+ */
+ES_t MCAL_EXTI_GetHitCount(u8 Line, u32 *Count);
+
 
 #endif /* STM32F407X_MCAL_INC_STM32F407X_GPIO_EXTI_H_ */
@@ -20,16 +20,16 @@
 
 typedef struct
 {
-  __vo u8 CR1;
-  __vo u8 CR2;
-  __vo u8 OAR1;
-  __vo u8 OAR2;
-  __vo u8 DR;
-  __vo u8 SR1;
-  __vo u8 SR2;
-  __vo u8 CCR;
-  __vo u8 TRISE;
-  __vo u8 FLTR;
+  __vo u32 CR1;
+  __vo u32 CR2;
+  __vo u32 OAR1;
+  __vo u32 OAR2;
+  __vo u32 DR;
+  __vo u32 SR1;
+  __vo u32 SR2;
+  __vo u32 CCR;
+  __vo u32 TRISE;
+  __vo u32 FLTR;
 }I2C_RegDef_t;
 
 
@@ -45,10 +45,15 @@ typedef struct
  * Bit position definitions I2C_CR1
  */
 #define MCAL_I2C_CR1_PE						0
+#define MCAL_I2C_CR1_SMBUS					1
+#define MCAL_I2C_CR1_SMBTYPE				3
+#define MCAL_I2C_CR1_ENPEC					5
 #define MCAL_I2C_CR1_NOSTRETCH  			7
 #define MCAL_I2C_CR1_START 					8
 #define MCAL_I2C_CR1_STOP  				 	9
 #define MCAL_I2C_CR1_ACK 				 	10
+#define MCAL_I2C_CR1_PEC 				 	12
+#define MCAL_I2C_CR1_ALERT 				 	13
 #define MCAL_I2C_CR1_SWRST  				15
 
 /*
@@ -58,6 +63,8 @@ typedef struct
 #define MCAL_I2C_CR2_ITERREN				8
 #define MCAL_I2C_CR2_ITEVTEN				9
 #define MCAL_I2C_CR2_ITBUFEN 			    10
+#define MCAL_I2C_CR2_DMAEN 				    11
+#define MCAL_I2C_CR2_LAST 				    12
 
 /*
  * Bit position definitions I2C_OAR1
@@ -67,6 +74,12 @@ typedef struct
 #define MCAL_I2C_OAR1_ADD98  			 	 8
 #define MCAL_I2C_OAR1_ADDMODE   			 15
 
+/*
+ * Bit position definitions I2C_OAR2
+ */
+#define MCAL_I2C_OAR2_ENDUAL   				 0
+#define MCAL_I2C_OAR2_ADD2   				 1
+
 /*
  * Bit position definitions I2C_SR1
  */
@@ -82,7 +95,9 @@ typedef struct
 #define MCAL_I2C_SR1_ARLO 					9
 #define MCAL_I2C_SR1_AF 					10
 #define MCAL_I2C_SR1_OVR 					11
+#define MCAL_I2C_SR1_PECERR 				12
 #define MCAL_I2C_SR1_TIMEOUT 				14
+#define MCAL_I2C_SR1_SMBALERT 				15
 
 /*
  * Bit position definitions I2C_SR2
@@ -143,6 +158,8 @@ typedef struct
 #define MCAL_I2C_FLAG_BTF  		    ( 1 << MCAL_I2C_SR1_BTF)
 #define MCAL_I2C_FLAG_ADDR 		    ( 1 << MCAL_I2C_SR1_ADDR)
 #define MCAL_I2C_FLAG_TIMEOUT 	    ( 1 << MCAL_I2C_SR1_TIMEOUT)
+#define MCAL_I2C_FLAG_PECERR 	    ( 1 << MCAL_I2C_SR1_PECERR)
+#define MCAL_I2C_FLAG_SMBALERT 	    ( 1 << MCAL_I2C_SR1_SMBALERT)
 
 
 /*
@@ -177,6 +194,16 @@ typedef struct
 #define MCAL_I2C_TRANSMITTER        1
 #define MCAL_I2C_RECEIVER           0
 
+#define MCAL_I2C_ADDMODE_7BITS      0
+#define MCAL_I2C_ADDMODE_10BITS     1
+
+/*
+ * @I2C_BusMode
+ */
+#define MCAL_I2C_MODE_I2C           0
+#define MCAL_I2C_MODE_SMBUS_DEVICE  1
+#define MCAL_I2C_MODE_SMBUS_HOST    2
+
 
 
 #define MCAL_I2C_CODE_TO_BASADDR(x)         ( (x == 0)?I2C1:\
@@ -184,9 +211,20 @@ typedef struct
 			                                  (x == 2)?I2C3:0)
 
 
+void MCAL_I2C_Enable(I2C_RegDef_t *pI2Cx);
+void MCAL_I2C_Disable(I2C_RegDef_t *pI2Cx);
+void MCAL_I2C_SoftwareReset(I2C_RegDef_t *pI2Cx);
+
+/*
+ * Software reset that gives back CR1 / CR2 / OAR / CCR / TRISE / FLTR, the START / STOP / PEC / POS / LAST
+ * requests of the aborted transfer are dropped
+ */
+void MCAL_I2C_SoftwareResetKeepConfig(I2C_RegDef_t *pI2Cx);
+
 void MCAL_I2C_AckBitControl(I2C_RegDef_t *pI2Cx,u8 AckEnOrDi);
 void MCAL_I2c_SetFreqFeild(I2C_RegDef_t *pI2Cx, u32 APB1Freq);
-void MCAL_I2C_SetDeviceOwnAddress(I2C_RegDef_t *pI2Cx,u8 DeviceAddress);
+void MCAL_I2C_SetDeviceOwnAddress(I2C_RegDef_t *pI2Cx,u16 DeviceAddress, u8 AddrMode);
+void MCAL_I2C_SetDualAddress(I2C_RegDef_t *pI2Cx, u8 DeviceAddress2);
 void MCAL_I2C_SetClockControl(I2C_RegDef_t *pI2Cx,u32 APB1Freq,u32 Speed, u8 FMDutyCycle);
 void MCAL_I2C_SetTRISEConfig(I2C_RegDef_t *pI2Cx, u32 APB1Freq, u32 Speed);
 
@@ -196,10 +234,20 @@ void MCAL_I2C_ClearADDRFlag(I2C_RegDef_t *pI2Cx);
 
 void MCAL_I2C_GenerateStartCondition(I2C_RegDef_t *pI2Cx);
 void MCAL_I2C_GenerateStopCondition(I2C_RegDef_t *pI2Cx);
+u8 MCAL_I2C_GetStopStatus(I2C_RegDef_t *pI2Cx);
+u8 MCAL_I2C_GetBusBusy(I2C_RegDef_t *pI2Cx);
+u8 MCAL_I2C_GetMasterStatus(I2C_RegDef_t *pI2Cx);
 
 void MCAL_I2C_ExecuteAddressPhaseWrite(I2C_RegDef_t *pI2Cx, u8 SlaveAddr);
 void MCAL_I2C_ExecuteAddressPhaseRead(I2C_RegDef_t *pI2Cx, u8 SlaveAddr);
 
+/*
+ * 10 bits addressing: the header 11110 A9 A8 R/nW is sent after SB (ADD10 set when acknowledged),
+ * then the low byte after ADD10 (ADDR set), a read repeats START and the header with R/nW = 1
+ */
+void MCAL_I2C_ExecuteAddressHeader10Bits(I2C_RegDef_t *pI2Cx, u16 SlaveAddr, u8 Read);
+void MCAL_I2C_ExecuteAddressLow10Bits(I2C_RegDef_t *pI2Cx, u16 SlaveAddr);
+
 
 u8 MCAL_I2C_GetFlagStatus(I2C_RegDef_t *pI2Cx, u32 FlagName);
 void MCAL_I2C_ClearFlag(I2C_RegDef_t *pI2Cx, u32 FlagName);
@@ -212,6 +260,30 @@ void MCAL_I2C_ClearSTOPFlag(I2C_RegDef_t *pI2Cx);
 
 u8 MCAL_I2C_GetDeviceMode(I2C_RegDef_t *pI2Cx);
 u8 MCAL_I2C_GetTransceiverMode(I2C_RegDef_t *pI2Cx);
+u8 MCAL_I2C_GetDualFlag(I2C_RegDef_t *pI2Cx);
+
+/*
+ * DMA requests on TXE / RXNE, with LAST the byte of the next DMA EOT is NACKed (master receiver)
+ */
+void MCAL_I2C_DMAControl(I2C_RegDef_t *pI2Cx, u8 EnOrDi);
+void MCAL_I2C_LastTransferControl(I2C_RegDef_t *pI2Cx, u8 EnOrDi);
+u32  MCAL_I2C_GetDataRegAddress(I2C_RegDef_t *pI2Cx);
+
+/*
+ * SMBus, PEC is the CRC-8 (x^8 + x^2 + x + 1) of every byte on the bus addresses included,
+ * TransferPEC sends it after the last byte (transmitter) or checks the last byte against it (receiver)
+ */
+void MCAL_I2C_SetBusMode(I2C_RegDef_t *pI2Cx, u8 Mode);
+void MCAL_I2C_PECControl(I2C_RegDef_t *pI2Cx, u8 EnOrDi);
+void MCAL_I2C_TransferPEC(I2C_RegDef_t *pI2Cx);
+void MCAL_I2C_AlertControl(I2C_RegDef_t *pI2Cx, u8 EnOrDi);
+
+/*
+ * Slave clock stretching (on by default), to be changed while the peripheral is disabled.
+ * Without it ADDR / BTF do not hold SCL, DR must be written / read before the master clocks the next byte
+ * (OVR otherwise).
+ */
+void MCAL_I2C_ClockStretchControl(I2C_RegDef_t *pI2Cx, u8 EnOrDi);
 
 
 #endif /* STM32F407X_MCAL_INC_STM32F407X_I2C_H_ */
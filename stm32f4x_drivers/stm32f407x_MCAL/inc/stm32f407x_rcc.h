@@ -24,7 +24,7 @@
 
 
 
-#define RCC_BASEADDR                     (0x40003800)
+#define RCC_BASEADDR                     (0x40023800)
 
 /*
  * peripheral register definition structure for RCC
@@ -86,6 +86,21 @@ typedef struct
 #define RCC_CFGR_SW1    1
 #define RCC_CFGR_SWS0   2
 #define RCC_CFGR_SWS1   3
+#define RCC_CFGR_I2SSRC 23
+
+
+#define RCC_PLLCFGR_PLLM     0
+#define RCC_PLLCFGR_PLLSRC   22
+
+#define RCC_PLLI2SCFGR_PLLI2SN   6
+#define RCC_PLLI2SCFGR_PLLI2SR   28
+
+/**********  PLLI2S limits  ***********/
+
+#define MCAL_RCC_PLLI2SN_MIN                 50
+#define MCAL_RCC_PLLI2SN_MAX                 432
+#define MCAL_RCC_PLLI2SR_MIN                 2
+#define MCAL_RCC_PLLI2SR_MAX                 7
 
 
 
@@ -140,6 +155,9 @@ ES_t MCAL_RCC_GetAPB1Value(u32 *APB2Value);
 ES_t MCAL_RCC_GetAPB2Value(u32 *APB2Value);
 ES_t MCAL_RCC_GetSysClkType(u8 *SysClkType);
 ES_t MCAL_RCC_GetSysClkValue(u32 *SysClkValue);
+ES_t MCAL_RCC_GetAHBValue(u32 *AHBValue);
+ES_t MCAL_RCC_GetPLLInputValue(u32 *PLLInputValue);
+ES_t MCAL_RCC_ConfigPLLI2S(u16 PLLI2SN, u8 PLLI2SR);
 
 
 #endif /* STM32F407X_MCAL_INC_STM32F407X_RCC_H_ */
@@ -95,6 +95,25 @@ typedef struct
 #define MCAL_SPI_SR_BSY					 	7
 #define MCAL_SPI_SR_FRE					 	8
 
+/*
+ * Bit position definitions SPI_I2SCFGR
+ */
+#define MCAL_SPI_I2SCFGR_CHLEN				0
+#define MCAL_SPI_I2SCFGR_DATLEN				1
+#define MCAL_SPI_I2SCFGR_CKPOL				3
+#define MCAL_SPI_I2SCFGR_I2SSTD				4
+#define MCAL_SPI_I2SCFGR_PCMSYNC			7
+#define MCAL_SPI_I2SCFGR_I2SCFG				8
+#define MCAL_SPI_I2SCFGR_I2SE				10
+#define MCAL_SPI_I2SCFGR_I2SMOD				11
+
+/*
+ * Bit position definitions SPI_I2SPR
+ */
+#define MCAL_SPI_I2SPR_I2SDIV				0
+#define MCAL_SPI_I2SPR_ODD					8
+#define MCAL_SPI_I2SPR_MCKOE				9
+
 /*
  * @SPI_DeviceMode
  */
@@ -145,6 +164,41 @@ typedef struct
 #define MCAL_SPI_SSM_EN    		 1
 #define MCAL_SPI_SSM_DI     	 0
 
+/*
+ * @I2S_Mode "I2SCFG"
+ */
+#define MCAL_I2S_MODE_SLAVE_TX       0
+#define MCAL_I2S_MODE_SLAVE_RX       1
+#define MCAL_I2S_MODE_MASTER_TX      2
+#define MCAL_I2S_MODE_MASTER_RX      3
+
+/*
+ * @I2S_Standard "I2SSTD"
+ */
+#define MCAL_I2S_STD_PHILIPS         0
+#define MCAL_I2S_STD_MSB             1
+#define MCAL_I2S_STD_LSB             2
+#define MCAL_I2S_STD_PCM             3
+
+/*
+ * @I2S_DataLen "DATLEN"
+ */
+#define MCAL_I2S_DATLEN_16BITS       0
+#define MCAL_I2S_DATLEN_24BITS       1
+#define MCAL_I2S_DATLEN_32BITS       2
+
+/*
+ * @I2S_ChannelLen "CHLEN"
+ */
+#define MCAL_I2S_CHLEN_16BITS        0
+#define MCAL_I2S_CHLEN_32BITS        1
+
+/*
+ * I2S prescaler limits "I2SDIV"
+ */
+#define MCAL_I2S_DIV_MIN             2
+#define MCAL_I2S_DIV_MAX             255
+
 
 /*
  * SPI related status flags definitions
@@ -153,6 +207,9 @@ typedef struct
 #define MCAL_SPI_RXNE_FLAG           (1 << MCAL_SPI_SR_RXNE)
 #define MCAL_SPI_BUSY_FLAG           (1 << MCAL_SPI_SR_BSY)
 #define MCAL_SPI_OVR_FLAG            (1 << MCAL_SPI_SR_OVR)
+#define MCAL_SPI_UDR_FLAG            (1 << MCAL_SPI_SR_UDR)
+#define MCAL_SPI_CHSIDE_FLAG         (1 << MCAL_SPI_SR_CHSIDE)
+#define MCAL_SPI_CRCERR_FLAG         (1 << MCAL_SPI_SR_CRCERR)
 /*
  * SPI related interrupt sources
  */
@@ -169,12 +226,15 @@ typedef struct
 
 void MCAL_PSI_Enable(SPI_RegDef_t *pPSIx);
 void MCAL_PSI_Disable(SPI_RegDef_t *pPSIx);
+u8 MCAL_SPI_GetEnableStatus(SPI_RegDef_t *pPSIx);
 void MCAL_SPI_SetDeviceMode(SPI_RegDef_t *pPSIx,u8 DeviceMode);
 void MCAL_SPI_SetBusConfig(SPI_RegDef_t *pPSIx,u8 BusConfig);
 void MCAL_SPI_SetClkSpeed(SPI_RegDef_t *pPSIx,u8 SclkSpeed);
 void MCAL_SPI_SetDataFrameFormate(SPI_RegDef_t *pPSIx,u8 DataFrameFormate);
 void MCAL_SPI_SetCPOL(SPI_RegDef_t *pPSIx,u8 CPOL);
 void MCAL_SPI_SetCPHA(SPI_RegDef_t *pPSIx,u8 CPHA);
+void MCAL_SPI_SetBidiOutput(SPI_RegDef_t *pPSIx,u8 EnOrDi);
+u8 MCAL_SPI_GetClkSpeed(SPI_RegDef_t *pPSIx);
 
 
 void MCAL_SPI_Write(SPI_RegDef_t *pPSIx, u16 Data);
@@ -185,10 +245,58 @@ void MCAL_SPI_EnableTxInterrupt(SPI_RegDef_t *pPSIx);
 void MCAL_SPI_DisableTxInterrupt(SPI_RegDef_t *pPSIx);
 void MCAL_SPI_EnableRxInterrupt(SPI_RegDef_t *pPSIx);
 void MCAL_SPI_DisableRxInterrupt(SPI_RegDef_t *pPSIx);
+void MCAL_SPI_EnableErrInterrupt(SPI_RegDef_t *pPSIx);
+void MCAL_SPI_DisableErrInterrupt(SPI_RegDef_t *pPSIx);
 
 u8 MCAL_SPI_GetInterruptStatus(SPI_RegDef_t *pPSIx,u8 IntSourceName);
 u8 MCAL_SPI_GetFlagStatus(SPI_RegDef_t *pSPIx, u8 StatusFlagName);
 
 void MCAL_SPI_ClearOVFLag(SPI_RegDef_t *pSPIx);
 
+/*
+ * Hardware CRC, CRCEN must only be changed while SPE is cleared (toggling it resets the CRC)
+ */
+void MCAL_SPI_EnableCRC(SPI_RegDef_t *pSPIx);
+void MCAL_SPI_DisableCRC(SPI_RegDef_t *pSPIx);
+void MCAL_SPI_SetCRCPolynomial(SPI_RegDef_t *pSPIx, u16 Polynomial);
+void MCAL_SPI_ClearCRCErrorFlag(SPI_RegDef_t *pSPIx);
+
+u32 MCAL_SPI_GetDataRegAddress(SPI_RegDef_t *pSPIx);
+
+/*
+ * Inline data register access for polling loops where a function call per frame is too slow
+ */
+static inline u32 MCAL_SPI_GetStatusInline(SPI_RegDef_t *pSPIx)
+{
+	return pSPIx->SR;
+}
+
+static inline void MCAL_SPI_WriteInline(SPI_RegDef_t *pSPIx, u16 Data)
+{
+	pSPIx->DR = Data;
+}
+
+static inline u16 MCAL_SPI_ReadInline(SPI_RegDef_t *pSPIx)
+{
+	return (u16)pSPIx->DR;
+}
+
+void MCAL_SPI_EnableTxDMA(SPI_RegDef_t *pSPIx);
+void MCAL_SPI_DisableTxDMA(SPI_RegDef_t *pSPIx);
+void MCAL_SPI_EnableRxDMA(SPI_RegDef_t *pSPIx);
+void MCAL_SPI_DisableRxDMA(SPI_RegDef_t *pSPIx);
+
+
+/*
+ * I2S (SPI2 and SPI3 only)
+ */
+void MCAL_I2S_Enable(SPI_RegDef_t *pSPIx);
+void MCAL_I2S_Disable(SPI_RegDef_t *pSPIx);
+void MCAL_I2S_SelectI2SMode(SPI_RegDef_t *pSPIx);
+void MCAL_I2S_SetMode(SPI_RegDef_t *pSPIx, u8 Mode);
+void MCAL_I2S_SetStandard(SPI_RegDef_t *pSPIx, u8 Standard);
+void MCAL_I2S_SetDataFormat(SPI_RegDef_t *pSPIx, u8 DataLen, u8 ChannelLen);
+void MCAL_I2S_SetCPOL(SPI_RegDef_t *pSPIx, u8 CPOL);
+void MCAL_I2S_SetPrescaler(SPI_RegDef_t *pSPIx, u8 Div, u8 Odd, u8 MCLKOutput);
+
 #endif /* STM32F407X_MCAL_INC_STM32F407X_SPI_H_ */
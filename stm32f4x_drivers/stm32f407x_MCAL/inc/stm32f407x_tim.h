@@ -0,0 +1,197 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : stm32f407x_tim.h
+ * @author         : Rezk Ahmed
+ * @Layer          : MCAL
+ * @brief          : Ensure that all hardware information is gathered and abstracted
+ *                   from the drivers layer (ECU or Board layer), and provide higher
+ *                   layer APIs with access and control over the peripheral drivers.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef STM32F407X_MCAL_INC_STM32F407X_TIM_H_
+#define STM32F407X_MCAL_INC_STM32F407X_TIM_H_
+
+
+/*
+ * Memory map and register definitions
+ */
+
+#define TIM1_BASEADDR         0x40010000
+#define TIM2_BASEADDR         0x40000000
+#define TIM3_BASEADDR         0x40000400
+#define TIM4_BASEADDR         0x40000800
+#define TIM5_BASEADDR         0x40000C00
+#define TIM6_BASEADDR         0x40001000
+#define TIM7_BASEADDR         0x40001400
+#define TIM8_BASEADDR         0x40010400
+#define TIM9_BASEADDR         0x40014000
+#define TIM10_BASEADDR        0x40014400
+#define TIM11_BASEADDR        0x40014800
+#define TIM12_BASEADDR        0x40001800
+#define TIM13_BASEADDR        0x40001C00
+#define TIM14_BASEADDR        0x40002000
+
+
+typedef struct
+{
+	__vo u32 CR1;        /*Address offset: 0x00 */
+	__vo u32 CR2;        /*Address offset: 0x04 */
+	__vo u32 SMCR;       /*Address offset: 0x08 */
+	__vo u32 DIER;       /*Address offset: 0x0C */
+	__vo u32 SR;         /*Address offset: 0x10 */
+	__vo u32 EGR;        /*Address offset: 0x14 */
+	__vo u32 CCMR[2];    /*Address offset: 0x18 */
+	__vo u32 CCER;       /*Address offset: 0x20 */
+	__vo u32 CNT;        /*Address offset: 0x24 */
+	__vo u32 PSC;        /*Address offset: 0x28 */
+	__vo u32 ARR;        /*Address offset: 0x2C */
+	__vo u32 RCR;        /*Address offset: 0x30 */
+	__vo u32 CCR[4];     /*Address offset: 0x34 */
+	__vo u32 BDTR;       /*Address offset: 0x44 */
+	__vo u32 DCR;        /*Address offset: 0x48 */
+	__vo u32 DMAR;       /*Address offset: 0x4C */
+	__vo u32 OR;         /*Address offset: 0x50 */
+} TIM_RegDef_t;
+
+
+#define TIM1      ((TIM_RegDef_t*)TIM1_BASEADDR)
+#define TIM2      ((TIM_RegDef_t*)TIM2_BASEADDR)
+#define TIM3      ((TIM_RegDef_t*)TIM3_BASEADDR)
+#define TIM4      ((TIM_RegDef_t*)TIM4_BASEADDR)
+#define TIM5      ((TIM_RegDef_t*)TIM5_BASEADDR)
+#define TIM6      ((TIM_RegDef_t*)TIM6_BASEADDR)
+#define TIM7      ((TIM_RegDef_t*)TIM7_BASEADDR)
+#define TIM8      ((TIM_RegDef_t*)TIM8_BASEADDR)
+#define TIM9      ((TIM_RegDef_t*)TIM9_BASEADDR)
+#define TIM10     ((TIM_RegDef_t*)TIM10_BASEADDR)
+#define TIM11     ((TIM_RegDef_t*)TIM11_BASEADDR)
+#define TIM12     ((TIM_RegDef_t*)TIM12_BASEADDR)
+#define TIM13     ((TIM_RegDef_t*)TIM13_BASEADDR)
+#define TIM14     ((TIM_RegDef_t*)TIM14_BASEADDR)
+
+/******************************************************************************************
+ *Bit position definitions of TIM peripheral
+ ******************************************************************************************/
+/*
+ * Bit position definitions TIM_CR1
+ */
+#define MCAL_TIM_CR1_CEN     				 0
+#define MCAL_TIM_CR1_UDIS     				 1
+#define MCAL_TIM_CR1_URS     				 2
+#define MCAL_TIM_CR1_OPM     				 3
+#define MCAL_TIM_CR1_DIR     				 4
+#define MCAL_TIM_CR1_ARPE     				 7
+
+/*
+ * Bit position definitions TIM_DIER
+ */
+#define MCAL_TIM_DIER_UIE     				 0
+#define MCAL_TIM_DIER_CC1IE   				 1
+#define MCAL_TIM_DIER_UDE     				 8
+#define MCAL_TIM_DIER_CC1DE   				 9
+
+/*
+ * Bit position definitions TIM_SR
+ */
+#define MCAL_TIM_SR_UIF     				 0
+#define MCAL_TIM_SR_CC1IF   				 1
+
+/*
+ * Bit position definitions TIM_EGR
+ */
+#define MCAL_TIM_EGR_UG     				 0
+
+/*
+ * Bit position definitions TIM_CCMRx (channel 1 / 3, add 8 for channel 2 / 4)
+ */
+#define MCAL_TIM_CCMR_CCS     				 0
+#define MCAL_TIM_CCMR_OCPE     				 3
+#define MCAL_TIM_CCMR_OCM     				 4
+
+/*
+ * Bit position definitions TIM_CCER (channel 1, add 4 per channel)
+ */
+#define MCAL_TIM_CCER_CCE     				 0
+#define MCAL_TIM_CCER_CCP     				 1
+
+/*
+ * Bit position definitions TIM_BDTR
+ */
+#define MCAL_TIM_BDTR_MOE     				 15
+
+
+/*
+ * @TIM_OCMode
+ */
+#define MCAL_TIM_OCMODE_FROZEN               0
+#define MCAL_TIM_OCMODE_ACTIVE               1
+#define MCAL_TIM_OCMODE_INACTIVE             2
+#define MCAL_TIM_OCMODE_TOGGLE               3
+#define MCAL_TIM_OCMODE_FORCE_INACTIVE       4
+#define MCAL_TIM_OCMODE_FORCE_ACTIVE         5
+#define MCAL_TIM_OCMODE_PWM1                 6
+#define MCAL_TIM_OCMODE_PWM2                 7
+
+/*
+ * @TIM_OCPolarity
+ */
+#define MCAL_TIM_OCPOLARITY_HIGH             0
+#define MCAL_TIM_OCPOLARITY_LOW              1
+
+
+/*
+ * TIM related status flags definitions
+ */
+#define MCAL_TIM_UPDATE_FLAG          (1 << MCAL_TIM_SR_UIF)
+
+
+#define MCAL_TIM_CODE_TO_BASADDR(x)         ( (x == 0)?TIM1:\
+		                                      (x == 1)?TIM2:\
+			                                  (x == 2)?TIM3:\
+						                      (x == 3)?TIM4:\
+								              (x == 4)?TIM5:\
+										      (x == 5)?TIM6:\
+										      (x == 6)?TIM7:\
+										      (x == 7)?TIM8:\
+										      (x == 8)?TIM9:\
+										      (x == 9)?TIM10:\
+										      (x == 10)?TIM11:\
+										      (x == 11)?TIM12:\
+										      (x == 12)?TIM13:\
+										      (x == 13)?TIM14:0)
+
+//advanced control timers need the main output enable
+#define MCAL_TIM_IS_ADVANCED(pTIMx)         ((pTIMx) == TIM1 || (pTIMx) == TIM8)
+
+
+void MCAL_TIM_Enable(TIM_RegDef_t *pTIMx);
+void MCAL_TIM_Disable(TIM_RegDef_t *pTIMx);
+void MCAL_TIM_SetPrescaler(TIM_RegDef_t *pTIMx, u16 Prescaler);
+void MCAL_TIM_SetAutoReload(TIM_RegDef_t *pTIMx, u32 AutoReload);
+void MCAL_TIM_EnableAutoReloadPreload(TIM_RegDef_t *pTIMx);
+void MCAL_TIM_SetCounter(TIM_RegDef_t *pTIMx, u32 Counter);
+void MCAL_TIM_GenerateUpdate(TIM_RegDef_t *pTIMx);
+
+void MCAL_TIM_EnableUpdateInterrupt(TIM_RegDef_t *pTIMx);
+void MCAL_TIM_DisableUpdateInterrupt(TIM_RegDef_t *pTIMx);
+void MCAL_TIM_EnableUpdateDMA(TIM_RegDef_t *pTIMx);
+void MCAL_TIM_DisableUpdateDMA(TIM_RegDef_t *pTIMx);
+
+u8 MCAL_TIM_GetFlagStatus(TIM_RegDef_t *pTIMx, u32 FlagName);
+void MCAL_TIM_ClearFlag(TIM_RegDef_t *pTIMx, u32 FlagName);
+
+/*
+ * Output compare, Channel is 0..3
+ */
+void MCAL_TIM_SetOutputCompareMode(TIM_RegDef_t *pTIMx, u8 Channel, u8 Mode);
+void MCAL_TIM_SetOutputPolarity(TIM_RegDef_t *pTIMx, u8 Channel, u8 Polarity);
+void MCAL_TIM_SetCompare(TIM_RegDef_t *pTIMx, u8 Channel, u32 Compare);
+void MCAL_TIM_EnableChannel(TIM_RegDef_t *pTIMx, u8 Channel);
+void MCAL_TIM_DisableChannel(TIM_RegDef_t *pTIMx, u8 Channel);
+void MCAL_TIM_EnableMainOutput(TIM_RegDef_t *pTIMx);
+void MCAL_TIM_DisableMainOutput(TIM_RegDef_t *pTIMx);
+
+#endif /* STM32F407X_MCAL_INC_STM32F407X_TIM_H_ */
@@ -0,0 +1,187 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : stm32f407x_dma.c
+ * @author         : Rezk Ahmed
+ * @Layer          : MCAL
+ * @brief          : Ensure that all hardware information is gathered and abstracted
+ *                   from the drivers layer (ECU or Board layer), and provide higher
+ *                   layer APIs with access and control over the peripheral drivers.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+#include "stm32f407x_dma.h"
+
+/*
+ * position of each stream flags group inside LISR/HISR (same layout for LIFCR/HIFCR),
+ * streams 4..7 reuse the positions of streams 0..3 in the high registers
+ */
+static const u8 DMA_FlagsOffset[4] = {0, 6, 16, 22};
+
+
+void MCAL_DMA_EnableStream(DMA_RegDef_t *pDMAx, u8 Stream)
+{
+	SET_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_EN);
+}
+
+void MCAL_DMA_DisableStream(DMA_RegDef_t *pDMAx, u8 Stream)
+{
+	CLR_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_EN);
+
+	//EN reads back as 1 until the current data transfer is finished
+	while(GET_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_EN));
+}
+
+u8 MCAL_DMA_GetStreamStatus(DMA_RegDef_t *pDMAx, u8 Stream)
+{
+	if(pDMAx->S[Stream].CR & (1 << MCAL_DMA_CR_EN))
+	{
+		return ENABLE;
+	}
+
+	return DISABLE;
+}
+
+void MCAL_DMA_SetChannel(DMA_RegDef_t *pDMAx, u8 Stream, u8 Channel)
+{
+	pDMAx->S[Stream].CR &= ~(0x7 << MCAL_DMA_CR_CHSEL);
+	pDMAx->S[Stream].CR |= ((Channel & 0x7) << MCAL_DMA_CR_CHSEL);
+}
+
+void MCAL_DMA_SetDirection(DMA_RegDef_t *pDMAx, u8 Stream, u8 Direction)
+{
+	pDMAx->S[Stream].CR &= ~(0x3 << MCAL_DMA_CR_DIR);
+	pDMAx->S[Stream].CR |= ((Direction & 0x3) << MCAL_DMA_CR_DIR);
+}
+
+void MCAL_DMA_SetDataSize(DMA_RegDef_t *pDMAx, u8 Stream, u8 PeriphSize, u8 MemSize)
+{
+	pDMAx->S[Stream].CR &= ~((0x3 << MCAL_DMA_CR_PSIZE) | (0x3 << MCAL_DMA_CR_MSIZE));
+	pDMAx->S[Stream].CR |= ((PeriphSize & 0x3) << MCAL_DMA_CR_PSIZE) | ((MemSize & 0x3) << MCAL_DMA_CR_MSIZE);
+}
+
+void MCAL_DMA_SetIncrement(DMA_RegDef_t *pDMAx, u8 Stream, u8 PeriphInc, u8 MemInc)
+{
+	if(PeriphInc == MCAL_DMA_INC_ENABLE)
+	{
+		SET_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_PINC);
+	}
+	else
+	{
+		CLR_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_PINC);
+	}
+
+	if(MemInc == MCAL_DMA_INC_ENABLE)
+	{
+		SET_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_MINC);
+	}
+	else
+	{
+		CLR_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_MINC);
+	}
+}
+
+void MCAL_DMA_SetMode(DMA_RegDef_t *pDMAx, u8 Stream, u8 Mode)
+{
+	if(Mode == MCAL_DMA_MODE_NORMAL)
+	{
+		CLR_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_CIRC);
+		CLR_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_DBM);
+	}
+	else if(Mode == MCAL_DMA_MODE_CIRCULAR)
+	{
+		SET_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_CIRC);
+		CLR_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_DBM);
+	}
+	else if(Mode == MCAL_DMA_MODE_DOUBLE_BUFFER)
+	{
+		//double buffer mode implies circular mode, start with memory 0
+		SET_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_CIRC);
+		SET_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_DBM);
+		CLR_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_CT);
+	}
+}
+
+void MCAL_DMA_SetPriority(DMA_RegDef_t *pDMAx, u8 Stream, u8 Priority)
+{
+	pDMAx->S[Stream].CR &= ~(0x3 << MCAL_DMA_CR_PL);
+	pDMAx->S[Stream].CR |= ((Priority & 0x3) << MCAL_DMA_CR_PL);
+}
+
+void MCAL_DMA_SetPeriphAddress(DMA_RegDef_t *pDMAx, u8 Stream, u32 Address)
+{
+	pDMAx->S[Stream].PAR = Address;
+}
+
+void MCAL_DMA_SetMemoryAddress(DMA_RegDef_t *pDMAx, u8 Stream, u8 Target, u32 Address)
+{
+	if(Target == 0)
+	{
+		pDMAx->S[Stream].M0AR = Address;
+	}
+	else
+	{
+		pDMAx->S[Stream].M1AR = Address;
+	}
+}
+
+void MCAL_DMA_SetDataCounter(DMA_RegDef_t *pDMAx, u8 Stream, u16 Count)
+{
+	pDMAx->S[Stream].NDTR = Count;
+}
+
+u16 MCAL_DMA_GetDataCounter(DMA_RegDef_t *pDMAx, u8 Stream)
+{
+	return (u16)pDMAx->S[Stream].NDTR;
+}
+
+u8 MCAL_DMA_GetCurrentTarget(DMA_RegDef_t *pDMAx, u8 Stream)
+{
+	return GET_BIT(pDMAx->S[Stream].CR,MCAL_DMA_CR_CT);
+}
+
+void MCAL_DMA_InterruptControl(DMA_RegDef_t *pDMAx, u8 Stream, u8 InterruptName, u8 EnOrDi)
+{
+	if(EnOrDi == ENABLE)
+	{
+		BB_SET_BIT(pDMAx->S[Stream].CR,InterruptName);
+	}
+	else
+	{
+		BB_CLR_BIT(pDMAx->S[Stream].CR,InterruptName);
+	}
+}
+
+u8 MCAL_DMA_GetFlags(DMA_RegDef_t *pDMAx, u8 Stream)
+{
+	u32 Local_u32ISR;
+
+	if(Stream < 4)
+	{
+		Local_u32ISR = pDMAx->LISR;
+	}
+	else
+	{
+		Local_u32ISR = pDMAx->HISR;
+	}
+
+	return (u8)((Local_u32ISR >> DMA_FlagsOffset[Stream % 4]) & MCAL_DMA_FLAG_ALL);
+}
+
+void MCAL_DMA_ClearFlags(DMA_RegDef_t *pDMAx, u8 Stream, u8 Flags)
+{
+	//write 1 to clear, other streams are not affected
+	if(Stream < 4)
+	{
+		pDMAx->LIFCR = ((u32)(Flags & MCAL_DMA_FLAG_ALL) << DMA_FlagsOffset[Stream % 4]);
+	}
+	else
+	{
+		pDMAx->HIFCR = ((u32)(Flags & MCAL_DMA_FLAG_ALL) << DMA_FlagsOffset[Stream % 4]);
+	}
+}
@@ -17,20 +17,23 @@
 
 void (*EXTI_CallBack[16])(void) = {NULL};
 
+static u32 EXTI_HitCount[16] = {0};
+
+static void MCAL_EXTI_Dispatch(u32 LinesMask);
+
+GPIO_RegDef_t * const MCAL_GPIO_PortBaseAddr[MCAL_GPIO_PORTS_NUM] =
+{
+	GPIOA, GPIOB, GPIOC, GPIOD, GPIOE, GPIOF, GPIOG, GPIOH
+};
+
 ES_t MCAL_GPIO_SelectPort(u8 Copy_enuGPIOPort,GPIO_RegDef_t** GPIO_BaseAddr)
 {
 	ES_t errorState = ES_NOT_OK;
 
-	switch(Copy_enuGPIOPort)
+	if(Copy_enuGPIOPort < MCAL_GPIO_PORTS_NUM)
 	{
-	case MCAL_GPIO_PORTA : *GPIO_BaseAddr = GPIOA; errorState = ES_OK; break;
-	case MCAL_GPIO_PORTB : *GPIO_BaseAddr = GPIOB; errorState = ES_OK; break;
-	case MCAL_GPIO_PORTC : *GPIO_BaseAddr = GPIOC; errorState = ES_OK; break;
-	case MCAL_GPIO_PORTD : *GPIO_BaseAddr = GPIOD; errorState = ES_OK; break;
-	case MCAL_GPIO_PORTE : *GPIO_BaseAddr = GPIOE; errorState = ES_OK; break;
-	case MCAL_GPIO_PORTF : *GPIO_BaseAddr = GPIOF; errorState = ES_OK; break;
-	case MCAL_GPIO_PORTG : *GPIO_BaseAddr = GPIOG; errorState = ES_OK; break;
-	case MCAL_GPIO_PORTH : *GPIO_BaseAddr = GPIOH; errorState = ES_OK; break;
+		*GPIO_BaseAddr = MCAL_GPIO_CODE_TO_BASADDR(Copy_enuGPIOPort);
+		errorState = ES_OK;
 	}
 	return errorState;
 }
@@ -108,8 +111,15 @@ ES_t MCAL_GPIO_WritePin(GPIO_RegDef_t *GPIO_BaseAddr, u8 PinNum,u8 Value)
 {
 	ES_t errorState = ES_NOT_OK;
 
-	GPIO_BaseAddr->ODR &= ~(1 << PinNum);
-	GPIO_BaseAddr->ODR |= (Value << PinNum);
+	//BSRR: low half sets, high half resets, one store and no other pin is touched
+	if(Value)
+	{
+		GPIO_BaseAddr->BSRR = (1UL << PinNum);
+	}
+	else
+	{
+		GPIO_BaseAddr->BSRR = (1UL << (PinNum + 16));
+	}
 
 	errorState = ES_OK;
 
@@ -131,7 +141,67 @@ ES_t MCAL_GPIO_TogglePin(GPIO_RegDef_t *GPIO_BaseAddr, u8 PinNum)
 {
 	ES_t errorState = ES_NOT_OK;
 
-	TOG_BIT(GPIO_BaseAddr->ODR, PinNum);
+	//the new level goes through BSRR, an ISR writing another pin of the port in between is not undone
+	if(GET_BIT(GPIO_BaseAddr->ODR, PinNum))
+	{
+		GPIO_BaseAddr->BSRR = (1UL << (PinNum + 16));
+	}
+	else
+	{
+		GPIO_BaseAddr->BSRR = (1UL << PinNum);
+	}
+	errorState = ES_OK;
+
+	return errorState;
+}
+
+
+ES_t MCAL_GPIO_ConfigPort(GPIO_RegDef_t *GPIO_BaseAddr, const GPIO_PortRegCfg_t *PortCfg)
+{
+	ES_t errorState = ES_NOT_OK;
+
+	//output type, speed, pull and alternate function are in place before the mode switches the pins,
+	//a pin never drives with a stale configuration
+	GPIO_BaseAddr->OTYPER = (GPIO_BaseAddr->OTYPER & ~(u32)PortCfg->OTypeMask) | PortCfg->OTypeValue;
+	GPIO_BaseAddr->OSPEEDR = (GPIO_BaseAddr->OSPEEDR & ~PortCfg->SpeedMask) | PortCfg->SpeedValue;
+	GPIO_BaseAddr->PUPDR = (GPIO_BaseAddr->PUPDR & ~PortCfg->PuPdMask) | PortCfg->PuPdValue;
+
+	if(PortCfg->AltFunMask[0] != 0)
+	{
+		GPIO_BaseAddr->AFR[0] = (GPIO_BaseAddr->AFR[0] & ~PortCfg->AltFunMask[0]) | PortCfg->AltFunValue[0];
+	}
+
+	if(PortCfg->AltFunMask[1] != 0)
+	{
+		GPIO_BaseAddr->AFR[1] = (GPIO_BaseAddr->AFR[1] & ~PortCfg->AltFunMask[1]) | PortCfg->AltFunValue[1];
+	}
+
+	GPIO_BaseAddr->MODER = (GPIO_BaseAddr->MODER & ~PortCfg->ModeMask) | PortCfg->ModeValue;
+
+	errorState = ES_OK;
+
+	return errorState;
+}
+
+
+ES_t MCAL_GPIO_WritePortMasked(GPIO_RegDef_t *GPIO_BaseAddr, u16 Mask, u16 Value)
+{
+	ES_t errorState = ES_NOT_OK;
+
+	//set has priority over reset in BSRR, each pin of Mask is in exactly one half
+	GPIO_BaseAddr->BSRR = ((u32)(Mask & (u16)~Value) << 16) | (Mask & Value);
+
+	errorState = ES_OK;
+
+	return errorState;
+}
+
+
+ES_t MCAL_GPIO_ReadPort(GPIO_RegDef_t *GPIO_BaseAddr, u16 *Value)
+{
+	ES_t errorState = ES_NOT_OK;
+
+	*Value = (u16)GPIO_BaseAddr->IDR;
 	errorState = ES_OK;
 
 	return errorState;
@@ -183,7 +253,8 @@ ES_t MCAL_SYSCFG_SellectEXTIChannel(u8 GPIO_Port,u8 PinNum)
 	u8 RNTemp   = PinNum / 4;
 	u8 IndxTemp = PinNum % 4;
 
-	SYSCFG->EXTICR[RNTemp] = GPIO_Port << (IndxTemp * 4);
+	//the other 3 lines of the register keep their port
+	SYSCFG->EXTICR[RNTemp] = (SYSCFG->EXTICR[RNTemp] & ~(0xFUL << (IndxTemp * 4))) | ((u32)GPIO_Port << (IndxTemp * 4));
 
 	errorState = ES_OK;
 
@@ -195,7 +266,7 @@ ES_t MCAL_EXTI_EnableLine(u8 PinNum)
 {
 	ES_t errorState = ES_NOT_OK;
 
-	SET_BIT(EXTI->IMR,PinNum);
+	BB_SET_BIT(EXTI->IMR,PinNum);
 
 	errorState = ES_OK;
 
@@ -207,7 +278,7 @@ ES_t MCAL_EXTI_SetCallBack(u8 Line, void (*callBackFun)(void))
 {
 	ES_t errorState = ES_NOT_OK;
 
-	if(Line <= 16)
+	if(Line < 16)
 	{
 		EXTI_CallBack[Line] = callBackFun;
 		errorState = ES_OK;
@@ -217,184 +288,82 @@ ES_t MCAL_EXTI_SetCallBack(u8 Line, void (*callBackFun)(void))
 }
 
 
+ES_t MCAL_EXTI_GetHitCount(u8 Line, u32 *Count)
+{
+	ES_t errorState = ES_NOT_OK;
+
+	if(Line < 16)
+	{
+		*Count = EXTI_HitCount[Line];
+		errorState = ES_OK;
+	}
+
+	return errorState;
+}
 
-void EXTI0_IRQHandler(void)
+
+/*
+ * One read of PR for all the lines of a vector, CLZ gives the highest pending line at each step.
+ * The handled lines are cleared with one write before their callbacks (PR is write-1-to-clear, the other
+ * lines keep pending), an edge during a callback pends its line again instead of being lost.
+ */
+static void MCAL_EXTI_Dispatch(u32 LinesMask)
 {
-	if (EXTI->PR & (1 << 0))
+	u32 Pending = EXTI->PR & EXTI->IMR & LinesMask;
+	u32 Line;
+
+	EXTI->PR = Pending;
+
+	while(Pending != 0)
 	{
+		Line = 31 - __builtin_clz(Pending);
 
+		Pending &= ~(1UL << Line);
 
-		if (EXTI_CallBack[0] != NULL) // then call the callback function
+		EXTI_HitCount[Line]++;
+
+		if (EXTI_CallBack[Line] != NULL) // then call the callback function
 		{
-			EXTI_CallBack[0]();
+			EXTI_CallBack[Line]();
 		}
-
-		EXTI->PR |= (1 << 0);
 	}
 }
 
-void EXTI1_IRQHandler(void)
-{
-	if (EXTI->PR & (1 << 1))
-	{
 
-		if (EXTI_CallBack[1] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[1]();
-		}
 
-		EXTI->PR |= (1 << 1);
-	}
+void EXTI0_IRQHandler(void)
+{
+	MCAL_EXTI_Dispatch(1UL << 0);
 }
-void EXTI2_IRQHandler(void)
+
+void EXTI1_IRQHandler(void)
 {
-	if (EXTI->PR & (1 << 2))
-	{
+	MCAL_EXTI_Dispatch(1UL << 1);
+}
 
-		if (EXTI_CallBack[2] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[2]();
-		}
-		EXTI->PR |= (1 << 2);
-	}
+void EXTI2_IRQHandler(void)
+{
+	MCAL_EXTI_Dispatch(1UL << 2);
 }
+
 void EXTI3_IRQHandler(void)
 {
-	if (EXTI->PR & (1 << 3))
-	{
-
-		if (EXTI_CallBack[3] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[3]();
-		}
-		EXTI->PR |= (1 << 3);
-	}
+	MCAL_EXTI_Dispatch(1UL << 3);
 }
+
 void EXTI4_IRQHandler(void)
 {
-	if (EXTI->PR & (1 << 4))
-	{
-
-		if (EXTI_CallBack[4] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[4]();
-		}
-
-		EXTI->PR |= (1 << 4);
-	}
+	MCAL_EXTI_Dispatch(1UL << 4);
 }
 
 void EXTI9_5_IRQHandler(void)
 {
-
-	if (EXTI->PR & (1 << 5))
-	{
-
-		if (EXTI_CallBack[5] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[5]();
-		}
-		EXTI->PR |= (1 << 5);
-	}
-
-	if (EXTI->PR & (1 << 6))
-	{
-
-		if (EXTI_CallBack[6] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[6]();
-		}
-		EXTI->PR |= (1 << 6);
-	}
-
-	if (EXTI->PR & (1 << 7))
-	{
-		if (EXTI_CallBack[7] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[7]();
-		}
-		EXTI->PR |= (1 << 7);
-	}
-
-	if (EXTI->PR & (1 << 8))
-	{
-
-		if (EXTI_CallBack[8] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[8]();
-		}
-		EXTI->PR |= (1 << 8);
-	}
-
-	if (EXTI->PR & (1 << 9))
-	{
-
-		if (EXTI_CallBack[9] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[9]();
-		}
-		EXTI->PR |= (1 << 9);
-	}
+	//lines 5 .. 9
+	MCAL_EXTI_Dispatch(0x03E0UL);
 }
 
 void EXTI15_10_IRQHandler(void)
 {
-	if (EXTI->PR & (1 << 10))
-	{
-
-		if (EXTI_CallBack[10] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[10]();
-		}
-		EXTI->PR |= (1 << 10);
-	}
-
-	if (EXTI->PR & (1 << 11))
-	{
-
-		if (EXTI_CallBack[11] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[11]();
-		}
-		EXTI->PR |= (1 << 11);
-	}
-
-	if (EXTI->PR & (1 << 12))
-	{
-
-		if (EXTI_CallBack[12] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[12]();
-		}
-		EXTI->PR |= (1 << 12);
-	}
-
-	if (EXTI->PR & (1 << 13))
-	{
-
-		if (EXTI_CallBack[13] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[13]();
-		}
-		EXTI->PR |= (1 << 13);
-	}
-
-	if (EXTI->PR & (1 << 14))
-	{
-		if (EXTI_CallBack[14] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[14]();
-		}
-		EXTI->PR |= (1 << 14);
-	}
-
-	if (EXTI->PR & (1 << 15))
-	{
-		if (EXTI_CallBack[15] != NULL) // then call the callback function
-		{
-			EXTI_CallBack[15]();
-		}
-		EXTI->PR |= (1 << 15);
-	}
+	//lines 10 .. 15
+	MCAL_EXTI_Dispatch(0xFC00UL);
 }
-
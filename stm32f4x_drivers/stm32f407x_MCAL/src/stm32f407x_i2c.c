@@ -19,6 +19,50 @@
 
 /*************************************** For Initializations **************************************************/
 
+void MCAL_I2C_Enable(I2C_RegDef_t *pI2Cx)
+{
+	SET_BIT(pI2Cx->CR1,MCAL_I2C_CR1_PE);
+}
+
+void MCAL_I2C_Disable(I2C_RegDef_t *pI2Cx)
+{
+	CLR_BIT(pI2Cx->CR1,MCAL_I2C_CR1_PE);
+}
+
+void MCAL_I2C_SoftwareReset(I2C_RegDef_t *pI2Cx)
+{
+	//resets all registers, clears a BUSY flag latched by a glitch on the lines
+	SET_BIT(pI2Cx->CR1,MCAL_I2C_CR1_SWRST);
+	CLR_BIT(pI2Cx->CR1,MCAL_I2C_CR1_SWRST);
+}
+
+void MCAL_I2C_SoftwareResetKeepConfig(I2C_RegDef_t *pI2Cx)
+{
+	//PE, SMBUS, SMBTYPE, ENARP, ENPEC, ENGC, NOSTRETCH, ACK and ALERT
+	u32 Local_u32CR1 = pI2Cx->CR1 & 0x24FB;
+	//FREQ, ITERREN, ITEVTEN, ITBUFEN and DMAEN
+	u32 Local_u32CR2 = pI2Cx->CR2 & 0x0F3F;
+	u32 Local_u32OAR1 = pI2Cx->OAR1;
+	u32 Local_u32OAR2 = pI2Cx->OAR2;
+	u32 Local_u32CCR = pI2Cx->CCR;
+	u32 Local_u32TRISE = pI2Cx->TRISE;
+	u32 Local_u32FLTR = pI2Cx->FLTR;
+
+	MCAL_I2C_SoftwareReset(pI2Cx);
+
+	//CCR and TRISE are written while PE=0
+	pI2Cx->CR2 = Local_u32CR2;
+	pI2Cx->OAR1 = Local_u32OAR1;
+	pI2Cx->OAR2 = Local_u32OAR2;
+	pI2Cx->CCR = Local_u32CCR;
+	pI2Cx->TRISE = Local_u32TRISE;
+	pI2Cx->FLTR = Local_u32FLTR;
+
+	//ACK is cleared by hardware while PE=0, it is written once the peripheral is enabled
+	pI2Cx->CR1 = Local_u32CR1 & ~(1UL << MCAL_I2C_CR1_ACK);
+	pI2Cx->CR1 = Local_u32CR1;
+}
+
 void MCAL_I2C_AckBitControl(I2C_RegDef_t *pI2Cx,u8 AckEnOrDi)
 {
 	if(AckEnOrDi == MCAL_I2C_ACK_ENABLE)
@@ -39,13 +83,34 @@ void MCAL_I2c_SetFreqFeild(I2C_RegDef_t *pI2Cx, u32 APB1Freq)
 	pI2Cx->CR2 |=  (tempreg & 0x3F);
 }
 
-void MCAL_I2C_SetDeviceOwnAddress(I2C_RegDef_t *pI2Cx,u8 DeviceAddress)
+void MCAL_I2C_SetDeviceOwnAddress(I2C_RegDef_t *pI2Cx,u16 DeviceAddress, u8 AddrMode)
 {
 	//program the device own address
+	//Note: bit 14 must be kept at 1 by software
 	u32 tempreg = 0;
-	tempreg |= DeviceAddress << 1;
+	if(AddrMode == MCAL_I2C_ADDMODE_10BITS)
+	{
+		tempreg |= (DeviceAddress & 0x3FF) << MCAL_I2C_OAR1_ADD0;
+		tempreg |= ( 1 << MCAL_I2C_OAR1_ADDMODE);
+	}
+	else
+	{
+		tempreg |= (DeviceAddress & 0x7F) << MCAL_I2C_OAR1_ADD71;
+	}
 	tempreg |= ( 1 << 14);
-	pI2Cx->OAR1 |= tempreg;
+	pI2Cx->OAR1 = tempreg;
+}
+
+void MCAL_I2C_SetDualAddress(I2C_RegDef_t *pI2Cx, u8 DeviceAddress2)
+{
+	//second 7 bits address, only acknowledged while the own address is 7 bits, 0 disables it
+	u32 tempreg = 0;
+	if(DeviceAddress2 != 0)
+	{
+		tempreg |= (DeviceAddress2 & 0x7F) << MCAL_I2C_OAR2_ADD2;
+		tempreg |= ( 1 << MCAL_I2C_OAR2_ENDUAL);
+	}
+	pI2Cx->OAR2 = tempreg;
 }
 
 void MCAL_I2C_SetClockControl(I2C_RegDef_t *pI2Cx,u32 APB1Freq,u32 Speed, u8 FMDutyCycle)
@@ -136,6 +201,27 @@ void MCAL_I2C_GenerateStopCondition(I2C_RegDef_t *pI2Cx)
 	pI2Cx->CR1 |= ( 1 << MCAL_I2C_CR1_STOP);
 }
 
+u8 MCAL_I2C_GetStopStatus(I2C_RegDef_t *pI2Cx)
+{
+	//STOP is cleared by hardware once the stop condition is on the bus,
+	//CR1 must not be written while it is pending
+	return GET_BIT(pI2Cx->CR1,MCAL_I2C_CR1_STOP);
+}
+
+u8 MCAL_I2C_GetBusBusy(I2C_RegDef_t *pI2Cx)
+{
+	//set on START / SDA or SCL low, cleared on STOP, whoever drives the bus
+	//Note: SR2 read after SR1 clears ADDR
+	return GET_BIT(pI2Cx->SR2,MCAL_I2C_SR2_BUSY);
+}
+
+u8 MCAL_I2C_GetMasterStatus(I2C_RegDef_t *pI2Cx)
+{
+	//set on START, cleared once STOP is on the bus or arbitration is lost
+	//Note: SR2 read after SR1 clears ADDR
+	return GET_BIT(pI2Cx->SR2,MCAL_I2C_SR2_MSL);
+}
+
 void MCAL_I2C_ExecuteAddressPhaseWrite(I2C_RegDef_t *pI2Cx, u8 SlaveAddr)
 {
 	SlaveAddr = SlaveAddr << 1;
@@ -150,6 +236,17 @@ void MCAL_I2C_ExecuteAddressPhaseRead(I2C_RegDef_t *pI2Cx, u8 SlaveAddr)
 	pI2Cx->DR = SlaveAddr;
 }
 
+void MCAL_I2C_ExecuteAddressHeader10Bits(I2C_RegDef_t *pI2Cx, u16 SlaveAddr, u8 Read)
+{
+	//11110 A9 A8 r/nw
+	pI2Cx->DR = 0xF0 | ((SlaveAddr >> 7) & 0x06) | (Read & 1);
+}
+
+void MCAL_I2C_ExecuteAddressLow10Bits(I2C_RegDef_t *pI2Cx, u16 SlaveAddr)
+{
+	pI2Cx->DR = SlaveAddr & 0xFF;
+}
+
 u8 MCAL_I2C_GetFlagStatus(I2C_RegDef_t *pI2Cx, u32 FlagName)
 {
 	if(pI2Cx->SR1 & FlagName)
@@ -168,11 +265,11 @@ void MCAL_I2C_InterruptControl(I2C_RegDef_t *pI2Cx, u8 InterruptName, u8 EnOrDi)
 {
 	if(EnOrDi == ENABLE)
 	{
-		SET_BIT(pI2Cx->CR2,InterruptName);
+		BB_SET_BIT(pI2Cx->CR2,InterruptName);
 	}
 	else
 	{
-		CLR_BIT(pI2Cx->CR2,InterruptName);
+		BB_CLR_BIT(pI2Cx->CR2,InterruptName);
 	}
 }
 
@@ -220,4 +317,102 @@ u8 MCAL_I2C_GetTransceiverMode(I2C_RegDef_t *pI2Cx)
 	return MCAL_I2C_RECEIVER;
 }
 
+u8 MCAL_I2C_GetDualFlag(I2C_RegDef_t *pI2Cx)
+{
+	//set when the slave matched OAR2, valid from ADDR until STOP / repeated START
+	//Note: SR2 read after SR1 clears ADDR
+	return GET_BIT(pI2Cx->SR2,MCAL_I2C_SR2_DUALF);
+}
+
 
+
+void MCAL_I2C_DMAControl(I2C_RegDef_t *pI2Cx, u8 EnOrDi)
+{
+	if(EnOrDi == ENABLE)
+	{
+		SET_BIT(pI2Cx->CR2,MCAL_I2C_CR2_DMAEN);
+	}
+	else
+	{
+		CLR_BIT(pI2Cx->CR2,MCAL_I2C_CR2_DMAEN);
+	}
+}
+
+void MCAL_I2C_LastTransferControl(I2C_RegDef_t *pI2Cx, u8 EnOrDi)
+{
+	if(EnOrDi == ENABLE)
+	{
+		SET_BIT(pI2Cx->CR2,MCAL_I2C_CR2_LAST);
+	}
+	else
+	{
+		CLR_BIT(pI2Cx->CR2,MCAL_I2C_CR2_LAST);
+	}
+}
+
+u32 MCAL_I2C_GetDataRegAddress(I2C_RegDef_t *pI2Cx)
+{
+	return (u32)&pI2Cx->DR;
+}
+
+
+void MCAL_I2C_SetBusMode(I2C_RegDef_t *pI2Cx, u8 Mode)
+{
+	if(Mode == MCAL_I2C_MODE_I2C)
+	{
+		CLR_BIT(pI2Cx->CR1,MCAL_I2C_CR1_SMBUS);
+		CLR_BIT(pI2Cx->CR1,MCAL_I2C_CR1_SMBTYPE);
+	}
+	else if(Mode == MCAL_I2C_MODE_SMBUS_DEVICE)
+	{
+		SET_BIT(pI2Cx->CR1,MCAL_I2C_CR1_SMBUS);
+		CLR_BIT(pI2Cx->CR1,MCAL_I2C_CR1_SMBTYPE);
+	}
+	else
+	{
+		SET_BIT(pI2Cx->CR1,MCAL_I2C_CR1_SMBUS);
+		SET_BIT(pI2Cx->CR1,MCAL_I2C_CR1_SMBTYPE);
+	}
+}
+
+void MCAL_I2C_PECControl(I2C_RegDef_t *pI2Cx, u8 EnOrDi)
+{
+	if(EnOrDi == ENABLE)
+	{
+		SET_BIT(pI2Cx->CR1,MCAL_I2C_CR1_ENPEC);
+	}
+	else
+	{
+		CLR_BIT(pI2Cx->CR1,MCAL_I2C_CR1_ENPEC);
+	}
+}
+
+void MCAL_I2C_TransferPEC(I2C_RegDef_t *pI2Cx)
+{
+	//cleared by hardware once the PEC is transferred
+	SET_BIT(pI2Cx->CR1,MCAL_I2C_CR1_PEC);
+}
+
+void MCAL_I2C_AlertControl(I2C_RegDef_t *pI2Cx, u8 EnOrDi)
+{
+	if(EnOrDi == ENABLE)
+	{
+		SET_BIT(pI2Cx->CR1,MCAL_I2C_CR1_ALERT);
+	}
+	else
+	{
+		CLR_BIT(pI2Cx->CR1,MCAL_I2C_CR1_ALERT);
+	}
+}
+
+void MCAL_I2C_ClockStretchControl(I2C_RegDef_t *pI2Cx, u8 EnOrDi)
+{
+	if(EnOrDi == ENABLE)
+	{
+		CLR_BIT(pI2Cx->CR1,MCAL_I2C_CR1_NOSTRETCH);
+	}
+	else
+	{
+		SET_BIT(pI2Cx->CR1,MCAL_I2C_CR1_NOSTRETCH);
+	}
+}
@@ -376,6 +376,39 @@ ES_t MCAL_RCC_GetSysClkValue(u32 *SysClkValue)
 }
 
 
+ES_t MCAL_RCC_GetAHBValue(u32 *AHBValue)
+{
+	ES_t errorState = ES_NOT_OK;
+
+	u32 SystemClk;
+
+	u8 Temp;
+	u16 AHBPrescaler;
+
+	if(MCAL_RCC_GetSysClkValue(&SystemClk) != ES_OK)
+	{
+		return errorState;
+	}
+
+	//for AHB pre-scaler
+	Temp = ((RCC->CFGR >> 4 ) & 0xF);
+
+	if(Temp < 8)
+	{
+		AHBPrescaler = 1;
+	}
+	else
+	{
+		AHBPrescaler = AHB_PreScaler[Temp-8];
+	}
+
+	*AHBValue = SystemClk / AHBPrescaler;
+	errorState = ES_OK;
+
+	return errorState;
+}
+
+
 ES_t MCAL_RCC_GetSysClkType(u8 *SysClkType)
 {
 	ES_t errorState = ES_NOT_OK;
@@ -404,6 +437,59 @@ ES_t MCAL_RCC_GetSysClkType(u8 *SysClkType)
 }
 
 
+ES_t MCAL_RCC_GetPLLInputValue(u32 *PLLInputValue)
+{
+	ES_t errorState = ES_NOT_OK;
+
+	u32 SourceClk;
+	u8 PLLM = ((RCC->PLLCFGR >> RCC_PLLCFGR_PLLM) & 0x3F);
+
+	if(GET_BIT(RCC->PLLCFGR,RCC_PLLCFGR_PLLSRC))
+	{
+		SourceClk = 8000000; //HSE
+	}
+	else
+	{
+		SourceClk = 16000000; //HSI
+	}
+
+	// PLLM = 0 or 1 is a wrong configuration
+	if(PLLM >= 2)
+	{
+		*PLLInputValue = SourceClk / PLLM;
+		errorState = ES_OK;
+	}
+
+	return errorState;
+}
+
+
+ES_t MCAL_RCC_ConfigPLLI2S(u16 PLLI2SN, u8 PLLI2SR)
+{
+	ES_t errorState = ES_NOT_OK;
+
+	if( (PLLI2SN >= MCAL_RCC_PLLI2SN_MIN) && (PLLI2SN <= MCAL_RCC_PLLI2SN_MAX) &&
+		(PLLI2SR >= MCAL_RCC_PLLI2SR_MIN) && (PLLI2SR <= MCAL_RCC_PLLI2SR_MAX) )
+	{
+		// PLLI2S can be configured only while it is off
+		CLR_BIT(RCC->CR,RCC_CR_PLL2SON);
+		while(GET_BIT(RCC->CR,RCC_CR_PLL2SRDY));
+
+		RCC->PLLI2SCFGR = ((u32)PLLI2SN << RCC_PLLI2SCFGR_PLLI2SN) | ((u32)PLLI2SR << RCC_PLLI2SCFGR_PLLI2SR);
+
+		// I2S clock source is PLLI2S
+		CLR_BIT(RCC->CFGR,RCC_CFGR_I2SSRC);
+
+		SET_BIT(RCC->CR,RCC_CR_PLL2SON);
+		while(! GET_BIT(RCC->CR,RCC_CR_PLL2SRDY));
+
+		errorState = ES_OK;
+	}
+
+	return errorState;
+}
+
+
 
 /****************************************** static functions ********************************************/
 
@@ -27,6 +27,11 @@ void MCAL_PSI_Disable(SPI_RegDef_t *pPSIx)
 	CLR_BIT(pPSIx->CR1,MCAL_SPI_CR1_SPE);
 }
 
+u8 MCAL_SPI_GetEnableStatus(SPI_RegDef_t *pPSIx)
+{
+	return GET_BIT(pPSIx->CR1,MCAL_SPI_CR1_SPE);
+}
+
 void MCAL_SPI_SetDeviceMode(SPI_RegDef_t *pPSIx, u8 DeviceMode)
 {
 	if(DeviceMode == MCAL_SPI_DEVICE_MODE_MASTER)
@@ -59,7 +64,8 @@ void MCAL_SPI_SetBusConfig(SPI_RegDef_t *pPSIx, u8 BusConfig)
 void MCAL_SPI_SetClkSpeed(SPI_RegDef_t *pPSIx, u8 SclkSpeed)
 {
 	SclkSpeed &= 0x7;
-	pPSIx->CR1 |= SclkSpeed << 3 ;
+	pPSIx->CR1 &= ~(0x7 << MCAL_SPI_CR1_BR);
+	pPSIx->CR1 |= SclkSpeed << MCAL_SPI_CR1_BR ;
 }
 
 
@@ -100,6 +106,23 @@ void MCAL_SPI_SetCPHA(SPI_RegDef_t *pPSIx, u8 CPHA)
 }
 
 
+void MCAL_SPI_SetBidiOutput(SPI_RegDef_t *pPSIx, u8 EnOrDi)
+{
+	if(EnOrDi == ENABLE)
+	{
+		SET_BIT(pPSIx->CR1,MCAL_SPI_CR1_BIDIOE);
+	}
+	else
+	{
+		CLR_BIT(pPSIx->CR1,MCAL_SPI_CR1_BIDIOE);
+	}
+}
+
+u8 MCAL_SPI_GetClkSpeed(SPI_RegDef_t *pPSIx)
+{
+	return (u8)((pPSIx->CR1 >> MCAL_SPI_CR1_BR) & 0x7);
+}
+
 
 void MCAL_SPI_Write(SPI_RegDef_t *pPSIx, u16 Data)
 {
@@ -117,23 +140,33 @@ void MCAL_SPI_EnableTxInterrupt(SPI_RegDef_t *pPSIx)
 	if(pPSIx == NULL)
 		return;
 
-	SET_BIT(pPSIx->CR2,MCAL_SPI_CR2_TXEIE);
+	BB_SET_BIT(pPSIx->CR2,MCAL_SPI_CR2_TXEIE);
 }
 
 void MCAL_SPI_DisableTxInterrupt(SPI_RegDef_t *pPSIx)
 {
-	CLR_BIT(pPSIx->CR2,MCAL_SPI_CR2_TXEIE);
+	BB_CLR_BIT(pPSIx->CR2,MCAL_SPI_CR2_TXEIE);
 }
 
 
 void MCAL_SPI_EnableRxInterrupt(SPI_RegDef_t *pPSIx)
 {
-	CLR_BIT(pPSIx->CR2,MCAL_SPI_CR2_RXNEIE);
+	BB_SET_BIT(pPSIx->CR2,MCAL_SPI_CR2_RXNEIE);
 }
 
 void MCAL_SPI_DisableRxInterrupt(SPI_RegDef_t *pPSIx)
 {
-	CLR_BIT(pPSIx->CR2,MCAL_SPI_CR2_RXNEIE);
+	BB_CLR_BIT(pPSIx->CR2,MCAL_SPI_CR2_RXNEIE);
+}
+
+void MCAL_SPI_EnableErrInterrupt(SPI_RegDef_t *pPSIx)
+{
+	BB_SET_BIT(pPSIx->CR2,MCAL_SPI_CR2_ERRIE);
+}
+
+void MCAL_SPI_DisableErrInterrupt(SPI_RegDef_t *pPSIx)
+{
+	BB_CLR_BIT(pPSIx->CR2,MCAL_SPI_CR2_ERRIE);
 }
 
 
@@ -166,3 +199,117 @@ void MCAL_SPI_ClearOVFLag(SPI_RegDef_t *pSPIx)
 	(void)temp;
 }
 
+void MCAL_SPI_EnableCRC(SPI_RegDef_t *pSPIx)
+{
+	SET_BIT(pSPIx->CR1,MCAL_SPI_CR1_CRCEN);
+}
+
+void MCAL_SPI_DisableCRC(SPI_RegDef_t *pSPIx)
+{
+	CLR_BIT(pSPIx->CR1,MCAL_SPI_CR1_CRCEN);
+}
+
+void MCAL_SPI_SetCRCPolynomial(SPI_RegDef_t *pSPIx, u16 Polynomial)
+{
+	pSPIx->CRCPR = Polynomial;
+}
+
+void MCAL_SPI_ClearCRCErrorFlag(SPI_RegDef_t *pSPIx)
+{
+	//CRCERR is rc_w0
+	CLR_BIT(pSPIx->SR,MCAL_SPI_SR_CRCERR);
+}
+
+
+u32 MCAL_SPI_GetDataRegAddress(SPI_RegDef_t *pSPIx)
+{
+	return (u32)&pSPIx->DR;
+}
+
+void MCAL_SPI_EnableTxDMA(SPI_RegDef_t *pSPIx)
+{
+	SET_BIT(pSPIx->CR2,MCAL_SPI_CR2_TXDMAEN);
+}
+
+void MCAL_SPI_DisableTxDMA(SPI_RegDef_t *pSPIx)
+{
+	CLR_BIT(pSPIx->CR2,MCAL_SPI_CR2_TXDMAEN);
+}
+
+void MCAL_SPI_EnableRxDMA(SPI_RegDef_t *pSPIx)
+{
+	SET_BIT(pSPIx->CR2,MCAL_SPI_CR2_RXDMAEN);
+}
+
+void MCAL_SPI_DisableRxDMA(SPI_RegDef_t *pSPIx)
+{
+	CLR_BIT(pSPIx->CR2,MCAL_SPI_CR2_RXDMAEN);
+}
+
+
+/*************************************** I2S **************************************************/
+
+void MCAL_I2S_Enable(SPI_RegDef_t *pSPIx)
+{
+	SET_BIT(pSPIx->I2SCFGR,MCAL_SPI_I2SCFGR_I2SE);
+}
+
+void MCAL_I2S_Disable(SPI_RegDef_t *pSPIx)
+{
+	CLR_BIT(pSPIx->I2SCFGR,MCAL_SPI_I2SCFGR_I2SE);
+}
+
+void MCAL_I2S_SelectI2SMode(SPI_RegDef_t *pSPIx)
+{
+	SET_BIT(pSPIx->I2SCFGR,MCAL_SPI_I2SCFGR_I2SMOD);
+}
+
+void MCAL_I2S_SetMode(SPI_RegDef_t *pSPIx, u8 Mode)
+{
+	pSPIx->I2SCFGR &= ~(0x3 << MCAL_SPI_I2SCFGR_I2SCFG);
+	pSPIx->I2SCFGR |= ((Mode & 0x3) << MCAL_SPI_I2SCFGR_I2SCFG);
+}
+
+void MCAL_I2S_SetStandard(SPI_RegDef_t *pSPIx, u8 Standard)
+{
+	pSPIx->I2SCFGR &= ~(0x3 << MCAL_SPI_I2SCFGR_I2SSTD);
+	pSPIx->I2SCFGR |= ((Standard & 0x3) << MCAL_SPI_I2SCFGR_I2SSTD);
+}
+
+void MCAL_I2S_SetDataFormat(SPI_RegDef_t *pSPIx, u8 DataLen, u8 ChannelLen)
+{
+	pSPIx->I2SCFGR &= ~(0x3 << MCAL_SPI_I2SCFGR_DATLEN);
+	pSPIx->I2SCFGR |= ((DataLen & 0x3) << MCAL_SPI_I2SCFGR_DATLEN);
+
+	if(ChannelLen == MCAL_I2S_CHLEN_32BITS)
+	{
+		SET_BIT(pSPIx->I2SCFGR,MCAL_SPI_I2SCFGR_CHLEN);
+	}
+	else
+	{
+		CLR_BIT(pSPIx->I2SCFGR,MCAL_SPI_I2SCFGR_CHLEN);
+	}
+}
+
+void MCAL_I2S_SetCPOL(SPI_RegDef_t *pSPIx, u8 CPOL)
+{
+	if(CPOL == MCAL_SPI_CPOL_HIGH)
+	{
+		SET_BIT(pSPIx->I2SCFGR,MCAL_SPI_I2SCFGR_CKPOL);
+	}
+	else
+	{
+		CLR_BIT(pSPIx->I2SCFGR,MCAL_SPI_I2SCFGR_CKPOL);
+	}
+}
+
+void MCAL_I2S_SetPrescaler(SPI_RegDef_t *pSPIx, u8 Div, u8 Odd, u8 MCLKOutput)
+{
+	u32 tempreg = 0;
+
+	tempreg |= ((u32)Div << MCAL_SPI_I2SPR_I2SDIV);
+	tempreg |= ((u32)(Odd & 1) << MCAL_SPI_I2SPR_ODD);
+	tempreg |= ((u32)(MCLKOutput & 1) << MCAL_SPI_I2SPR_MCKOE);
+
+	pSPIx->I2SPR = tempreg;
+}
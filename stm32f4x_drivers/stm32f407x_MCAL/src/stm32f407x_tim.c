@@ -0,0 +1,146 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : stm32f407x_tim.c
+ * @author         : Rezk Ahmed
+ * @Layer          : MCAL
+ * @brief          : Ensure that all hardware information is gathered and abstracted
+ *                   from the drivers layer (ECU or Board layer), and provide higher
+ *                   layer APIs with access and control over the peripheral drivers.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+#include "stm32f407x_tim.h"
+
+
+void MCAL_TIM_Enable(TIM_RegDef_t *pTIMx)
+{
+	SET_BIT(pTIMx->CR1,MCAL_TIM_CR1_CEN);
+}
+
+void MCAL_TIM_Disable(TIM_RegDef_t *pTIMx)
+{
+	CLR_BIT(pTIMx->CR1,MCAL_TIM_CR1_CEN);
+}
+
+void MCAL_TIM_SetPrescaler(TIM_RegDef_t *pTIMx, u16 Prescaler)
+{
+	pTIMx->PSC = Prescaler;
+}
+
+void MCAL_TIM_SetAutoReload(TIM_RegDef_t *pTIMx, u32 AutoReload)
+{
+	pTIMx->ARR = AutoReload;
+}
+
+void MCAL_TIM_EnableAutoReloadPreload(TIM_RegDef_t *pTIMx)
+{
+	SET_BIT(pTIMx->CR1,MCAL_TIM_CR1_ARPE);
+}
+
+void MCAL_TIM_SetCounter(TIM_RegDef_t *pTIMx, u32 Counter)
+{
+	pTIMx->CNT = Counter;
+}
+
+void MCAL_TIM_GenerateUpdate(TIM_RegDef_t *pTIMx)
+{
+	//loads PSC and ARR preload values, UIF is set as well
+	pTIMx->EGR = (1 << MCAL_TIM_EGR_UG);
+}
+
+
+/*
+ * interrupt and DMA control, bit-band stores
+ */
+void MCAL_TIM_EnableUpdateInterrupt(TIM_RegDef_t *pTIMx)
+{
+	BB_SET_BIT(pTIMx->DIER,MCAL_TIM_DIER_UIE);
+}
+
+void MCAL_TIM_DisableUpdateInterrupt(TIM_RegDef_t *pTIMx)
+{
+	BB_CLR_BIT(pTIMx->DIER,MCAL_TIM_DIER_UIE);
+}
+
+void MCAL_TIM_EnableUpdateDMA(TIM_RegDef_t *pTIMx)
+{
+	BB_SET_BIT(pTIMx->DIER,MCAL_TIM_DIER_UDE);
+}
+
+void MCAL_TIM_DisableUpdateDMA(TIM_RegDef_t *pTIMx)
+{
+	BB_CLR_BIT(pTIMx->DIER,MCAL_TIM_DIER_UDE);
+}
+
+
+u8 MCAL_TIM_GetFlagStatus(TIM_RegDef_t *pTIMx, u32 FlagName)
+{
+	if(pTIMx->SR & FlagName)
+	{
+		return SET;
+	}
+
+	return RESET;
+}
+
+void MCAL_TIM_ClearFlag(TIM_RegDef_t *pTIMx, u32 FlagName)
+{
+	//SR flags are rc_w0, writing 1 to the others leaves them untouched
+	pTIMx->SR = ~FlagName;
+}
+
+
+/*
+ * output compare
+ */
+void MCAL_TIM_SetOutputCompareMode(TIM_RegDef_t *pTIMx, u8 Channel, u8 Mode)
+{
+	u8 Local_u8Shift = (Channel & 1) * 8;
+
+	//output mode (CCxS = 0) with compare preload
+	pTIMx->CCMR[Channel >> 1] &= ~(0xFF << Local_u8Shift);
+	pTIMx->CCMR[Channel >> 1] |= (((Mode & 0x7) << MCAL_TIM_CCMR_OCM) | (1 << MCAL_TIM_CCMR_OCPE)) << Local_u8Shift;
+}
+
+void MCAL_TIM_SetOutputPolarity(TIM_RegDef_t *pTIMx, u8 Channel, u8 Polarity)
+{
+	if(Polarity == MCAL_TIM_OCPOLARITY_LOW)
+	{
+		SET_BIT(pTIMx->CCER,(MCAL_TIM_CCER_CCP + (Channel * 4)));
+	}
+	else
+	{
+		CLR_BIT(pTIMx->CCER,(MCAL_TIM_CCER_CCP + (Channel * 4)));
+	}
+}
+
+void MCAL_TIM_SetCompare(TIM_RegDef_t *pTIMx, u8 Channel, u32 Compare)
+{
+	pTIMx->CCR[Channel & 0x3] = Compare;
+}
+
+void MCAL_TIM_EnableChannel(TIM_RegDef_t *pTIMx, u8 Channel)
+{
+	SET_BIT(pTIMx->CCER,(MCAL_TIM_CCER_CCE + (Channel * 4)));
+}
+
+void MCAL_TIM_DisableChannel(TIM_RegDef_t *pTIMx, u8 Channel)
+{
+	CLR_BIT(pTIMx->CCER,(MCAL_TIM_CCER_CCE + (Channel * 4)));
+}
+
+void MCAL_TIM_EnableMainOutput(TIM_RegDef_t *pTIMx)
+{
+	SET_BIT(pTIMx->BDTR,MCAL_TIM_BDTR_MOE);
+}
+
+void MCAL_TIM_DisableMainOutput(TIM_RegDef_t *pTIMx)
+{
+	CLR_BIT(pTIMx->BDTR,MCAL_TIM_BDTR_MOE);
+}
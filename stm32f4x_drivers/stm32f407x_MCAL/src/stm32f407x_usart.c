@@ -86,17 +86,17 @@ void MCAL_USART_SetStopConfig(USART_RegDef_t *pUSARTx,u8 StopBitConfig)
  *
  *
  * interrupt control
- *
+ * (bit-band, an ISR changing another CR1 bit in between is not undone)
  *
  */
 void MCAL_USART_EnableTXEI(USART_RegDef_t *pUSARTx)
 {
-	SET_BIT(pUSARTx->CR1,MCAL_USART_CR1_TXEIE);
+	BB_SET_BIT(pUSARTx->CR1,MCAL_USART_CR1_TXEIE);
 }
 
 void MCAL_USART_DisableTXEI(USART_RegDef_t *pUSARTx)
 {
-	CLR_BIT(pUSARTx->CR1,MCAL_USART_CR1_TXEIE);
+	BB_CLR_BIT(pUSARTx->CR1,MCAL_USART_CR1_TXEIE);
 }
 
 u8 MCAL_USART_ReadTXEI(USART_RegDef_t *pUSARTx)
@@ -106,12 +106,12 @@ u8 MCAL_USART_ReadTXEI(USART_RegDef_t *pUSARTx)
 
 void MCAL_USART_EnableTCI(USART_RegDef_t *pUSARTx)
 {
-	SET_BIT(pUSARTx->CR1,MCAL_USART_CR1_TCIE);
+	BB_SET_BIT(pUSARTx->CR1,MCAL_USART_CR1_TCIE);
 }
 
 void MCAL_USART_DisableTCI(USART_RegDef_t *pUSARTx)
 {
-	CLR_BIT(pUSARTx->CR1,MCAL_USART_CR1_TCIE);
+	BB_CLR_BIT(pUSARTx->CR1,MCAL_USART_CR1_TCIE);
 }
 
 u8 MCAL_USART_ReadTCI(USART_RegDef_t *pUSARTx)
@@ -121,12 +121,12 @@ u8 MCAL_USART_ReadTCI(USART_RegDef_t *pUSARTx)
 
 void MCAL_USART_EnableRXNI(USART_RegDef_t *pUSARTx)
 {
-	SET_BIT(pUSARTx->CR1,MCAL_USART_CR1_RXNEIE);
+	BB_SET_BIT(pUSARTx->CR1,MCAL_USART_CR1_RXNEIE);
 }
 
 void MCAL_USART_DisableRXNI(USART_RegDef_t *pUSARTx)
 {
-	CLR_BIT(pUSARTx->CR1,MCAL_USART_CR1_RXNEIE);
+	BB_CLR_BIT(pUSARTx->CR1,MCAL_USART_CR1_RXNEIE);
 }
 
 
@@ -0,0 +1,177 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : stm32fxxxx_dma.h
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU / Board
+ * @brief          : For control across the entire STM32F4x family,
+ *                   this layer is not aware of specific hardware information
+ *                   such as register addresses.
+ *                   It utilizes all peripherals through MCAL APIs.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef STM32F407X_DRIVERS_INC_STM32F4XXX_DMA_H_
+#define STM32F407X_DRIVERS_INC_STM32F4XXX_DMA_H_
+
+/*
+ * @DMAx
+ */
+typedef enum
+{
+	DMA_1,
+	DMA_2
+}DMA_t;
+
+/*
+ * @DMA_Stream
+ */
+typedef enum
+{
+	DMA_Stream0,
+	DMA_Stream1,
+	DMA_Stream2,
+	DMA_Stream3,
+	DMA_Stream4,
+	DMA_Stream5,
+	DMA_Stream6,
+	DMA_Stream7
+}DMA_Stream_t;
+
+/*
+ * @DMA_Channel
+ */
+typedef enum
+{
+	DMA_Channel0,
+	DMA_Channel1,
+	DMA_Channel2,
+	DMA_Channel3,
+	DMA_Channel4,
+	DMA_Channel5,
+	DMA_Channel6,
+	DMA_Channel7
+}DMA_Channel_t;
+
+/*
+ * @DMA_Direction
+ */
+typedef enum
+{
+	DMA_Dir_PeriphToMem,
+	DMA_Dir_MemToPeriph,
+	DMA_Dir_MemToMem
+}DMA_Direction_t;
+
+/*
+ * @DMA_DataSize
+ */
+typedef enum
+{
+	DMA_DataSize_Byte,
+	DMA_DataSize_HalfWord,
+	DMA_DataSize_Word
+}DMA_DataSize_t;
+
+/*
+ * @DMA_Increment
+ */
+typedef enum
+{
+	DMA_Inc_Disable,
+	DMA_Inc_Enable
+}DMA_IncCtrl_t;
+
+/*
+ * @DMA_Mode
+ */
+typedef enum
+{
+	DMA_Mode_Normal,
+	DMA_Mode_Circular,
+	DMA_Mode_DoubleBuffer
+}DMA_Mode_t;
+
+/*
+ * @DMA_Priority
+ */
+typedef enum
+{
+	DMA_Priority_Low,
+	DMA_Priority_Med,
+	DMA_Priority_High,
+	DMA_Priority_VeryHigh
+}DMA_Priority_t;
+
+typedef enum
+{
+	DMA_Event_HalfTransfer,
+	DMA_Event_TransferComplete,
+	DMA_Event_TransferError,
+	DMA_Event_DirectModeError,
+	DMA_Event_FifoError
+}DMA_Event_t;
+
+/*
+ * bit mask of an event inside the value returned by DMA_enuGetAndClearEvents
+ */
+#define DMA_EVENT_MASK(EVENT)        (1 << (EVENT))
+
+/*
+ *  Configuration structure for DMA stream
+ */
+typedef struct
+{
+	DMA_Channel_t     DMA_Channel;
+	DMA_Direction_t   DMA_Direction;
+	DMA_DataSize_t    DMA_PeriphDataSize;
+	DMA_DataSize_t    DMA_MemDataSize;
+	DMA_IncCtrl_t     DMA_PeriphInc;
+	DMA_IncCtrl_t     DMA_MemInc;
+	DMA_Mode_t        DMA_Mode;
+	DMA_Priority_t    DMA_Priority;
+}DMA_Config_t;
+
+
+/*
+ *Handle structure for DMA stream
+ */
+typedef struct
+{
+	DMA_t             DMAx;
+	DMA_Stream_t      Stream;
+	DMA_Config_t      DMAConfig;
+	void (*CallBackFun)(DMA_Event_t Event);
+}DMA_Handle_t;
+
+
+ES_t DMA_enuInit(DMA_Handle_t *Copy_pstrDMAHandle);
+
+/*
+ * Copy_u32Mem1Addr is only used in double buffer mode
+ * DMA_enuStart runs with all stream interrupts disabled (e.g. request pacing in circular mode)
+ */
+ES_t DMA_enuStart(DMA_Handle_t *Copy_pstrDMAHandle, u32 Copy_u32PeriphAddr,
+		u32 Copy_u32Mem0Addr, u32 Copy_u32Mem1Addr, u16 Copy_u16Len);
+
+ES_t DMA_enuStartIT(DMA_Handle_t *Copy_pstrDMAHandle, u32 Copy_u32PeriphAddr,
+		u32 Copy_u32Mem0Addr, u32 Copy_u32Mem1Addr, u16 Copy_u16Len);
+
+ES_t DMA_enuStop(DMA_Handle_t *Copy_pstrDMAHandle);
+
+ES_t DMA_enuGetRemaining(DMA_Handle_t *Copy_pstrDMAHandle, u16 *Copy_pu16Remaining);
+
+ES_t DMA_enuGetCurrentTarget(DMA_Handle_t *Copy_pstrDMAHandle, u8 *Copy_pu8Target);
+
+ES_t DMA_enuSetMemoryAddress(DMA_Handle_t *Copy_pstrDMAHandle, u8 Copy_u8Target, u32 Copy_u32MemAddr);
+
+/*
+ * For peripheral drivers that own the stream interrupt, returns a mask of DMA_EVENT_MASK(DMA_Event_t)
+ */
+ES_t DMA_enuGetAndClearEvents(DMA_Handle_t *Copy_pstrDMAHandle, u8 *Copy_pu8Events);
+
+void DMA_IRQHandling(DMA_Handle_t *Copy_pstrDMAHandle);
+
+
+#endif /* STM32F407X_DRIVERS_INC_STM32F4XXX_DMA_H_ */
@@ -108,11 +108,32 @@ typedef struct
 }GPIO_Handle_t;
 
 
+/*
+ * Compile-time pin descriptor, port and pin mask of a pin fixed by the board:
+ *     static const GPIO_PinDesc_t LED_GREEN = GPIO_PIN_DESC(GPIO_PORTD, GPIO_PIN12);
+ */
+typedef struct
+{
+	GPIO_Port_t Port;
+	u16         Mask;
+}GPIO_PinDesc_t;
+
+#define GPIO_PIN_DESC(PORT, PIN)            { (PORT), (u16)(1U << (PIN)) }
+
+
 /*
  * Init and De-init
  */
 ES_t GPIO_enuInit(GPIO_Handle_t *Copy_pstrGPIOHandle);
 
+/*
+ * Board pin table, any order and any ports: the pins are grouped by port and each port register
+ * (MODER, OTYPER, OSPEEDR, PUPDR, AFRL, AFRH) is written once, MODER last.
+ * The whole table is checked first, nothing is configured when an entry is out of range (ES_NOT_OK).
+ * A pin listed twice gets its last entry, EXTI pins are made inputs then their lines are configured.
+ */
+ES_t GPIO_enuInitTable(const GPIO_Handle_t *Copy_pstrGPIOTable, u16 Copy_u16Count);
+
 
 /*
  * Data read and write
@@ -123,6 +144,34 @@ ES_t GPIO_enuWriteToOutputPin(GPIO_Port_t Copy_enuGPIOPort,GPIO_Pin_t Copy_enuGP
 
 ES_t GPIO_enuToggleOutputPin(GPIO_Port_t Copy_enuGPIOPort,GPIO_Pin_t Copy_enuGPIOPin);
 
+/*
+ * Parallel buses, one port access each:
+ * - WritePortMasked drives the pins set in Copy_u16Mask to the matching bits of Copy_u16Value
+ *   at once (atomic, the other pins are untouched),
+ * - ReadPort gives the 16 input levels (bit n = pin n).
+ */
+ES_t GPIO_enuWritePortMasked(GPIO_Port_t Copy_enuGPIOPort, u16 Copy_u16Mask, u16 Copy_u16Value);
+
+ES_t GPIO_enuReadPort(GPIO_Port_t Copy_enuGPIOPort, u16 *Copy_pu16Value);
+
+
+/*
+ * Descriptor pin access, no port lookup and no call: with a const descriptor a write is one store to BSRR.
+ * To be used where stm32f407x_gpio_exti.h is included (they expand to the MCAL inline functions),
+ * the descriptor is not checked, the pin must be configured by GPIO_enuInit / GPIO_enuInitTable.
+ */
+#define GPIO_PIN_SET(DESC)                  MCAL_GPIO_SetPinsInline(MCAL_GPIO_CODE_TO_CONST_BASADDR((DESC).Port), (DESC).Mask)
+#define GPIO_PIN_RESET(DESC)                MCAL_GPIO_ResetPinsInline(MCAL_GPIO_CODE_TO_CONST_BASADDR((DESC).Port), (DESC).Mask)
+#define GPIO_PIN_WRITE(DESC, STATE)         MCAL_GPIO_WritePinsInline(MCAL_GPIO_CODE_TO_CONST_BASADDR((DESC).Port), (DESC).Mask, (STATE))
+#define GPIO_PIN_TOGGLE(DESC)               MCAL_GPIO_TogglePinsInline(MCAL_GPIO_CODE_TO_CONST_BASADDR((DESC).Port), (DESC).Mask)
+#define GPIO_PIN_READ(DESC)                 ((GPIO_PinState_t)MCAL_GPIO_ReadPinsInline(MCAL_GPIO_CODE_TO_CONST_BASADDR((DESC).Port), (DESC).Mask))
+
+
+/*
+ * EXTI statistics, interrupts handled on the line of Copy_enuGPIOPin since reset
+ */
+ES_t GPIO_enuGetEXTIHitCount(GPIO_Pin_t Copy_enuGPIOPin, u32 *Copy_pu32Count);
+
 
 
 #endif /* STM32F407X_DRIVERS_INC_STM32F4XXX_GPIO_EXTI_H_ */
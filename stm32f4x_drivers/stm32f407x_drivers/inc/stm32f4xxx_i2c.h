@@ -23,6 +23,46 @@
 #define I2C_SCL_SPEED_FM4K 	400000
 #define I2C_SCL_SPEED_FM2K  200000
 
+/*
+ * Timeouts of the polling APIs are counted in SysTick periodic ticks (SysTick_enuGetTicks),
+ * I2C_TICK_US is the tick period used to budget bus time in I2C_enuGetWorstCaseLatency.
+ */
+#ifndef I2C_TICK_US
+#define I2C_TICK_US                 1000
+#endif
+
+#define I2C_DEFAULT_TIMEOUT_TICKS   25
+
+/*
+ * Arbitration lost retry, backoff window in ticks doubles with every attempt up to this
+ */
+#ifndef I2C_ARLO_MAX_BACKOFF_TICKS
+#define I2C_ARLO_MAX_BACKOFF_TICKS      16
+#endif
+
+/*
+ * Event trace, recorded only when I2C_TRACE_ENABLE is defined at build time,
+ * one record per event handled by I2C_EV_IRQHandling / I2C_ER_IRQHandling (all I2C instances)
+ */
+#ifndef I2C_TRACE_LEN
+#define I2C_TRACE_LEN                   256     //must be a power of 2
+#endif
+
+#define I2C_TRACE_MAGIC                 0x54433249   //"I2CT"
+#define I2C_TRACE_VERSION               1
+
+/*
+ * Target address flag of the master APIs and jobs, I2C_ADDR_10BITS | address selects the 10 bits
+ * header sequence (ADD10 event), plain 7 bits addresses are unchanged
+ */
+#define I2C_ADDR_10BITS                 0x8000
+
+/*
+ * SMBus limits
+ */
+#define I2C_SMBUS_BLOCK_MAX             32
+#define I2C_SMBUS_ALERT_RESPONSE_ADDR   0x0C
+
 /*
  * I2C application states
  */
@@ -30,7 +70,10 @@ typedef enum
 {
 	I2C_Ready,
 	I2C_BusyInRx,
-	I2C_BusyInTx
+	I2C_BusyInTx,
+	I2C_BusyInRxDMA,
+	I2C_BusyInTxDMA,
+	I2C_BusyInSlaveDMA
 }I2C_BusyStete_t;
 
 /*
@@ -52,6 +95,36 @@ typedef enum
 }I2C_FMDutyCycle_t;
 
 
+/*
+ * @I2C_BusMode
+ * in SMBus modes the peripheral also flags SCL held low too long (I2C_Event_ErrorTimeout)
+ */
+typedef enum
+{
+	I2C_Mode_I2C,
+	I2C_Mode_SMBusDevice,
+	I2C_Mode_SMBusHost
+}I2C_BusMode_t;
+
+/*
+ * @I2C_AddressingMode (own address)
+ */
+typedef enum
+{
+	I2C_Addr_7Bits,
+	I2C_Addr_10Bits
+}I2C_AddrMode_t;
+
+/*
+ * @I2C_PEC
+ */
+typedef enum
+{
+	I2C_PEC_Disable,
+	I2C_PEC_Enable
+}I2C_PECCtrl_t;
+
+
 typedef enum
 {
 	I2C_DisableRepStart,
@@ -59,6 +132,16 @@ typedef enum
 }I2C_RepStartCtrl_t;
 
 
+/*
+ * @I2C_MemAddrSize
+ */
+typedef enum
+{
+	I2C_MemAddr_8Bits=1,
+	I2C_MemAddr_16Bits=2
+}I2C_MemAddrSize_t;
+
+
 typedef enum
 {
     I2C_Event_TxComplete,
@@ -71,6 +154,9 @@ typedef enum
     I2C_Event_ErrorTimeout,
     I2C_Event_DataReq,
     I2C_Event_DataRcv,
+    I2C_Event_ErrorDMA,
+    I2C_Event_ErrorPec,
+    I2C_Event_SMBusAlert,
 } I2C_AppEvent_t;
 
 
@@ -81,28 +167,196 @@ typedef enum
 	I2C_3
 }I2C_t;
 
+
+/*
+ * @I2C_TraceEvent
+ */
+typedef enum
+{
+	I2C_Trace_SB,
+	I2C_Trace_ADDR,
+	I2C_Trace_BTF,
+	I2C_Trace_STOPF,
+	I2C_Trace_TXE,
+	I2C_Trace_RXNE,
+	I2C_Trace_BERR,
+	I2C_Trace_ARLO,
+	I2C_Trace_AF,
+	I2C_Trace_OVR,
+	I2C_Trace_TIMEOUT,
+	I2C_Trace_PECERR,
+	I2C_Trace_SMBALERT,
+	I2C_Trace_ADD10
+}I2C_TraceEvent_t;
+
+/*
+ * Dump layout, little endian: one I2C_TraceHeader_t then Count records oldest first.
+ * Cycles is the core cycle counter (CycleFreq Hz) when the event was handled, SR1 the status seen then.
+ */
+typedef struct
+{
+	u32 Magic;
+	u16 Version;
+	u16 RecordSize;
+	u32 Count;
+	u32 Dropped;             //records overwritten before the dump
+	u32 CycleFreq;
+}I2C_TraceHeader_t;
+
+typedef struct
+{
+	u32 Cycles;
+	u8  Event;
+	u8  I2C_ID;
+	u16 SR1;
+}I2C_TraceRecord_t;
+
 typedef struct
 {
 	u32 I2C_SCLSpeed;
-	u8  I2C_DeviceAddress;
+	u16 I2C_DeviceAddress;
+	I2C_AddrMode_t     I2C_AddressingMode;
+	u8                 I2C_DeviceAddress2;   //second 7 bits slave address (OAR2), 0 for none, 7 bits own address only
 	I2C_AckCtrl_t     I2C_AckControl;
 	I2C_FMDutyCycle_t  I2C_FMDutyCycle;
+	u32                I2C_TimeoutTicks;     //longest wait for one bus event, 0 for I2C_DEFAULT_TIMEOUT_TICKS
+	I2C_BusMode_t      I2C_BusMode;
+	I2C_PECCtrl_t      I2C_PEC;              //appended / checked by the IT master transfers
+	u8                 I2C_ArloRetries;      //restarts of an IT transfer that lost arbitration, 0 for none
 
 }I2C_Config_t;
 
 
+/*
+ * Transaction descriptor for the bus job queue, owned by the caller until its callback:
+ * - TxLen bytes are written then, if RxLen > 0, RxLen bytes are read after a repeated START
+ *   (TxLen = 0 gives a plain read),
+ * - jobs run by Priority (higher first) then Deadline (earlier first, 0 for none) then submission order,
+ * - Sr = I2C_EnableRepStart lets the next queued job start with a repeated START instead of STOP + START
+ *   (not for devices that act on STOP, e.g. EEPROM write cycles),
+ * - Result is ES_FUNC_IS_BUSY while queued, ES_OK or ES_NOT_OK (NACK, arbitration lost, bus error, PEC error)
+ *   or ES_TIME_OUT (SMBus timeout, bus recovery) after,
+ * - AddrNack tells an ES_NOT_OK that is the slave address not acknowledged (absent or busy device).
+ */
+typedef struct I2C_Job
+{
+	u16                 SlaveAddr;           //I2C_ADDR_10BITS | address for a 10 bits device
+	u8                  *pTxData;
+	u32                 TxLen;
+	u8                  *pRxData;
+	u32                 RxLen;
+	u8                  Priority;
+	u32                 Deadline;
+	I2C_RepStartCtrl_t  Sr;
+	__vo ES_t           Result;
+	u8                  AddrNack;
+	void (*CallBackFunc)(struct I2C_Job *pJob);
+	struct I2C_Job      *pNext;
+}I2C_Job_t;
+
+
+/*
+ * Start of the running IT transfer, it is restarted from here after a lost arbitration
+ */
+typedef struct
+{
+	u8                *pTxBuffer;
+	u8                *pRxBuffer;
+	u32               TxLen;
+	u32               RxLen;
+	u8                MemAddrLen;
+	u8                MemRead;
+	u8                SMBusBlock;
+	I2C_BusyStete_t   TxRxState;
+}I2C_XferStart_t;
+
+
+/*
+ * Register map of one slave address, [0] own address, [1] dual address
+ */
+typedef struct
+{
+	u8  *pMap;
+	u16 Size;
+	u16 Ptr;
+}I2C_RegMapSlot_t;
+
+
+typedef struct
+{
+	u32 ArbitrationLost;
+	u32 Retries;
+	u32 GiveUps;
+}I2C_ArloStats_t;
+
+
+/*
+ * No-stretch slave statistics
+ * - Overruns: bytes written by the master past the Rx buffer (or before the DMA read DR), they are lost,
+ * - Underruns: bytes read by the master past the Tx buffer (or before the DMA wrote DR), the previous byte is resent.
+ */
+typedef struct
+{
+	u32 Transactions;
+	u32 RxBytes;
+	u16 LastRxLen;
+	u32 Overruns;
+	u32 Underruns;
+}I2C_SlaveStats_t;
+
+
+/*
+ * pSCLPinHandle / pSDAPinHandle are the alternate function (open drain) pin handles of the bus,
+ * they enable the bus recovery (NULL for none), stm32f4xxx_gpio_exti.h must be included first.
+ *
+ * pTxDMAHandle / pRxDMAHandle are only needed for the DMA APIs (stm32f4xxx_dma.h must be included first):
+ * DMAx, Stream and DMA_Channel of the I2Cx_TX / I2Cx_RX requests, the rest is set by the driver.
+ */
 typedef struct
 {
 	I2C_t 	I2C_ID;
 	I2C_Config_t 	I2C_Config;
 	I2C_BusyStete_t		TxRxState;
     I2C_RepStartCtrl_t  Sr;
-	u8 		DevAddr;
+	u16 		DevAddr;
 	u8 		*pTxBuffer;
 	u8 		*pRxBuffer;
 	u32 	TxLen;
 	u32 	RxLen;
     u32     RxSize;
+    u8      Addr10Done;
+    u8      AddrAcked;
+    u8      SlaveDualMatch;
+    u8      MemAddr[2];
+    u8      MemAddrLen;
+    u8      MemAddrIdx;
+    u8      MemRead;
+    u8      PECLen;
+    u8      SMBusBlock;
+    __vo u8 PECError;
+    GPIO_Handle_t *pSCLPinHandle;
+    GPIO_Handle_t *pSDAPinHandle;
+    DMA_Handle_t *pTxDMAHandle;
+    DMA_Handle_t *pRxDMAHandle;
+    I2C_Job_t    *pJobHead;
+    I2C_Job_t    *pCurrentJob;
+    u8           *pRegMap;
+    u16          RegMapSize;
+    u16          RegPtr;
+    u8           RegPtrPending;
+    u16          RegWriteStart;
+    u16          RegWriteLen;
+    void (*RegWriteCallBackFunc)(u16 Start, u16 Len);
+    I2C_RegMapSlot_t RegMapSlot[2];
+    u8           RegMapActive;
+    I2C_XferStart_t XferStart;
+    u8           ArloAttempts;
+    __vo u8      ArloPending;
+    u32          ArloTick;
+    u32          ArloBackoff;
+    u32          ArloSeed;
+    I2C_ArloStats_t ArloStats;
+    I2C_SlaveStats_t SlaveStats;
     void (*CallBackFun)(I2C_AppEvent_t Status);
 }I2C_Handle_t;
 
@@ -114,10 +368,28 @@ ES_t I2C_enuInit(I2C_Handle_t *Copy_pstrI2CHandle);
  * Data Send and Receive Synchronous (Polling mode or blocking)
  */
 ES_t I2C_enuMasterSendData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
-		u8 Copy_u8Len, u8 Copy_u8SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr);
+		u32 Copy_u32Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr);
 
 ES_t I2C_enuMasterReceiveData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
-		u8 Copy_u8Len, u8 Copy_u8SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr);
+		u32 Copy_u32Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr);
+
+/*
+ * Polling APIs return ES_NOT_OK on NACK / arbitration lost / bus error and ES_TIME_OUT when a bus
+ * event does not come within I2C_TimeoutTicks, the bus is then recovered when the pins are given.
+ * They return ES_FUNC_IS_BUSY while another transfer runs, jobs submitted meanwhile start at their end.
+ */
+
+/*
+ * Resets the peripheral (its configuration is kept), then clocks SCL (up to 9 times) through GPIO until
+ * the slave releases SDA and sends a STOP. ES_NOT_OK when SDA stays low.
+ * The running IT / DMA transfer is ended (a job completes with ES_TIME_OUT), the queue and slave modes stay.
+ */
+ES_t I2C_enuBusRecovery(I2C_Handle_t *Copy_pstrI2CHandle);
+
+/*
+ * Upper bound in ticks of a polling transaction of Copy_u32Len bytes, whatever the bus does
+ */
+ES_t I2C_enuGetWorstCaseLatency(I2C_Handle_t *Copy_pstrI2CHandle, u32 Copy_u32Len, u32 *Copy_pu32Ticks);
 
 ES_t I2C_enuSlaveSendData(I2C_t Copy_enuI2CId, u8 Copy_pu8Data);
 ES_t I2C_enuSlaveReceiveData(I2C_t Copy_enuI2CId, u8 *Copy_pu8Data);
@@ -126,10 +398,145 @@ ES_t I2C_enuSlaveReceiveData(I2C_t Copy_enuI2CId, u8 *Copy_pu8Data);
  * Data Send and Receive IT (Asynchronous mode)
  */
 ES_t I2C_enuMasterSendDataIT(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
-		u8 Copy_u8Len, u8 Copy_u8SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr);
+		u32 Copy_u32Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr);
 
 ES_t I2C_enuMasterReceiveDataIT(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
-		u8 Copy_u8Len, u8 Copy_u8SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr);
+		u32 Copy_u32Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr);
+
+
+/*
+ * Register access (IT), the whole transaction runs from the event interrupt:
+ * - MemWrite: START, address+W, register address, data, STOP then I2C_Event_TxComplete,
+ * - MemRead:  START, address+W, register address, repeated START, address+R, data, STOP
+ *             then I2C_Event_RxComplete.
+ * Register addresses are sent MSB first.
+ */
+ES_t I2C_enuMemWriteIT(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u16 Copy_u16MemAddr,
+		I2C_MemAddrSize_t Copy_enuMemAddrSize, u8 *Copy_pu8Data, u32 Copy_u32Len);
+
+ES_t I2C_enuMemReadIT(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u16 Copy_u16MemAddr,
+		I2C_MemAddrSize_t Copy_enuMemAddrSize, u8 *Copy_pu8Data, u32 Copy_u32Len);
+
+
+/*
+ * Bus job queue (IT), jobs are chained from the event interrupt and each one completes
+ * through its own CallBackFunc (CallBackFun of the handle is not called for jobs).
+ * The direct IT / DMA APIs return ES_FUNC_IS_BUSY while a job runs.
+ * A job is not started while the bus is still owned, the STOP of the previous transfer on its way
+ * (about one SCL period) or a transfer ended with I2C_EnableRepStart, it then waits for
+ * I2C_enuArloService: jobs following each other need it called periodically.
+ */
+ES_t I2C_enuSubmitJob(I2C_Handle_t *Copy_pstrI2CHandle, I2C_Job_t *Copy_pstrJob);
+
+
+/*
+ * SMBus (IT), with I2C_PEC_Enable every IT master transfer ends with the PEC:
+ * - written after the last byte sent,
+ * - read after the last byte received and checked by hardware, a mismatch completes the transfer
+ *   with I2C_Event_ErrorPec (ES_NOT_OK for a job), the PEC byte is not stored.
+ * BlockRead: command, repeated START, byte count then up to I2C_SMBUS_BLOCK_MAX bytes, Copy_pu8Data gets
+ *            the count followed by the bytes (I2C_SMBUS_BLOCK_MAX + 1 bytes buffer), I2C_Event_RxComplete.
+ * ProcessCall: command, 2 bytes of Copy_pu8TxData, repeated START, 2 bytes to Copy_pu8RxData
+ *              (low byte first), I2C_Event_RxComplete. Copy_pu8TxData must stay valid until then.
+ */
+ES_t I2C_enuSMBusBlockReadIT(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u8 Copy_u8Command,
+		u8 *Copy_pu8Data);
+
+ES_t I2C_enuSMBusProcessCallIT(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u8 Copy_u8Command,
+		u8 *Copy_pu8TxData, u8 *Copy_pu8RxData);
+
+/*
+ * Host: SMBA low gives I2C_Event_SMBusAlert, the alerting device is read at I2C_SMBUS_ALERT_RESPONSE_ADDR.
+ * Device: drives SMBA low and acknowledges I2C_SMBUS_ALERT_RESPONSE_ADDR until disabled.
+ */
+ES_t I2C_enuSMBusAlertControl(I2C_Handle_t *Copy_pstrI2CHandle, u8 Copy_u8EnOrDi);
+
+
+/*
+ * Multi-master, an IT transfer (direct, register, SMBus or job) that loses arbitration is restarted
+ * up to I2C_ArloRetries times before I2C_Event_ErrorArlo (ES_NOT_OK for a job):
+ * - the restart waits a random backoff of 0 .. 2^attempt - 1 ticks (up to I2C_ARLO_MAX_BACKOFF_TICKS)
+ *   then for the bus to be idle (BUSY clear),
+ * - I2C_enuArloService starts it, to be called periodically (e.g. from the SysTick callback),
+ *   it returns ES_FUNC_IS_IDLE with nothing pending and ES_FUNC_IS_BUSY while waiting,
+ * - it also starts a queued job held back while the bus was still owned (see I2C_enuSubmitJob).
+ * DMA transfers are not restarted.
+ */
+ES_t I2C_enuArloService(I2C_Handle_t *Copy_pstrI2CHandle);
+
+ES_t I2C_enuGetArloStats(I2C_Handle_t *Copy_pstrI2CHandle, I2C_ArloStats_t *Copy_pstrStats);
+
+
+/*
+ * Trace, Start enables the core cycle counter and empties the buffer,
+ * Dump pauses the recording and gives the header then the records through Write (e.g. a UART send),
+ * ES_NOT_OK when the driver is built without I2C_TRACE_ENABLE.
+ */
+ES_t I2C_enuTraceStart(void);
+ES_t I2C_enuTraceStop(void);
+ES_t I2C_enuTraceDump(void (*Write)(const u8 *pData, u32 Len));
+
+
+/*
+ * Slave register map (IT), the device answers from Copy_pu8RegMap without calling the application per byte:
+ * - the first byte of a master write sets the register pointer (modulo Copy_u16Size, up to 256 registers),
+ *   the next bytes are stored from there,
+ * - a master read returns the registers from the pointer,
+ * - the pointer increments after each byte and wraps at the end of the map,
+ * - RegWrite (may be NULL) is called at STOP with the first written register and the count of written bytes
+ *   (the range wraps as the pointer does).
+ * CallBackFun still gets the bus error / overrun events.
+ */
+ES_t I2C_enuSlaveRegMapStart(I2C_Handle_t *Copy_pstrI2CHandle, u8 *Copy_pu8RegMap, u16 Copy_u16Size,
+		void (*RegWrite)(u16 Start, u16 Len));
+
+ES_t I2C_enuSlaveRegMapStop(I2C_Handle_t *Copy_pstrI2CHandle);
+
+/*
+ * Dual address (I2C_DeviceAddress2), the device answers it from its own map and register pointer,
+ * without one both addresses share the map of I2C_enuSlaveRegMapStart. To be set while the bus is idle.
+ * RegWrite gets the writes of both maps, I2C_enuGetSlaveAddrMatch tells them apart.
+ */
+ES_t I2C_enuSlaveRegMapSetDual(I2C_Handle_t *Copy_pstrI2CHandle, u8 *Copy_pu8RegMap, u16 Copy_u16Size);
+
+/*
+ * Address matched by the current / last slave transaction, 0 own address, 1 dual address
+ */
+ES_t I2C_enuGetSlaveAddrMatch(I2C_Handle_t *Copy_pstrI2CHandle, u8 *Copy_pu8Match);
+
+
+/*
+ * No-stretch slave (DMA), SCL is never held so the master runs at full speed:
+ * - every master read gets Copy_pu8TxBuffer from its first byte, preloaded in DR before the address,
+ * - every master write is stored from the start of Copy_pu8RxBuffer, then CallBackFun gets I2C_Event_Stop
+ *   with SlaveStats.LastRxLen bytes received (the buffer is re-armed, copy it before the next write),
+ * - a read must follow a write with STOP, not a repeated START (DR holds the last byte written).
+ * One of the buffers may be NULL (its DMA handle is then not needed), the stream IRQs are not used.
+ * I2C_DeviceAddress must be set, the direct APIs return ES_FUNC_IS_BUSY and jobs stay queued until Stop.
+ */
+ES_t I2C_enuSlaveNoStretchStart(I2C_Handle_t *Copy_pstrI2CHandle, u8 *Copy_pu8TxBuffer, u16 Copy_u16TxLen,
+		u8 *Copy_pu8RxBuffer, u16 Copy_u16RxLen);
+
+ES_t I2C_enuSlaveNoStretchStop(I2C_Handle_t *Copy_pstrI2CHandle);
+
+ES_t I2C_enuGetSlaveStats(I2C_Handle_t *Copy_pstrI2CHandle, I2C_SlaveStats_t *Copy_pstrStats);
+
+
+/*
+ * Data Send and Receive DMA (Asynchronous mode), one interrupt per transfer instead of one per byte:
+ * - I2C_EV_IRQHandling and I2C_ER_IRQHandling handle the start, address and stop phases,
+ * - I2C_DMA_IRQHandling must be called from the TX / RX stream IRQ handlers.
+ */
+ES_t I2C_enuMasterSendDataDMA(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
+		u16 Copy_u16Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr);
+
+ES_t I2C_enuMasterReceiveDataDMA(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
+		u16 Copy_u16Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr);
+
+
+void I2C_EV_IRQHandling(I2C_Handle_t *Copy_pstrI2CHandle);
+void I2C_ER_IRQHandling(I2C_Handle_t *Copy_pstrI2CHandle);
+void I2C_DMA_IRQHandling(I2C_Handle_t *Copy_pstrI2CHandle);
 
 
 void I2C_CloseReceiveData(I2C_Handle_t *Copy_pstrI2CHandle);
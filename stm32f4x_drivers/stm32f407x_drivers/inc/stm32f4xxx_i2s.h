@@ -0,0 +1,149 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : stm32fxxxx_i2s.h
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU / Board
+ * @brief          : For control across the entire STM32F4x family,
+ *                   this layer is not aware of specific hardware information
+ *                   such as register addresses.
+ *                   It utilizes all peripherals through MCAL APIs.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef STM32F407X_DRIVERS_INC_STM32F4XXX_I2S_H_
+#define STM32F407X_DRIVERS_INC_STM32F4XXX_I2S_H_
+
+/*
+ * @I2Sx
+ * I2S is available on SPI2 and SPI3 only, values match @SPIx
+ */
+typedef enum
+{
+	I2S_2 = 1,
+	I2S_3
+}I2S_t;
+
+/*
+ * @I2S_Mode
+ */
+typedef enum
+{
+	I2S_Mode_SlaveTx,
+	I2S_Mode_SlaveRx,
+	I2S_Mode_MasterTx,
+	I2S_Mode_MasterRx
+}I2S_Mode_t;
+
+/*
+ * @I2S_Standard
+ */
+typedef enum
+{
+	I2S_Std_Philips,
+	I2S_Std_MSB,
+	I2S_Std_LSB,
+	I2S_Std_PCM
+}I2S_Standard_t;
+
+/*
+ * @I2S_DataFormat
+ * 16Bits          : 16-bit data in a 16-bit channel
+ * 16BitsExtended  : 16-bit data in a 32-bit channel
+ * 24Bits / 32Bits : 32-bit channel, each sample takes two half-words in the buffer
+ */
+typedef enum
+{
+	I2S_DataFormat_16Bits,
+	I2S_DataFormat_16BitsExtended,
+	I2S_DataFormat_24Bits,
+	I2S_DataFormat_32Bits
+}I2S_DataFormat_t;
+
+/*
+ * @I2S_CPOL
+ */
+typedef enum
+{
+	I2S_CPOL_Low,
+	I2S_CPOL_High
+}I2S_CPOL_t;
+
+/*
+ * @I2S_MCLKOutput
+ */
+typedef enum
+{
+	I2S_MCLKOutput_Disable,
+	I2S_MCLKOutput_Enable
+}I2S_MCLKOutput_t;
+
+typedef enum
+{
+	I2S_Ready,
+	I2S_Busy
+}I2S_BusyState_t;
+
+typedef enum
+{
+	I2S_Event_HalfComplete,
+	I2S_Event_Complete,
+	I2S_Event_Error
+}I2S_Event_t;
+
+/*
+ *  Configuration structure for I2Sx peripheral
+ */
+typedef struct
+{
+	I2S_Mode_t          I2S_Mode;
+	I2S_Standard_t      I2S_Standard;
+	I2S_DataFormat_t    I2S_DataFormat;
+	I2S_CPOL_t          I2S_CPOL;
+	I2S_MCLKOutput_t    I2S_MCLKOutput;
+	u32                 I2S_AudioFreq;
+}I2S_Config_t;
+
+
+/*
+ *Handle structure for I2Sx peripheral
+ * - pDMAHandle must have DMAx, Stream and DMA_Channel set to the stream mapped
+ *   on the I2S request (e.g. SPI2_TX: DMA1 Stream4 Channel0, SPI2_RX: DMA1 Stream3 Channel0),
+ *   the rest of the DMA configuration is done by the I2S driver.
+ */
+typedef struct
+{
+	I2S_t               I2Sx;
+	I2S_Config_t        I2SConfig;
+	DMA_Handle_t        *pDMAHandle;
+	u16                 *pBuffer;
+	u16                 BufferLen;
+	u32                 ActualAudioFreq;
+	I2S_BusyState_t     State;
+	void (*CallBackFun)(I2S_Event_t Event, u16 *pData, u16 Len);
+}I2S_Handle_t;
+
+
+/*
+ * In master modes the PLLI2S is programmed for the requested audio frequency,
+ * note that PLLI2S is shared between I2S2 and I2S3.
+ */
+ES_t I2S_enuInit(I2S_Handle_t *Copy_pstrI2SHandle);
+
+/*
+ * Circular double-buffered streaming, Copy_u16Len is the whole buffer length in half-words.
+ * The callback receives the half that is free to be processed (filled in Rx, to be refilled in Tx).
+ */
+ES_t I2S_enuStartDMA(I2S_Handle_t *Copy_pstrI2SHandle, u16 *Copy_pu16Buffer, u16 Copy_u16Len,
+		void (*CallBack)(I2S_Event_t Event, u16 *pData, u16 Len));
+
+ES_t I2S_enuStop(I2S_Handle_t *Copy_pstrI2SHandle);
+
+/*
+ * To be called from the DMA stream IRQ handler used by the I2S
+ */
+void I2S_DMA_IRQHandling(I2S_Handle_t *Copy_pstrI2SHandle);
+
+
+#endif /* STM32F407X_DRIVERS_INC_STM32F4XXX_I2S_H_ */
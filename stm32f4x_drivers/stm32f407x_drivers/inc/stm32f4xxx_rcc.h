@@ -68,7 +68,9 @@ typedef enum
 	AHB1_GPIOD,
 	AHB1_GPIOE,
 	AHB1_GPIOF,
-	AHB1_GPIOG
+	AHB1_GPIOG,
+	AHB1_DMA1=21,
+	AHB1_DMA2
 
 }RCC_AHB1Periph_t;
 
@@ -81,12 +83,26 @@ typedef enum
 typedef enum
 {
 	APB1_DEMO,
+	APB1_TIM2=0,
+	APB1_TIM3,
+	APB1_TIM4,
+	APB1_TIM5,
+	APB1_TIM6,
+	APB1_TIM7,
+	APB1_TIM12,
+	APB1_TIM13,
+	APB1_TIM14
 
 }RCC_APB1Periph_t;
 
 typedef enum
 {
+	APB2_TIM1=0,
+	APB2_TIM8,
 	APB2_SYSCFG=14,
+	APB2_TIM9=16,
+	APB2_TIM10,
+	APB2_TIM11
 }RCC_APB2Periph_t;
 
 
@@ -141,4 +157,19 @@ ES_t RCC_enuGetSysClkType(RCC_SysClk_t *Copy_penuSysClk);
 
 ES_t RCC_enuGetSysClkValue(u32 *Copy_pu32SysClkValue);
 
+ES_t RCC_enuGetAHBValue(u32 *Copy_pu32AHBValue);
+
+
+/******************************************/
+/***              PLLI2S                ***/
+/******************************************/
+
+/*
+ * PLLI2S input is the main PLL input after the PLLM division (shared with the main PLL)
+ * I2S clock = PLLI2S input * PLLI2SN / PLLI2SR
+ */
+ES_t RCC_enuGetPLLInputValue(u32 *Copy_pu32PLLInputValue);
+
+ES_t RCC_enuConfigPLLI2S(u16 Copy_u16PLLI2SN, u8 Copy_u8PLLI2SR);
+
 #endif /* STM32F407X_DRIVERS_INC_STM32F4XXX_RCC_H_ */
@@ -103,9 +103,22 @@ typedef enum
 {
 	SPI_Ready,
 	SPI_BUSY_InRx,
-	SPI_BUSY_InTx
+	SPI_BUSY_InTx,
+	SPI_BUSY_InStream,
+	SPI_BUSY_InHalfDuplex,
+	SPI_BUSY_InDMA,
+	SPI_BUSY_InTriggeredRx
 }SPI_BusyState_t;
 
+/*
+ * @SPI_XferMode
+ */
+typedef enum
+{
+	SPI_XferMode_IT,
+	SPI_XferMode_DMA
+}SPI_XferMode_t;
+
 /*
  *  Configuration structure for SPIx peripheral
  */
@@ -123,20 +136,34 @@ typedef struct
 
 /*
  *Handle structure for SPIx peripheral
+ * - pTxDMAHandle / pRxDMAHandle are only needed for DMA transfers, they must have DMAx,
+ *   Stream and DMA_Channel set to the stream mapped on the SPI request, the rest of the DMA
+ *   configuration is done by the SPI driver.
+ * - pTrigDMAHandle is set by SPI_enuTriggeredRxStart.
  */
 typedef struct
 {
 	SPI_t      	      SPIx;
 	SPI_Config_t 	  SPIConfig;
+	DMA_Handle_t      *pTxDMAHandle;
+	DMA_Handle_t      *pRxDMAHandle;
+	DMA_Handle_t      *pTrigDMAHandle;
 	u8 	        	  *pTxBuffer;
 	u8 		          *pRxBuffer;
 	u32 		      TxLen;
 	u32 		      RxLen;
 	SPI_BusyState_t   TxState;
 	SPI_BusyState_t   RxState;
+	u8                *pStreamBuffer[2];
+	u32               StreamLen;
+	u32               StreamCount;
+	u8                StreamActiveBuffer;
+	SPI_XferMode_t    HDRxMode;
+	u8                CRCEnabled;
 	void (*TxCallBackFunc)(void);
 	void (*RxCallBackFunc)(void);
 	void (*ErrorCallBackFunc)(void);
+	void (*StreamCallBackFunc)(u8 *pBuffer, u32 Len);
 }SPI_Handle_t;
 
 
@@ -146,6 +173,35 @@ ES_t SPI_enuSendData(SPI_Handle_t *Copy_pstrSPIHandle,u8 *Copy_pu8Data, u32 Copy
 
 ES_t SPI_enuReceiveData(SPI_Handle_t *Copy_pstrSPIHandle,u8 *Copy_pu8Data, u32 Copy_u32Len);
 
+/*
+ * Polling full-duplex transfer for short bursts (a few bytes to a sensor):
+ * - the frame loop is selected once from SPI_DFF and keeps TX one frame ahead of RX.
+ * - Copy_pu8TxData may be NULL (0xFF is sent), Copy_pu8RxData may be NULL (received data is dropped).
+ */
+ES_t SPI_enuTransceiveBurst(SPI_Handle_t *Copy_pstrSPIHandle, u8 *Copy_pu8TxData, u8 *Copy_pu8RxData, u32 Copy_u32Len);
+
+/*
+ * Full-duplex DMA transfer (needs pTxDMAHandle and pRxDMAHandle):
+ * - Copy_pu8TxData may be NULL (0xFF is sent), Copy_pu8RxData may be NULL (received data is dropped).
+ * - at most 65535 frames, CallBack is called from SPI_DMA_IRQHandling once the last frame is received.
+ */
+ES_t SPI_enuTransceiveDMA(SPI_Handle_t *Copy_pstrSPIHandle, u8 *Copy_pu8TxData, u8 *Copy_pu8RxData,
+		u32 Copy_u32Len, void(*CallBack)(void));
+
+/*
+ * Stops a SPI_enuTransceiveDMA transfer (e.g. a slave resynchronizing on NSS), no callback is called
+ */
+ES_t SPI_enuAbortDMA(SPI_Handle_t *Copy_pstrSPIHandle);
+
+/*
+ * Hardware CRC for SPI_enuTransceiveDMA: the CRC (8 or 16 bits as SPI_DFF) is reset before each transfer
+ * and sent after the last frame, the received one is checked and read with SPI_enuGetCRCError.
+ * The CRC frame is read from SPI_IRQHandling which then calls the transfer CallBack.
+ */
+ES_t SPI_enuCRCControl(SPI_Handle_t *Copy_pstrSPIHandle, u16 Copy_u16Polynomial, u8 Copy_u8EnOrDi);
+
+ES_t SPI_enuGetCRCError(SPI_Handle_t *Copy_pstrSPIHandle, u8 *Copy_pu8CRCError);
+
 ES_t SPI_enuSendDataIT(SPI_Handle_t *Copy_pstrSPIHandle,u8 *Copy_pu8Data, u32 Copy_u32Len, void(*CallBack)(void));
 
 ES_t SPI_enuReceiveDataIT(SPI_Handle_t *Copy_pstrSPIHandle,u8 *Copy_pu8Data, u32 Copy_u32Len, void(*CallBack)(void));
@@ -154,6 +210,59 @@ ES_t SPI_enuStopTransmission(SPI_Handle_t *Copy_pstrSPIHandle);
 
 ES_t SPI_enuStopReception(SPI_Handle_t *Copy_pstrSPIHandle);
 
+/*
+ * Switches between 8 and 16 bits frames between transfers (e.g. 8 bits commands then 16 bits pixels),
+ * waits for the bus to be idle, SPE is restored as it was.
+ */
+ES_t SPI_enuSetDataFrameFormat(SPI_Handle_t *Copy_pstrSPIHandle, SPI_DFF_t Copy_enuDFF);
+
+/*
+ * Changes the SCK prescaler between transfers (e.g. slow card identification then full speed)
+ */
+ES_t SPI_enuSetClkSpeed(SPI_Handle_t *Copy_pstrSPIHandle, SPI_SclkSpeed_t Copy_enuSclkSpeed);
+
+/*
+ * Slave streaming mode (ping-pong buffers)
+ * - Reception continues into the other buffer while the filled one is handed to the callback.
+ * - SPI_enuSlaveStreamSwap is meant to be called from the NSS rising edge EXTI callback
+ *   to hand off a partially filled buffer at the end of a master transaction.
+ */
+ES_t SPI_enuSlaveStreamStart(SPI_Handle_t *Copy_pstrSPIHandle, u8 *Copy_pu8Buffer0, u8 *Copy_pu8Buffer1,
+		u32 Copy_u32Len, void(*CallBack)(u8 *pBuffer, u32 Len));
+
+ES_t SPI_enuSlaveStreamSwap(SPI_Handle_t *Copy_pstrSPIHandle);
+
+ES_t SPI_enuSlaveStreamStop(SPI_Handle_t *Copy_pstrSPIHandle);
+
+/*
+ * Externally paced master reception (e.g. one timer update DMA request per sample):
+ * - each request on Copy_pstrTrigDMAHandle writes one dummy frame to the SPI which clocks one frame in,
+ *   so the sample period is set by the request source alone.
+ * - frames fill Copy_pu8Buffer circularly through pRxDMAHandle, CallBack gets each filled half.
+ */
+ES_t SPI_enuTriggeredRxStart(SPI_Handle_t *Copy_pstrSPIHandle, DMA_Handle_t *Copy_pstrTrigDMAHandle,
+		u8 *Copy_pu8Buffer, u32 Copy_u32Len, void(*CallBack)(u8 *pBuffer, u32 Len));
+
+ES_t SPI_enuTriggeredRxStop(SPI_Handle_t *Copy_pstrSPIHandle);
+
+/*
+ * Half-duplex (3-wire, SPI_BusConfig_HD) master transaction:
+ * sends Copy_u32CmdLen bytes, turns the data line around then clocks in exactly
+ * Copy_u32RxLen bytes by IT or DMA, CallBack is called once the last frame is read.
+ * A receive stream that cannot be started ends the transaction through ErrorCallBackFunc instead.
+ */
+ES_t SPI_enuHalfDuplexTransaction(SPI_Handle_t *Copy_pstrSPIHandle, u8 *Copy_pu8Cmd, u32 Copy_u32CmdLen,
+		u8 *Copy_pu8RxData, u32 Copy_u32RxLen, SPI_XferMode_t Copy_enuRxMode, void(*CallBack)(void));
+
+/*
+ * To be called from the DMA stream IRQ handler(s) used by the SPI
+ */
+void SPI_DMA_IRQHandling(SPI_Handle_t *Copy_pstrSPIHandle);
+
+/*
+ * To be called from the SPI IRQ handler, also in stream and DMA modes:
+ * an RX overrun (OVR) is cleared whatever the mode and reported through ErrorCallBackFunc.
+ */
 void SPI_IRQHandling(SPI_Handle_t *Copy_pstrSPIHandle);
 
 
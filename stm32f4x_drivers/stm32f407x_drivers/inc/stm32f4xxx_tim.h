@@ -0,0 +1,120 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : stm32fxxxx_tim.h
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU / Board
+ * @brief          : For control across the entire STM32F4x family,
+ *                   this layer is not aware of specific hardware information
+ *                   such as register addresses.
+ *                   It utilizes all peripherals through MCAL APIs.
+ ******************************************************************************
+ ******************************************************************************
+ */
+
+#ifndef STM32F407X_DRIVERS_INC_STM32F4XXX_TIM_H_
+#define STM32F407X_DRIVERS_INC_STM32F4XXX_TIM_H_
+
+/*
+ * @TIMx
+ */
+typedef enum
+{
+	TIM_1,
+	TIM_2,
+	TIM_3,
+	TIM_4,
+	TIM_5,
+	TIM_6,
+	TIM_7,
+	TIM_8,
+	TIM_9,
+	TIM_10,
+	TIM_11,
+	TIM_12,
+	TIM_13,
+	TIM_14
+}TIM_t;
+
+/*
+ * @TIM_Channel
+ */
+typedef enum
+{
+	TIM_Channel1,
+	TIM_Channel2,
+	TIM_Channel3,
+	TIM_Channel4
+}TIM_Channel_t;
+
+/*
+ * @TIM_OCMode
+ */
+typedef enum
+{
+	TIM_OCMode_Frozen,
+	TIM_OCMode_Active,
+	TIM_OCMode_Inactive,
+	TIM_OCMode_Toggle,
+	TIM_OCMode_ForceInactive,
+	TIM_OCMode_ForceActive,
+	TIM_OCMode_PWM1,
+	TIM_OCMode_PWM2
+}TIM_OCMode_t;
+
+/*
+ * @TIM_OCPolarity
+ */
+typedef enum
+{
+	TIM_OCPolarity_High,
+	TIM_OCPolarity_Low
+}TIM_OCPolarity_t;
+
+
+/*
+ * Counter clock = timer clock / (TIM_Prescaler + 1), update period = TIM_Period + 1 counts
+ * (TIM_Period is 32 bits on TIM2 and TIM5 only)
+ */
+typedef struct
+{
+	u16 TIM_Prescaler;
+	u32 TIM_Period;
+}TIM_Config_t;
+
+
+typedef struct
+{
+	TIM_t            TIMx;
+	TIM_Config_t     TIMConfig;
+	void (*UpdateCallBackFunc)(void);
+}TIM_Handle_t;
+
+
+ES_t TIM_enuInit(TIM_Handle_t *Copy_pstrTIMHandle);
+
+ES_t TIM_enuStart(TIM_Handle_t *Copy_pstrTIMHandle);
+
+ES_t TIM_enuStop(TIM_Handle_t *Copy_pstrTIMHandle);
+
+ES_t TIM_enuStartIT(TIM_Handle_t *Copy_pstrTIMHandle, void (*CallBack)(void));
+
+/*
+ * Output compare / PWM on a channel, Copy_u32Pulse is the compare value in counts
+ */
+ES_t TIM_enuConfigOutputCompare(TIM_Handle_t *Copy_pstrTIMHandle, TIM_Channel_t Copy_enuChannel,
+		TIM_OCMode_t Copy_enuMode, TIM_OCPolarity_t Copy_enuPolarity, u32 Copy_u32Pulse);
+
+ES_t TIM_enuSetCompare(TIM_Handle_t *Copy_pstrTIMHandle, TIM_Channel_t Copy_enuChannel, u32 Copy_u32Pulse);
+
+ES_t TIM_enuDisableOutputCompare(TIM_Handle_t *Copy_pstrTIMHandle, TIM_Channel_t Copy_enuChannel);
+
+/*
+ * DMA request on each update event, the DMA stream is mapped on TIMx_UP
+ */
+ES_t TIM_enuUpdateDMAControl(TIM_Handle_t *Copy_pstrTIMHandle, u8 Copy_u8EnOrDi);
+
+void TIM_IRQHandling(TIM_Handle_t *Copy_pstrTIMHandle);
+
+
+#endif /* STM32F407X_DRIVERS_INC_STM32F4XXX_TIM_H_ */
@@ -0,0 +1,261 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : stm32fxxxx_dma.c
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU / Board
+ * @brief          : For control across the entire STM32F4x family,
+ *                   this layer is not aware of specific hardware information
+ *                   such as register addresses.
+ *                   It utilizes all peripherals through MCAL APIs.
+ ******************************************************************************
+ ******************************************************************************
+ */
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+
+#include "stm32f407x_dma.h"
+#include "stm32f4xxx_dma.h"
+
+
+static ES_t dma_prepare(DMA_Handle_t *pDMAHandle, u32 PeriphAddr, u32 Mem0Addr, u32 Mem1Addr, u16 Len);
+
+
+ES_t DMA_enuInit(DMA_Handle_t *Copy_pstrDMAHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	DMA_RegDef_t *Local_DMABaseAddr = MCAL_DMA_CODE_TO_BASADDR(Copy_pstrDMAHandle->DMAx);
+
+	//stream must be disabled before any configuration
+	MCAL_DMA_DisableStream(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream);
+
+	MCAL_DMA_SetChannel(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, Copy_pstrDMAHandle->DMAConfig.DMA_Channel);
+
+	MCAL_DMA_SetDirection(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, Copy_pstrDMAHandle->DMAConfig.DMA_Direction);
+
+	MCAL_DMA_SetDataSize(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream,
+			Copy_pstrDMAHandle->DMAConfig.DMA_PeriphDataSize, Copy_pstrDMAHandle->DMAConfig.DMA_MemDataSize);
+
+	MCAL_DMA_SetIncrement(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream,
+			Copy_pstrDMAHandle->DMAConfig.DMA_PeriphInc, Copy_pstrDMAHandle->DMAConfig.DMA_MemInc);
+
+	MCAL_DMA_SetMode(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, Copy_pstrDMAHandle->DMAConfig.DMA_Mode);
+
+	MCAL_DMA_SetPriority(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, Copy_pstrDMAHandle->DMAConfig.DMA_Priority);
+
+	Local_enuErrorState = ES_OK;
+
+	return Local_enuErrorState;
+}
+
+
+ES_t DMA_enuStart(DMA_Handle_t *Copy_pstrDMAHandle, u32 Copy_u32PeriphAddr,
+		u32 Copy_u32Mem0Addr, u32 Copy_u32Mem1Addr, u16 Copy_u16Len)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	DMA_RegDef_t *Local_DMABaseAddr = MCAL_DMA_CODE_TO_BASADDR(Copy_pstrDMAHandle->DMAx);
+
+	Local_enuErrorState = dma_prepare(Copy_pstrDMAHandle, Copy_u32PeriphAddr, Copy_u32Mem0Addr, Copy_u32Mem1Addr, Copy_u16Len);
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_TC_INT, DISABLE);
+		MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_HT_INT, DISABLE);
+		MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_TE_INT, DISABLE);
+		MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_DME_INT, DISABLE);
+
+		MCAL_DMA_EnableStream(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t DMA_enuStartIT(DMA_Handle_t *Copy_pstrDMAHandle, u32 Copy_u32PeriphAddr,
+		u32 Copy_u32Mem0Addr, u32 Copy_u32Mem1Addr, u16 Copy_u16Len)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	DMA_RegDef_t *Local_DMABaseAddr = MCAL_DMA_CODE_TO_BASADDR(Copy_pstrDMAHandle->DMAx);
+
+	Local_enuErrorState = dma_prepare(Copy_pstrDMAHandle, Copy_u32PeriphAddr, Copy_u32Mem0Addr, Copy_u32Mem1Addr, Copy_u16Len);
+
+	if(Local_enuErrorState != ES_OK)
+		return Local_enuErrorState;
+
+	MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_TC_INT, ENABLE);
+	MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_TE_INT, ENABLE);
+	MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_DME_INT, ENABLE);
+
+	if(Copy_pstrDMAHandle->DMAConfig.DMA_Mode == DMA_Mode_Normal)
+	{
+		MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_HT_INT, DISABLE);
+	}
+	else
+	{
+		MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_HT_INT, ENABLE);
+	}
+
+	MCAL_DMA_EnableStream(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream);
+
+	return Local_enuErrorState;
+}
+
+
+ES_t DMA_enuStop(DMA_Handle_t *Copy_pstrDMAHandle)
+{
+	if(Copy_pstrDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	DMA_RegDef_t *Local_DMABaseAddr = MCAL_DMA_CODE_TO_BASADDR(Copy_pstrDMAHandle->DMAx);
+
+	MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_TC_INT, DISABLE);
+	MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_HT_INT, DISABLE);
+	MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_TE_INT, DISABLE);
+	MCAL_DMA_InterruptControl(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_DME_INT, DISABLE);
+
+	MCAL_DMA_DisableStream(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream);
+
+	MCAL_DMA_ClearFlags(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_FLAG_ALL);
+
+	return ES_OK;
+}
+
+
+ES_t DMA_enuGetRemaining(DMA_Handle_t *Copy_pstrDMAHandle, u16 *Copy_pu16Remaining)
+{
+	if(Copy_pstrDMAHandle==NULL || Copy_pu16Remaining==NULL)
+		return ES_NULL_PTR;
+
+	DMA_RegDef_t *Local_DMABaseAddr = MCAL_DMA_CODE_TO_BASADDR(Copy_pstrDMAHandle->DMAx);
+
+	*Copy_pu16Remaining = MCAL_DMA_GetDataCounter(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream);
+
+	return ES_OK;
+}
+
+
+ES_t DMA_enuGetCurrentTarget(DMA_Handle_t *Copy_pstrDMAHandle, u8 *Copy_pu8Target)
+{
+	if(Copy_pstrDMAHandle==NULL || Copy_pu8Target==NULL)
+		return ES_NULL_PTR;
+
+	DMA_RegDef_t *Local_DMABaseAddr = MCAL_DMA_CODE_TO_BASADDR(Copy_pstrDMAHandle->DMAx);
+
+	*Copy_pu8Target = MCAL_DMA_GetCurrentTarget(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream);
+
+	return ES_OK;
+}
+
+
+ES_t DMA_enuSetMemoryAddress(DMA_Handle_t *Copy_pstrDMAHandle, u8 Copy_u8Target, u32 Copy_u32MemAddr)
+{
+	if(Copy_pstrDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	DMA_RegDef_t *Local_DMABaseAddr = MCAL_DMA_CODE_TO_BASADDR(Copy_pstrDMAHandle->DMAx);
+
+	//in double buffer mode only the memory not in use by the stream may be changed
+	if(MCAL_DMA_GetStreamStatus(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream) == ENABLE &&
+			MCAL_DMA_GetCurrentTarget(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream) == Copy_u8Target)
+	{
+		return ES_FUNC_IS_BUSY;
+	}
+
+	MCAL_DMA_SetMemoryAddress(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, Copy_u8Target, Copy_u32MemAddr);
+
+	return ES_OK;
+}
+
+
+ES_t DMA_enuGetAndClearEvents(DMA_Handle_t *Copy_pstrDMAHandle, u8 *Copy_pu8Events)
+{
+	if(Copy_pstrDMAHandle==NULL || Copy_pu8Events==NULL)
+		return ES_NULL_PTR;
+
+	DMA_RegDef_t *Local_DMABaseAddr = MCAL_DMA_CODE_TO_BASADDR(Copy_pstrDMAHandle->DMAx);
+
+	u8 Local_u8Flags = MCAL_DMA_GetFlags(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream);
+
+	MCAL_DMA_ClearFlags(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, Local_u8Flags);
+
+	*Copy_pu8Events = 0;
+
+	if(Local_u8Flags & MCAL_DMA_FLAG_HT)
+		*Copy_pu8Events |= DMA_EVENT_MASK(DMA_Event_HalfTransfer);
+
+	if(Local_u8Flags & MCAL_DMA_FLAG_TC)
+		*Copy_pu8Events |= DMA_EVENT_MASK(DMA_Event_TransferComplete);
+
+	if(Local_u8Flags & MCAL_DMA_FLAG_TE)
+		*Copy_pu8Events |= DMA_EVENT_MASK(DMA_Event_TransferError);
+
+	if(Local_u8Flags & MCAL_DMA_FLAG_DME)
+		*Copy_pu8Events |= DMA_EVENT_MASK(DMA_Event_DirectModeError);
+
+	if(Local_u8Flags & MCAL_DMA_FLAG_FE)
+		*Copy_pu8Events |= DMA_EVENT_MASK(DMA_Event_FifoError);
+
+	return ES_OK;
+}
+
+
+void DMA_IRQHandling(DMA_Handle_t *Copy_pstrDMAHandle)
+{
+	u8 Local_u8Events = 0;
+
+	if(DMA_enuGetAndClearEvents(Copy_pstrDMAHandle, &Local_u8Events) != ES_OK)
+		return;
+
+	if(Copy_pstrDMAHandle->CallBackFun == NULL)
+		return;
+
+	for(u8 Local_u8Event = DMA_Event_HalfTransfer ; Local_u8Event <= DMA_Event_FifoError ; Local_u8Event++)
+	{
+		if(Local_u8Events & DMA_EVENT_MASK(Local_u8Event))
+		{
+			Copy_pstrDMAHandle->CallBackFun((DMA_Event_t)Local_u8Event);
+		}
+	}
+}
+
+
+static ES_t dma_prepare(DMA_Handle_t *Copy_pstrDMAHandle, u32 Copy_u32PeriphAddr,
+		u32 Copy_u32Mem0Addr, u32 Copy_u32Mem1Addr, u16 Copy_u16Len)
+{
+	DMA_RegDef_t *Local_DMABaseAddr = MCAL_DMA_CODE_TO_BASADDR(Copy_pstrDMAHandle->DMAx);
+
+	if(MCAL_DMA_GetStreamStatus(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream) == ENABLE)
+		return ES_FUNC_IS_BUSY;
+
+	if(Copy_u16Len == 0)
+		return ES_NOT_OK;
+
+	MCAL_DMA_SetPeriphAddress(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, Copy_u32PeriphAddr);
+
+	MCAL_DMA_SetMemoryAddress(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, 0, Copy_u32Mem0Addr);
+
+	if(Copy_pstrDMAHandle->DMAConfig.DMA_Mode == DMA_Mode_DoubleBuffer)
+	{
+		MCAL_DMA_SetMemoryAddress(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, 1, Copy_u32Mem1Addr);
+	}
+
+	MCAL_DMA_SetDataCounter(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, Copy_u16Len);
+
+	//flags left over from a previous transfer would fire the interrupt immediately
+	MCAL_DMA_ClearFlags(Local_DMABaseAddr, Copy_pstrDMAHandle->Stream, MCAL_DMA_FLAG_ALL);
+
+	return ES_OK;
+}
@@ -105,6 +105,109 @@ ES_t GPIO_enuInit(GPIO_Handle_t *Copy_pstrGPIOHandle)
 
 }
 
+ES_t GPIO_enuInitTable(const GPIO_Handle_t *Copy_pstrGPIOTable, u16 Copy_u16Count)
+{
+	ES_t Local_enuErrSt = ES_NOT_OK;
+
+	GPIO_PortRegCfg_t Local_astrPortCfg[GPIO_PORTH + 1] = {0};
+
+	u8 Local_u8UsedPorts = 0;
+
+	if(Copy_pstrGPIOTable == NULL)
+		return ES_NULL_PTR;
+
+	/*
+	 * 1. check the whole table
+	 */
+	for(u16 Local_u16Idx = 0; Local_u16Idx < Copy_u16Count; Local_u16Idx++)
+	{
+		const GPIO_Handle_t *Local_pstrPin = &Copy_pstrGPIOTable[Local_u16Idx];
+
+		if(Local_pstrPin->GPIO_Port > GPIO_PORTH || Local_pstrPin->GPIO_Config.GPIO_PinNumber > GPIO_PIN15 ||
+				Local_pstrPin->GPIO_Config.GPIO_PinMode > GPIO_Mode_EXTI_RFT ||
+				Local_pstrPin->GPIO_Config.GPIO_PinSpeed > GPIO_Speed_High ||
+				Local_pstrPin->GPIO_Config.GPIO_PinPuPdControl > GPIO_PullDown ||
+				Local_pstrPin->GPIO_Config.GPIO_PinOPType > GPIO_Output_OD ||
+				Local_pstrPin->GPIO_Config.GPIO_PinAltFunMode > 15)
+			return ES_NOT_OK;
+	}
+
+	/*
+	 * 2. merge the pins of each port
+	 */
+	for(u16 Local_u16Idx = 0; Local_u16Idx < Copy_u16Count; Local_u16Idx++)
+	{
+		const GPIO_PinConfig_t *Local_pstrCfg = &Copy_pstrGPIOTable[Local_u16Idx].GPIO_Config;
+		GPIO_PortRegCfg_t *Local_pstrPort = &Local_astrPortCfg[Copy_pstrGPIOTable[Local_u16Idx].GPIO_Port];
+
+		u8  Local_u8Pin = Local_pstrCfg->GPIO_PinNumber;
+		u32 Local_u32Field = 0x3UL << (2 * Local_u8Pin);
+		u32 Local_u32Mode = (Local_pstrCfg->GPIO_PinMode <= GPIO_Mode_inputAnal) ? Local_pstrCfg->GPIO_PinMode : GPIO_Mode_input;
+
+		Local_pstrPort->ModeMask |= Local_u32Field;
+		Local_pstrPort->ModeValue = (Local_pstrPort->ModeValue & ~Local_u32Field) | (Local_u32Mode << (2 * Local_u8Pin));
+
+		Local_pstrPort->SpeedMask |= Local_u32Field;
+		Local_pstrPort->SpeedValue = (Local_pstrPort->SpeedValue & ~Local_u32Field) |
+				((u32)Local_pstrCfg->GPIO_PinSpeed << (2 * Local_u8Pin));
+
+		Local_pstrPort->PuPdMask |= Local_u32Field;
+		Local_pstrPort->PuPdValue = (Local_pstrPort->PuPdValue & ~Local_u32Field) |
+				((u32)Local_pstrCfg->GPIO_PinPuPdControl << (2 * Local_u8Pin));
+
+		Local_pstrPort->OTypeMask |= (1 << Local_u8Pin);
+		Local_pstrPort->OTypeValue = (Local_pstrPort->OTypeValue & ~(1 << Local_u8Pin)) |
+				(Local_pstrCfg->GPIO_PinOPType << Local_u8Pin);
+
+		if(Local_pstrCfg->GPIO_PinMode == GPIO_Mode_altFun)
+		{
+			u8  Local_u8Reg = Local_u8Pin / 8;
+			u32 Local_u32AltField = 0xFUL << (4 * (Local_u8Pin % 8));
+
+			Local_pstrPort->AltFunMask[Local_u8Reg] |= Local_u32AltField;
+			Local_pstrPort->AltFunValue[Local_u8Reg] = (Local_pstrPort->AltFunValue[Local_u8Reg] & ~Local_u32AltField) |
+					((u32)Local_pstrCfg->GPIO_PinAltFunMode << (4 * (Local_u8Pin % 8)));
+		}
+
+		Local_u8UsedPorts |= (1 << Copy_pstrGPIOTable[Local_u16Idx].GPIO_Port);
+	}
+
+	/*
+	 * 3. one write per register of each port
+	 */
+	for(u8 Local_u8Port = GPIO_PORTA; Local_u8Port <= GPIO_PORTH; Local_u8Port++)
+	{
+		if(Local_u8UsedPorts & (1 << Local_u8Port))
+		{
+			MCAL_GPIO_ConfigPort(MCAL_GPIO_CODE_TO_BASADDR(Local_u8Port), &Local_astrPortCfg[Local_u8Port]);
+		}
+	}
+
+	/*
+	 * 4. EXTI lines, once their pins are inputs
+	 */
+	Local_enuErrSt = ES_OK;
+
+	for(u16 Local_u16Idx = 0; Local_u16Idx < Copy_u16Count; Local_u16Idx++)
+	{
+		const GPIO_Handle_t *Local_pstrPin = &Copy_pstrGPIOTable[Local_u16Idx];
+
+		if(Local_pstrPin->GPIO_Config.GPIO_PinMode > GPIO_Mode_inputAnal)
+		{
+			MCAL_EXTI_SetEdgeTrig(Local_pstrPin->GPIO_Config.GPIO_PinNumber, Local_pstrPin->GPIO_Config.GPIO_PinMode);
+
+			MCAL_SYSCFG_SellectEXTIChannel(Local_pstrPin->GPIO_Port, Local_pstrPin->GPIO_Config.GPIO_PinNumber);
+
+			MCAL_EXTI_SetCallBack(Local_pstrPin->GPIO_Config.GPIO_PinNumber, Local_pstrPin->GPIO_Config.EXTI_pfCallBackFunc);
+
+			MCAL_EXTI_EnableLine(Local_pstrPin->GPIO_Config.GPIO_PinNumber);
+		}
+	}
+
+	return Local_enuErrSt;
+}
+
+
 /*
  * Data read and write
  */
@@ -112,10 +215,14 @@ ES_t GPIO_enuReadFromInputPin(GPIO_Port_t Copy_enuGPIOPort, GPIO_Pin_t Copy_enuG
 {
 	ES_t Local_enuErrSt = ES_NOT_OK;
 
-	GPIO_RegDef_t *Local_pstrGPIOx = NULL;
+	if(Copy_enuGPIOPort > GPIO_PORTH || Copy_enuGPIOPin > GPIO_PIN15)
+		return ES_NOT_OK;
+
+	u8 Local_u8State = 0;
+
+	Local_enuErrSt = MCAL_GPIO_ReadPin(MCAL_GPIO_CODE_TO_BASADDR(Copy_enuGPIOPort), Copy_enuGPIOPin, &Local_u8State);
 
-	MCAL_GPIO_SelectPort(Copy_enuGPIOPort,&Local_pstrGPIOx);
-	Local_enuErrSt = MCAL_GPIO_ReadPin(Local_pstrGPIOx, Copy_enuGPIOPin, Copy_pu8State);
+	*Copy_pu8State = (GPIO_PinState_t)Local_u8State;
 
 	return Local_enuErrSt;
 }
@@ -125,10 +232,10 @@ ES_t GPIO_enuWriteToOutputPin(GPIO_Port_t Copy_enuGPIOPort, GPIO_Pin_t Copy_enuG
 {
 	ES_t Local_enuErrSt = ES_NOT_OK;
 
-	GPIO_RegDef_t *Local_pstrGPIOx = NULL;
+	if(Copy_enuGPIOPort > GPIO_PORTH || Copy_enuGPIOPin > GPIO_PIN15)
+		return ES_NOT_OK;
 
-	MCAL_GPIO_SelectPort(Copy_enuGPIOPort,&Local_pstrGPIOx);
-	Local_enuErrSt = MCAL_GPIO_WritePin(Local_pstrGPIOx,Copy_enuGPIOPin,Copy_enuGPIOPinState);
+	Local_enuErrSt = MCAL_GPIO_WritePin(MCAL_GPIO_CODE_TO_BASADDR(Copy_enuGPIOPort),Copy_enuGPIOPin,Copy_enuGPIOPinState);
 
 	return Local_enuErrSt;
 }
@@ -139,11 +246,52 @@ ES_t GPIO_enuToggleOutputPin(GPIO_Port_t Copy_enuGPIOPort, GPIO_Pin_t Copy_enuGP
 {
 	ES_t Local_enuErrSt = ES_NOT_OK;
 
-	GPIO_RegDef_t *Local_pstrGPIOx = NULL;
+	if(Copy_enuGPIOPort > GPIO_PORTH || Copy_enuGPIOPin > GPIO_PIN15)
+		return ES_NOT_OK;
+
+	Local_enuErrSt = MCAL_GPIO_TogglePin(MCAL_GPIO_CODE_TO_BASADDR(Copy_enuGPIOPort), Copy_enuGPIOPin);
 
-	MCAL_GPIO_SelectPort(Copy_enuGPIOPort,&Local_pstrGPIOx);
-	Local_enuErrSt = MCAL_GPIO_TogglePin(Local_pstrGPIOx, Copy_enuGPIOPin);
-	Local_pstrGPIOx = GPIOH;
 	return Local_enuErrSt;
 }
 
+
+ES_t GPIO_enuWritePortMasked(GPIO_Port_t Copy_enuGPIOPort, u16 Copy_u16Mask, u16 Copy_u16Value)
+{
+	ES_t Local_enuErrSt = ES_NOT_OK;
+
+	if(Copy_enuGPIOPort > GPIO_PORTH)
+		return ES_NOT_OK;
+
+	Local_enuErrSt = MCAL_GPIO_WritePortMasked(MCAL_GPIO_CODE_TO_BASADDR(Copy_enuGPIOPort), Copy_u16Mask, Copy_u16Value);
+
+	return Local_enuErrSt;
+}
+
+
+ES_t GPIO_enuReadPort(GPIO_Port_t Copy_enuGPIOPort, u16 *Copy_pu16Value)
+{
+	ES_t Local_enuErrSt = ES_NOT_OK;
+
+	if(Copy_pu16Value == NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_enuGPIOPort > GPIO_PORTH)
+		return ES_NOT_OK;
+
+	Local_enuErrSt = MCAL_GPIO_ReadPort(MCAL_GPIO_CODE_TO_BASADDR(Copy_enuGPIOPort), Copy_pu16Value);
+
+	return Local_enuErrSt;
+}
+
+
+ES_t GPIO_enuGetEXTIHitCount(GPIO_Pin_t Copy_enuGPIOPin, u32 *Copy_pu32Count)
+{
+	ES_t Local_enuErrSt = ES_NOT_OK;
+
+	if(Copy_pu32Count == NULL)
+		return ES_NULL_PTR;
+
+	Local_enuErrSt = MCAL_EXTI_GetHitCount(Copy_enuGPIOPin, Copy_pu32Count);
+
+	return Local_enuErrSt;
+}
@@ -0,0 +1,297 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : stm32fxxxx_i2s.c
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU / Board
+ * @brief          : For control across the entire STM32F4x family,
+ *                   this layer is not aware of specific hardware information
+ *                   such as register addresses.
+ *                   It utilizes all peripherals through MCAL APIs.
+ ******************************************************************************
+ ******************************************************************************
+ */
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+
+#include "stm32f407x_spi.h"
+#include "stm32f4xxx_dma.h"
+#include "stm32f4xxx_i2s.h"
+
+#include "stm32f4xxx_rcc.h"
+
+/*
+ * PLLI2S VCO output limits
+ */
+#define I2S_PLLI2S_VCO_MIN          100000000UL
+#define I2S_PLLI2S_VCO_MAX          432000000UL
+
+static ES_t I2S_SetClock(I2S_Handle_t *Copy_pstrI2SHandle);
+
+
+ES_t I2S_enuInit(I2S_Handle_t *Copy_pstrI2SHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrI2SHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrI2SHandle->I2Sx != I2S_2 && Copy_pstrI2SHandle->I2Sx != I2S_3)
+		return ES_NOT_OK;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrI2SHandle->I2Sx);
+
+	MCAL_I2S_Disable(Local_SPIBaseAddr);
+
+	MCAL_I2S_SelectI2SMode(Local_SPIBaseAddr);
+
+	MCAL_I2S_SetMode(Local_SPIBaseAddr, Copy_pstrI2SHandle->I2SConfig.I2S_Mode);
+
+	MCAL_I2S_SetStandard(Local_SPIBaseAddr, Copy_pstrI2SHandle->I2SConfig.I2S_Standard);
+
+	switch(Copy_pstrI2SHandle->I2SConfig.I2S_DataFormat)
+	{
+	case I2S_DataFormat_16Bits         : MCAL_I2S_SetDataFormat(Local_SPIBaseAddr, MCAL_I2S_DATLEN_16BITS, MCAL_I2S_CHLEN_16BITS); break;
+	case I2S_DataFormat_16BitsExtended : MCAL_I2S_SetDataFormat(Local_SPIBaseAddr, MCAL_I2S_DATLEN_16BITS, MCAL_I2S_CHLEN_32BITS); break;
+	case I2S_DataFormat_24Bits         : MCAL_I2S_SetDataFormat(Local_SPIBaseAddr, MCAL_I2S_DATLEN_24BITS, MCAL_I2S_CHLEN_32BITS); break;
+	case I2S_DataFormat_32Bits         : MCAL_I2S_SetDataFormat(Local_SPIBaseAddr, MCAL_I2S_DATLEN_32BITS, MCAL_I2S_CHLEN_32BITS); break;
+	default : return ES_NOT_OK;
+	}
+
+	MCAL_I2S_SetCPOL(Local_SPIBaseAddr, Copy_pstrI2SHandle->I2SConfig.I2S_CPOL);
+
+	Local_enuErrorState = ES_OK;
+
+	//only the master generates the bit clock
+	if(Copy_pstrI2SHandle->I2SConfig.I2S_Mode == I2S_Mode_MasterTx ||
+			Copy_pstrI2SHandle->I2SConfig.I2S_Mode == I2S_Mode_MasterRx)
+	{
+		Local_enuErrorState = I2S_SetClock(Copy_pstrI2SHandle);
+	}
+
+	Copy_pstrI2SHandle->State = I2S_Ready;
+
+	return Local_enuErrorState;
+}
+
+
+ES_t I2S_enuStartDMA(I2S_Handle_t *Copy_pstrI2SHandle, u16 *Copy_pu16Buffer, u16 Copy_u16Len,
+		void (*CallBack)(I2S_Event_t Event, u16 *pData, u16 Len))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrI2SHandle==NULL || Copy_pu16Buffer==NULL || CallBack==NULL || Copy_pstrI2SHandle->pDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrI2SHandle->State != I2S_Ready)
+		return ES_FUNC_IS_BUSY;
+
+	//both halves must hold whole stereo samples
+	if(Copy_pstrI2SHandle->I2SConfig.I2S_DataFormat >= I2S_DataFormat_24Bits)
+	{
+		if(Copy_u16Len == 0 || (Copy_u16Len % 8))
+			return ES_NOT_OK;
+	}
+	else
+	{
+		if(Copy_u16Len == 0 || (Copy_u16Len % 4))
+			return ES_NOT_OK;
+	}
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrI2SHandle->I2Sx);
+
+	DMA_Handle_t *Local_pstrDMAHandle = Copy_pstrI2SHandle->pDMAHandle;
+
+	u8 Local_u8IsTx = (Copy_pstrI2SHandle->I2SConfig.I2S_Mode == I2S_Mode_MasterTx ||
+			Copy_pstrI2SHandle->I2SConfig.I2S_Mode == I2S_Mode_SlaveTx);
+
+	Copy_pstrI2SHandle->pBuffer = Copy_pu16Buffer;
+	Copy_pstrI2SHandle->BufferLen = Copy_u16Len;
+	Copy_pstrI2SHandle->CallBackFun = CallBack;
+
+	Local_pstrDMAHandle->DMAConfig.DMA_Direction = (Local_u8IsTx)? DMA_Dir_MemToPeriph : DMA_Dir_PeriphToMem;
+	Local_pstrDMAHandle->DMAConfig.DMA_PeriphDataSize = DMA_DataSize_HalfWord;
+	Local_pstrDMAHandle->DMAConfig.DMA_MemDataSize = DMA_DataSize_HalfWord;
+	Local_pstrDMAHandle->DMAConfig.DMA_PeriphInc = DMA_Inc_Disable;
+	Local_pstrDMAHandle->DMAConfig.DMA_MemInc = DMA_Inc_Enable;
+	Local_pstrDMAHandle->DMAConfig.DMA_Mode = DMA_Mode_Circular;
+	Local_pstrDMAHandle->DMAConfig.DMA_Priority = DMA_Priority_High;
+
+	Local_enuErrorState = DMA_enuInit(Local_pstrDMAHandle);
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		Local_enuErrorState = DMA_enuStartIT(Local_pstrDMAHandle, MCAL_SPI_GetDataRegAddress(Local_SPIBaseAddr),
+				(u32)Copy_pu16Buffer, 0, Copy_u16Len);
+	}
+
+	if(Local_enuErrorState == ES_OK)
+	{
+		if(Local_u8IsTx)
+		{
+			MCAL_SPI_EnableTxDMA(Local_SPIBaseAddr);
+		}
+		else
+		{
+			MCAL_SPI_EnableRxDMA(Local_SPIBaseAddr);
+		}
+
+		Copy_pstrI2SHandle->State = I2S_Busy;
+
+		MCAL_I2S_Enable(Local_SPIBaseAddr);
+	}
+
+	return Local_enuErrorState;
+}
+
+
+ES_t I2S_enuStop(I2S_Handle_t *Copy_pstrI2SHandle)
+{
+	if(Copy_pstrI2SHandle==NULL)
+		return ES_NULL_PTR;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrI2SHandle->I2Sx);
+
+	if(Copy_pstrI2SHandle->pDMAHandle != NULL)
+	{
+		DMA_enuStop(Copy_pstrI2SHandle->pDMAHandle);
+	}
+
+	MCAL_SPI_DisableTxDMA(Local_SPIBaseAddr);
+	MCAL_SPI_DisableRxDMA(Local_SPIBaseAddr);
+
+	MCAL_I2S_Disable(Local_SPIBaseAddr);
+
+	Copy_pstrI2SHandle->State = I2S_Ready;
+	Copy_pstrI2SHandle->pBuffer = NULL;
+	Copy_pstrI2SHandle->BufferLen = 0;
+
+	return ES_OK;
+}
+
+
+void I2S_DMA_IRQHandling(I2S_Handle_t *Copy_pstrI2SHandle)
+{
+	u8 Local_u8Events = 0;
+	u16 Local_u16HalfLen;
+
+	if(DMA_enuGetAndClearEvents(Copy_pstrI2SHandle->pDMAHandle, &Local_u8Events) != ES_OK)
+		return;
+
+	if(Copy_pstrI2SHandle->State != I2S_Busy)
+		return;
+
+	Local_u16HalfLen = Copy_pstrI2SHandle->BufferLen / 2;
+
+	if(Local_u8Events & DMA_EVENT_MASK(DMA_Event_HalfTransfer))
+	{
+		//DMA is now working on the second half, the first one is free
+		Copy_pstrI2SHandle->CallBackFun(I2S_Event_HalfComplete, Copy_pstrI2SHandle->pBuffer, Local_u16HalfLen);
+	}
+
+	if(Local_u8Events & DMA_EVENT_MASK(DMA_Event_TransferComplete))
+	{
+		//DMA wrapped around to the first half, the second one is free
+		Copy_pstrI2SHandle->CallBackFun(I2S_Event_Complete, Copy_pstrI2SHandle->pBuffer + Local_u16HalfLen, Local_u16HalfLen);
+	}
+
+	if(Local_u8Events & (DMA_EVENT_MASK(DMA_Event_TransferError) | DMA_EVENT_MASK(DMA_Event_DirectModeError)))
+	{
+		Copy_pstrI2SHandle->CallBackFun(I2S_Event_Error, NULL, 0);
+	}
+}
+
+
+//some helper function implementations
+
+/*
+ * Search the PLLI2S (N,R) and I2S prescaler combination giving the closest audio frequency
+ *  - MCLK output enabled  : Fs = I2SCLK / (256 * (2 * I2SDIV + ODD))
+ *  - MCLK output disabled : Fs = I2SCLK / (FrameBits * (2 * I2SDIV + ODD))
+ */
+static ES_t I2S_SetClock(I2S_Handle_t *Copy_pstrI2SHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	u32 Local_u32PLLInput = 0;
+	u32 Local_u32AudioFreq = Copy_pstrI2SHandle->I2SConfig.I2S_AudioFreq;
+	u32 Local_u32Factor;
+	u32 Local_u32I2SClk, Local_u32Div, Local_u32Error;
+	u32 Local_u32BestError = 0xFFFFFFFF;
+	u16 Local_u16BestN = 0;
+	u8  Local_u8BestR = 0;
+	u32 Local_u32BestDiv = 0;
+
+	if(Local_u32AudioFreq == 0)
+		return ES_NOT_OK;
+
+	if(RCC_enuGetPLLInputValue(&Local_u32PLLInput) != ES_OK)
+		return ES_NOT_OK;
+
+	if(Copy_pstrI2SHandle->I2SConfig.I2S_MCLKOutput == I2S_MCLKOutput_Enable)
+	{
+		Local_u32Factor = 256;
+	}
+	else if(Copy_pstrI2SHandle->I2SConfig.I2S_DataFormat == I2S_DataFormat_16Bits)
+	{
+		Local_u32Factor = 32;
+	}
+	else
+	{
+		Local_u32Factor = 64;
+	}
+
+	for(u16 Local_u16N = 50 ; Local_u16N <= 432 && Local_u32BestError != 0 ; Local_u16N++)
+	{
+		u32 Local_u32VCO = Local_u32PLLInput * Local_u16N;
+
+		if(Local_u32VCO < I2S_PLLI2S_VCO_MIN || Local_u32VCO > I2S_PLLI2S_VCO_MAX)
+			continue;
+
+		for(u8 Local_u8R = 2 ; Local_u8R <= 7 ; Local_u8R++)
+		{
+			Local_u32I2SClk = Local_u32VCO / Local_u8R;
+
+			//rounded (2 * I2SDIV + ODD)
+			Local_u32Div = (Local_u32I2SClk + (Local_u32Factor * Local_u32AudioFreq) / 2) / (Local_u32Factor * Local_u32AudioFreq);
+
+			if(Local_u32Div < (2 * MCAL_I2S_DIV_MIN) || Local_u32Div > (2 * MCAL_I2S_DIV_MAX + 1))
+				continue;
+
+			//error in units of the I2S clock per prescaler step
+			if(Local_u32I2SClk > Local_u32Factor * Local_u32AudioFreq * Local_u32Div)
+			{
+				Local_u32Error = Local_u32I2SClk - Local_u32Factor * Local_u32AudioFreq * Local_u32Div;
+			}
+			else
+			{
+				Local_u32Error = Local_u32Factor * Local_u32AudioFreq * Local_u32Div - Local_u32I2SClk;
+			}
+			Local_u32Error /= Local_u32Div;
+
+			if(Local_u32Error < Local_u32BestError)
+			{
+				Local_u32BestError = Local_u32Error;
+				Local_u16BestN = Local_u16N;
+				Local_u8BestR = Local_u8R;
+				Local_u32BestDiv = Local_u32Div;
+			}
+		}
+	}
+
+	if(Local_u32BestDiv != 0)
+	{
+		SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrI2SHandle->I2Sx);
+
+		Local_enuErrorState = RCC_enuConfigPLLI2S(Local_u16BestN, Local_u8BestR);
+
+		MCAL_I2S_SetPrescaler(Local_SPIBaseAddr, (u8)(Local_u32BestDiv / 2), (u8)(Local_u32BestDiv & 1),
+				Copy_pstrI2SHandle->I2SConfig.I2S_MCLKOutput);
+
+		Copy_pstrI2SHandle->ActualAudioFreq = ((Local_u32PLLInput * Local_u16BestN) / Local_u8BestR) /
+				(Local_u32Factor * Local_u32BestDiv);
+	}
+
+	return Local_enuErrorState;
+}
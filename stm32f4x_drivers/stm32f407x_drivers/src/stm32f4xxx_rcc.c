@@ -178,6 +178,15 @@ ES_t RCC_enuGetSysClkValue(u32 *Copy_pu32SysClkValue)
 	return Local_enuErrSt;
 }
 
+ES_t RCC_enuGetAHBValue(u32 *Copy_pu32AHBValue)
+{
+	ES_t Local_enuErrSt = ES_NOT_OK;
+
+	Local_enuErrSt = MCAL_RCC_GetAHBValue(Copy_pu32AHBValue);
+
+	return Local_enuErrSt;
+}
+
 
 ES_t RCC_enuGetSysClkType(RCC_SysClk_t *Copy_penuSysClk)
 {
@@ -188,3 +197,25 @@ ES_t RCC_enuGetSysClkType(RCC_SysClk_t *Copy_penuSysClk)
 	return Local_enuErrSt;
 }
 
+
+/**********************************************************************************************/
+
+
+ES_t RCC_enuGetPLLInputValue(u32 *Copy_pu32PLLInputValue)
+{
+	ES_t Local_enuErrSt = ES_NOT_OK;
+
+	Local_enuErrSt = MCAL_RCC_GetPLLInputValue(Copy_pu32PLLInputValue);
+
+	return Local_enuErrSt;
+}
+
+
+ES_t RCC_enuConfigPLLI2S(u16 Copy_u16PLLI2SN, u8 Copy_u8PLLI2SR)
+{
+	ES_t Local_enuErrSt = ES_NOT_OK;
+
+	Local_enuErrSt = MCAL_RCC_ConfigPLLI2S(Copy_u16PLLI2SN, Copy_u8PLLI2SR);
+
+	return Local_enuErrSt;
+}
@@ -16,11 +16,34 @@
 #include "error_state.h"
 
 #include "stm32f407x_spi.h"
+#include "stm32f4xxx_dma.h"
 #include "stm32f4xxx_spi.h"
 
 static void  spi_txe_interrupt_handle(SPI_Handle_t *pSPIHandle);
 static void  spi_rxne_interrupt_handle(SPI_Handle_t *pSPIHandle);
 static void  spi_ovr_err_interrupt_handle(SPI_Handle_t *pSPIHandle);
+static void  spi_stream_rxne_interrupt_handle(SPI_Handle_t *pSPIHandle);
+static void  spi_stream_handoff(SPI_Handle_t *pSPIHandle);
+static void  spi_hd_txe_interrupt_handle(SPI_Handle_t *pSPIHandle);
+static void  spi_burst_xfer_8bit(SPI_RegDef_t *pSPIx, u8 *pTxData, u8 *pRxData, u32 Frames);
+static void  spi_burst_xfer_16bit(SPI_RegDef_t *pSPIx, u8 *pTxData, u8 *pRxData, u32 Frames);
+static void  spi_hd_rxne_interrupt_handle(SPI_Handle_t *pSPIHandle);
+static void  spi_dma_crc_rxne_interrupt_handle(SPI_Handle_t *pSPIHandle);
+static void  spi_dma_done(SPI_Handle_t *pSPIHandle);
+static void  spi_hd_start_reception(SPI_Handle_t *pSPIHandle);
+static void  spi_hd_stop_clock(SPI_Handle_t *pSPIHandle);
+static void  spi_dma_config(DMA_Handle_t *pDMAHandle, DMA_Direction_t Direction, SPI_DFF_t DFF, DMA_IncCtrl_t MemInc, DMA_Mode_t Mode);
+
+//source and sink of the DMA stream that has no buffer
+static u16 spi_dma_dummy_tx = 0xFFFF;
+static u16 spi_dma_dummy_rx;
+
+//burst loop per data frame format, indexed by SPI_DFF_t
+static void (* const spi_burst_xfer[2])(SPI_RegDef_t *pSPIx, u8 *pTxData, u8 *pRxData, u32 Frames) =
+{
+	spi_burst_xfer_8bit,
+	spi_burst_xfer_16bit
+};
 
 
 ES_t SPI_enuInit(SPI_Handle_t *Copy_pstrSPIHandle)
@@ -115,6 +138,222 @@ ES_t SPI_enuReceiveData(SPI_Handle_t *Copy_pstrSPIHandle,u8 *Copy_pu8Data, u32 C
 }
 
 
+ES_t SPI_enuTransceiveBurst(SPI_Handle_t *Copy_pstrSPIHandle, u8 *Copy_pu8TxData, u8 *Copy_pu8RxData, u32 Copy_u32Len)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSPIHandle->TxState != SPI_Ready || Copy_pstrSPIHandle->RxState != SPI_Ready)
+		return ES_FUNC_IS_BUSY;
+
+	if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF > SPI_DFF_16Bits)
+		return ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits)
+	{
+		if(Copy_u32Len & 1)
+			return ES_NOT_OK;
+
+		Copy_u32Len >>= 1;
+	}
+
+	if(Copy_u32Len > 0)
+	{
+		SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+		//drop any stale frame so the first RXNE belongs to this transfer
+		if(MCAL_SPI_GetStatusInline(Local_SPIBaseAddr) & MCAL_SPI_RXNE_FLAG)
+		{
+			(void)MCAL_SPI_ReadInline(Local_SPIBaseAddr);
+		}
+
+		spi_burst_xfer[Copy_pstrSPIHandle->SPIConfig.SPI_DFF](Local_SPIBaseAddr, Copy_pu8TxData, Copy_pu8RxData, Copy_u32Len);
+
+		while(MCAL_SPI_GetStatusInline(Local_SPIBaseAddr) & MCAL_SPI_BUSY_FLAG);
+	}
+
+	Local_enuErrorState = ES_OK;
+
+	return Local_enuErrorState;
+}
+
+
+ES_t SPI_enuTransceiveDMA(SPI_Handle_t *Copy_pstrSPIHandle, u8 *Copy_pu8TxData, u8 *Copy_pu8RxData,
+		u32 Copy_u32Len, void(*CallBack)(void))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle==NULL || CallBack==NULL || Copy_pstrSPIHandle->pTxDMAHandle==NULL ||
+			Copy_pstrSPIHandle->pRxDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSPIHandle->TxState != SPI_Ready || Copy_pstrSPIHandle->RxState != SPI_Ready)
+		return ES_FUNC_IS_BUSY;
+
+	u32 Local_u32Frames = Copy_u32Len;
+
+	if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits)
+	{
+		if(Copy_u32Len & 1)
+			return ES_NOT_OK;
+
+		Local_u32Frames >>= 1;
+	}
+
+	if(Local_u32Frames == 0 || Local_u32Frames > 0xFFFF)
+		return ES_NOT_OK;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	Copy_pstrSPIHandle->TxState = SPI_BUSY_InDMA;
+	Copy_pstrSPIHandle->RxState = SPI_BUSY_InDMA;
+	Copy_pstrSPIHandle->RxCallBackFunc = CallBack;
+
+	if(Copy_pstrSPIHandle->CRCEnabled)
+	{
+		//each transfer carries its own CRC
+		u8 Local_u8Enabled = MCAL_SPI_GetEnableStatus(Local_SPIBaseAddr);
+
+		MCAL_PSI_Disable(Local_SPIBaseAddr);
+		MCAL_SPI_DisableCRC(Local_SPIBaseAddr);
+		MCAL_SPI_EnableCRC(Local_SPIBaseAddr);
+		MCAL_SPI_ClearCRCErrorFlag(Local_SPIBaseAddr);
+
+		if(Local_u8Enabled)
+		{
+			MCAL_PSI_Enable(Local_SPIBaseAddr);
+		}
+	}
+
+	spi_dma_config(Copy_pstrSPIHandle->pRxDMAHandle, DMA_Dir_PeriphToMem, Copy_pstrSPIHandle->SPIConfig.SPI_DFF,
+			(Copy_pu8RxData != NULL)? DMA_Inc_Enable : DMA_Inc_Disable, DMA_Mode_Normal);
+
+	spi_dma_config(Copy_pstrSPIHandle->pTxDMAHandle, DMA_Dir_MemToPeriph, Copy_pstrSPIHandle->SPIConfig.SPI_DFF,
+			(Copy_pu8TxData != NULL)? DMA_Inc_Enable : DMA_Inc_Disable, DMA_Mode_Normal);
+
+	//drop any stale frame so the first RX request belongs to this transfer
+	if(MCAL_SPI_GetStatusInline(Local_SPIBaseAddr) & MCAL_SPI_RXNE_FLAG)
+	{
+		(void)MCAL_SPI_ReadInline(Local_SPIBaseAddr);
+	}
+
+	MCAL_SPI_EnableErrInterrupt(Local_SPIBaseAddr);
+
+	//RX stream first so no frame is missed once TX starts clocking
+	Local_enuErrorState = DMA_enuStartIT(Copy_pstrSPIHandle->pRxDMAHandle, MCAL_SPI_GetDataRegAddress(Local_SPIBaseAddr),
+			(Copy_pu8RxData != NULL)? (u32)Copy_pu8RxData : (u32)&spi_dma_dummy_rx, 0, (u16)Local_u32Frames);
+
+	if(Local_enuErrorState != ES_OK)
+	{
+		MCAL_SPI_DisableErrInterrupt(Local_SPIBaseAddr);
+		Copy_pstrSPIHandle->TxState = SPI_Ready;
+		Copy_pstrSPIHandle->RxState = SPI_Ready;
+		return Local_enuErrorState;
+	}
+
+	MCAL_SPI_EnableRxDMA(Local_SPIBaseAddr);
+
+	Local_enuErrorState = DMA_enuStartIT(Copy_pstrSPIHandle->pTxDMAHandle, MCAL_SPI_GetDataRegAddress(Local_SPIBaseAddr),
+			(Copy_pu8TxData != NULL)? (u32)Copy_pu8TxData : (u32)&spi_dma_dummy_tx, 0, (u16)Local_u32Frames);
+
+	if(Local_enuErrorState != ES_OK)
+	{
+		//nothing was clocked yet, the RX stream only has to be released
+		SPI_enuAbortDMA(Copy_pstrSPIHandle);
+		return Local_enuErrorState;
+	}
+
+	MCAL_SPI_EnableTxDMA(Local_SPIBaseAddr);
+
+	return Local_enuErrorState;
+}
+
+
+ES_t SPI_enuAbortDMA(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	if(Copy_pstrSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSPIHandle->RxState != SPI_BUSY_InDMA)
+		return ES_FUNC_IS_IDLE;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	MCAL_SPI_DisableTxDMA(Local_SPIBaseAddr);
+	MCAL_SPI_DisableRxDMA(Local_SPIBaseAddr);
+	MCAL_SPI_DisableRxInterrupt(Local_SPIBaseAddr);
+	MCAL_SPI_DisableErrInterrupt(Local_SPIBaseAddr);
+
+	DMA_enuStop(Copy_pstrSPIHandle->pTxDMAHandle);
+	DMA_enuStop(Copy_pstrSPIHandle->pRxDMAHandle);
+
+	//a frame already in DR would be shifted out with the next transfer, SPE off flushes it
+	MCAL_PSI_Disable(Local_SPIBaseAddr);
+	MCAL_SPI_ClearOVFLag(Local_SPIBaseAddr);
+	MCAL_PSI_Enable(Local_SPIBaseAddr);
+
+	Copy_pstrSPIHandle->TxState = SPI_Ready;
+	Copy_pstrSPIHandle->RxState = SPI_Ready;
+
+	return ES_OK;
+}
+
+
+ES_t SPI_enuCRCControl(SPI_Handle_t *Copy_pstrSPIHandle, u16 Copy_u16Polynomial, u8 Copy_u8EnOrDi)
+{
+	if(Copy_pstrSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSPIHandle->TxState != SPI_Ready || Copy_pstrSPIHandle->RxState != SPI_Ready)
+		return ES_FUNC_IS_BUSY;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	u8 Local_u8Enabled = MCAL_SPI_GetEnableStatus(Local_SPIBaseAddr);
+
+	while(MCAL_SPI_GetStatusInline(Local_SPIBaseAddr) & MCAL_SPI_BUSY_FLAG);
+	MCAL_PSI_Disable(Local_SPIBaseAddr);
+
+	if(Copy_u8EnOrDi == ENABLE)
+	{
+		MCAL_SPI_SetCRCPolynomial(Local_SPIBaseAddr, Copy_u16Polynomial);
+		MCAL_SPI_EnableCRC(Local_SPIBaseAddr);
+		Copy_pstrSPIHandle->CRCEnabled = 1;
+	}
+	else
+	{
+		MCAL_SPI_DisableCRC(Local_SPIBaseAddr);
+		Copy_pstrSPIHandle->CRCEnabled = 0;
+	}
+
+	MCAL_SPI_ClearCRCErrorFlag(Local_SPIBaseAddr);
+
+	if(Local_u8Enabled)
+	{
+		MCAL_PSI_Enable(Local_SPIBaseAddr);
+	}
+
+	return ES_OK;
+}
+
+
+ES_t SPI_enuGetCRCError(SPI_Handle_t *Copy_pstrSPIHandle, u8 *Copy_pu8CRCError)
+{
+	if(Copy_pstrSPIHandle==NULL || Copy_pu8CRCError==NULL)
+		return ES_NULL_PTR;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	*Copy_pu8CRCError = (MCAL_SPI_GetStatusInline(Local_SPIBaseAddr) & MCAL_SPI_CRCERR_FLAG)? 1 : 0;
+
+	MCAL_SPI_ClearCRCErrorFlag(Local_SPIBaseAddr);
+
+	return ES_OK;
+}
+
+
 ES_t SPI_enuSendDataIT(SPI_Handle_t *Copy_pstrSPIHandle,u8 *Copy_pu8Data, u32 Copy_u32Len, void(*CallBack)(void))
 {
 	ES_t Local_enuErrorState = ES_NOT_OK;
@@ -181,7 +420,14 @@ void SPI_IRQHandling(SPI_Handle_t *Copy_pstrSPIHandle)
 	if( temp1 && temp2)
 	{
 		//handle TXE
-		spi_txe_interrupt_handle(Copy_pstrSPIHandle);
+		if(Copy_pstrSPIHandle->TxState == SPI_BUSY_InHalfDuplex)
+		{
+			spi_hd_txe_interrupt_handle(Copy_pstrSPIHandle);
+		}
+		else
+		{
+			spi_txe_interrupt_handle(Copy_pstrSPIHandle);
+		}
 	}
 
 	// check for RXNE
@@ -190,7 +436,22 @@ void SPI_IRQHandling(SPI_Handle_t *Copy_pstrSPIHandle)
 	if( temp1 && temp2)
 	{
 		//handle RXNE
-		spi_rxne_interrupt_handle(Copy_pstrSPIHandle);
+		if(Copy_pstrSPIHandle->RxState == SPI_BUSY_InStream)
+		{
+			spi_stream_rxne_interrupt_handle(Copy_pstrSPIHandle);
+		}
+		else if(Copy_pstrSPIHandle->RxState == SPI_BUSY_InHalfDuplex)
+		{
+			spi_hd_rxne_interrupt_handle(Copy_pstrSPIHandle);
+		}
+		else if(Copy_pstrSPIHandle->RxState == SPI_BUSY_InDMA)
+		{
+			spi_dma_crc_rxne_interrupt_handle(Copy_pstrSPIHandle);
+		}
+		else
+		{
+			spi_rxne_interrupt_handle(Copy_pstrSPIHandle);
+		}
 	}
 
 	// check for ovr flag
@@ -229,7 +490,429 @@ ES_t SPI_enuStopReception(SPI_Handle_t *Copy_pstrSPIHandle)
 }
 
 
+ES_t SPI_enuSetDataFrameFormat(SPI_Handle_t *Copy_pstrSPIHandle, SPI_DFF_t Copy_enuDFF)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_enuDFF > SPI_DFF_16Bits)
+		return ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle->TxState != SPI_Ready || Copy_pstrSPIHandle->RxState != SPI_Ready)
+		return ES_FUNC_IS_BUSY;
+
+	if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF != Copy_enuDFF)
+	{
+		SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+		u8 Local_u8Enabled = MCAL_SPI_GetEnableStatus(Local_SPIBaseAddr);
+
+		//DFF may only be changed while SPE is cleared
+		while(MCAL_SPI_GetStatusInline(Local_SPIBaseAddr) & MCAL_SPI_BUSY_FLAG);
+		MCAL_PSI_Disable(Local_SPIBaseAddr);
+
+		MCAL_SPI_SetDataFrameFormate(Local_SPIBaseAddr, Copy_enuDFF);
+		Copy_pstrSPIHandle->SPIConfig.SPI_DFF = Copy_enuDFF;
+
+		if(Local_u8Enabled)
+		{
+			MCAL_PSI_Enable(Local_SPIBaseAddr);
+		}
+	}
+
+	Local_enuErrorState = ES_OK;
+
+	return Local_enuErrorState;
+}
+
+
+ES_t SPI_enuSetClkSpeed(SPI_Handle_t *Copy_pstrSPIHandle, SPI_SclkSpeed_t Copy_enuSclkSpeed)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_enuSclkSpeed > SPI_SclkSpeed_Div256)
+		return ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle->TxState != SPI_Ready || Copy_pstrSPIHandle->RxState != SPI_Ready)
+		return ES_FUNC_IS_BUSY;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	u8 Local_u8Enabled = MCAL_SPI_GetEnableStatus(Local_SPIBaseAddr);
+
+	while(MCAL_SPI_GetStatusInline(Local_SPIBaseAddr) & MCAL_SPI_BUSY_FLAG);
+	MCAL_PSI_Disable(Local_SPIBaseAddr);
+
+	MCAL_SPI_SetClkSpeed(Local_SPIBaseAddr, Copy_enuSclkSpeed);
+	Copy_pstrSPIHandle->SPIConfig.SPI_SclkSpeed = Copy_enuSclkSpeed;
+
+	if(Local_u8Enabled)
+	{
+		MCAL_PSI_Enable(Local_SPIBaseAddr);
+	}
+
+	Local_enuErrorState = ES_OK;
+
+	return Local_enuErrorState;
+}
+
+
+ES_t SPI_enuSlaveStreamStart(SPI_Handle_t *Copy_pstrSPIHandle, u8 *Copy_pu8Buffer0, u8 *Copy_pu8Buffer1,
+		u32 Copy_u32Len, void(*CallBack)(u8 *pBuffer, u32 Len))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle==NULL || Copy_pu8Buffer0==NULL || Copy_pu8Buffer1==NULL || CallBack==NULL )
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSPIHandle->RxState != SPI_Ready)
+		return ES_FUNC_IS_BUSY;
+
+	//each buffer must hold a whole number of frames
+	if(Copy_u32Len == 0 || (Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits && (Copy_u32Len & 1)))
+		return ES_NOT_OK;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	Copy_pstrSPIHandle->pStreamBuffer[0] = Copy_pu8Buffer0;
+	Copy_pstrSPIHandle->pStreamBuffer[1] = Copy_pu8Buffer1;
+	Copy_pstrSPIHandle->StreamLen = Copy_u32Len;
+	Copy_pstrSPIHandle->StreamCount = 0;
+	Copy_pstrSPIHandle->StreamActiveBuffer = 0;
+	Copy_pstrSPIHandle->StreamCallBackFunc = CallBack;
+	Copy_pstrSPIHandle->RxState = SPI_BUSY_InStream;
+
+	//drop any stale frame so the first buffer starts with the next master transaction
+	if(MCAL_SPI_GetFlagStatus(Local_SPIBaseAddr,MCAL_SPI_RXNE_FLAG))
+	{
+		(void)MCAL_SPI_Read(Local_SPIBaseAddr);
+	}
+
+	MCAL_SPI_EnableRxInterrupt(Local_SPIBaseAddr);
+	MCAL_SPI_EnableErrInterrupt(Local_SPIBaseAddr);
+
+	MCAL_PSI_Enable(Local_SPIBaseAddr);
+
+	Local_enuErrorState = ES_OK;
+
+	return Local_enuErrorState;
+}
+
+ES_t SPI_enuSlaveStreamSwap(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	if(Copy_pstrSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSPIHandle->RxState != SPI_BUSY_InStream)
+		return ES_FUNC_IS_IDLE;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	//keep the RXNE interrupt out while the buffers change hands
+	MCAL_SPI_DisableRxInterrupt(Local_SPIBaseAddr);
+
+	//the last frame of the transaction may still be waiting in DR
+	if(MCAL_SPI_GetFlagStatus(Local_SPIBaseAddr,MCAL_SPI_RXNE_FLAG))
+	{
+		spi_stream_rxne_interrupt_handle(Copy_pstrSPIHandle);
+	}
+
+	if(Copy_pstrSPIHandle->StreamCount > 0)
+	{
+		spi_stream_handoff(Copy_pstrSPIHandle);
+	}
+
+	MCAL_SPI_EnableRxInterrupt(Local_SPIBaseAddr);
+
+	return ES_OK;
+}
+
+ES_t SPI_enuSlaveStreamStop(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	if(Copy_pstrSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	//an IT, DMA or half-duplex reception is not ended from here
+	if(Copy_pstrSPIHandle->RxState != SPI_BUSY_InStream)
+		return ES_FUNC_IS_IDLE;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+	MCAL_SPI_DisableRxInterrupt(Local_SPIBaseAddr);
+	MCAL_SPI_DisableErrInterrupt(Local_SPIBaseAddr);
+	Copy_pstrSPIHandle->RxState = SPI_Ready;
+	Copy_pstrSPIHandle->pStreamBuffer[0] = NULL;
+	Copy_pstrSPIHandle->pStreamBuffer[1] = NULL;
+	Copy_pstrSPIHandle->StreamLen = 0;
+	Copy_pstrSPIHandle->StreamCount = 0;
+	Copy_pstrSPIHandle->StreamCallBackFunc = NULL;
+
+	return ES_OK;
+}
+
+
+ES_t SPI_enuTriggeredRxStart(SPI_Handle_t *Copy_pstrSPIHandle, DMA_Handle_t *Copy_pstrTrigDMAHandle,
+		u8 *Copy_pu8Buffer, u32 Copy_u32Len, void(*CallBack)(u8 *pBuffer, u32 Len))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle==NULL || Copy_pstrTrigDMAHandle==NULL || Copy_pu8Buffer==NULL || CallBack==NULL ||
+			Copy_pstrSPIHandle->pRxDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSPIHandle->SPIConfig.SPI_DeviceMode != SPI_DeviceModeMaster)
+		return ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle->TxState != SPI_Ready || Copy_pstrSPIHandle->RxState != SPI_Ready)
+		return ES_FUNC_IS_BUSY;
+
+	u32 Local_u32FrameSize = (Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits)? 2 : 1;
+	u32 Local_u32Frames = Copy_u32Len / Local_u32FrameSize;
+
+	//two equal halves, each a whole number of frames
+	if(Copy_u32Len % (2 * Local_u32FrameSize) || Local_u32Frames == 0 || Local_u32Frames > 0xFFFF)
+		return ES_NOT_OK;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	Copy_pstrSPIHandle->pTrigDMAHandle = Copy_pstrTrigDMAHandle;
+	Copy_pstrSPIHandle->pStreamBuffer[0] = Copy_pu8Buffer;
+	Copy_pstrSPIHandle->StreamLen = Copy_u32Len;
+	Copy_pstrSPIHandle->StreamCallBackFunc = CallBack;
+	Copy_pstrSPIHandle->TxState = SPI_BUSY_InTriggeredRx;
+	Copy_pstrSPIHandle->RxState = SPI_BUSY_InTriggeredRx;
+
+	//1. circular reception with half / complete interrupts
+	spi_dma_config(Copy_pstrSPIHandle->pRxDMAHandle, DMA_Dir_PeriphToMem, Copy_pstrSPIHandle->SPIConfig.SPI_DFF,
+			DMA_Inc_Enable, DMA_Mode_Circular);
+
+	if(MCAL_SPI_GetStatusInline(Local_SPIBaseAddr) & MCAL_SPI_RXNE_FLAG)
+	{
+		(void)MCAL_SPI_ReadInline(Local_SPIBaseAddr);
+	}
+
+	Local_enuErrorState = DMA_enuStartIT(Copy_pstrSPIHandle->pRxDMAHandle, MCAL_SPI_GetDataRegAddress(Local_SPIBaseAddr),
+			(u32)Copy_pu8Buffer, 0, (u16)Local_u32Frames);
+
+	if(Local_enuErrorState != ES_OK)
+	{
+		Copy_pstrSPIHandle->TxState = SPI_Ready;
+		Copy_pstrSPIHandle->RxState = SPI_Ready;
+		return Local_enuErrorState;
+	}
+
+	MCAL_SPI_EnableRxDMA(Local_SPIBaseAddr);
+	MCAL_SPI_EnableErrInterrupt(Local_SPIBaseAddr);
+
+	//2. one dummy frame per request written straight to DR, no interrupt so the CPU is never involved
+	spi_dma_config(Copy_pstrTrigDMAHandle, DMA_Dir_MemToPeriph, Copy_pstrSPIHandle->SPIConfig.SPI_DFF,
+			DMA_Inc_Disable, DMA_Mode_Circular);
+
+	Local_enuErrorState = DMA_enuStart(Copy_pstrTrigDMAHandle, MCAL_SPI_GetDataRegAddress(Local_SPIBaseAddr),
+			(u32)&spi_dma_dummy_tx, 0, 1);
+
+	if(Local_enuErrorState != ES_OK)
+	{
+		//no request would ever come, release the reception
+		SPI_enuTriggeredRxStop(Copy_pstrSPIHandle);
+		return Local_enuErrorState;
+	}
+
+	MCAL_PSI_Enable(Local_SPIBaseAddr);
+
+	return Local_enuErrorState;
+}
+
+
+ES_t SPI_enuTriggeredRxStop(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	if(Copy_pstrSPIHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrSPIHandle->RxState != SPI_BUSY_InTriggeredRx)
+		return ES_FUNC_IS_IDLE;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	DMA_enuStop(Copy_pstrSPIHandle->pTrigDMAHandle);
+
+	while(MCAL_SPI_GetStatusInline(Local_SPIBaseAddr) & MCAL_SPI_BUSY_FLAG);
+
+	DMA_enuStop(Copy_pstrSPIHandle->pRxDMAHandle);
+	MCAL_SPI_DisableRxDMA(Local_SPIBaseAddr);
+	MCAL_SPI_DisableErrInterrupt(Local_SPIBaseAddr);
+
+	if(MCAL_SPI_GetStatusInline(Local_SPIBaseAddr) & MCAL_SPI_RXNE_FLAG)
+	{
+		(void)MCAL_SPI_ReadInline(Local_SPIBaseAddr);
+	}
+
+	Copy_pstrSPIHandle->TxState = SPI_Ready;
+	Copy_pstrSPIHandle->RxState = SPI_Ready;
+
+	return ES_OK;
+}
+
+
+ES_t SPI_enuHalfDuplexTransaction(SPI_Handle_t *Copy_pstrSPIHandle, u8 *Copy_pu8Cmd, u32 Copy_u32CmdLen,
+		u8 *Copy_pu8RxData, u32 Copy_u32RxLen, SPI_XferMode_t Copy_enuRxMode, void(*CallBack)(void))
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle==NULL || CallBack==NULL || (Copy_u32CmdLen && Copy_pu8Cmd==NULL) ||
+			(Copy_u32RxLen && Copy_pu8RxData==NULL))
+		return ES_NULL_PTR;
+
+	if(Copy_enuRxMode == SPI_XferMode_DMA && Copy_pstrSPIHandle->pRxDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	//the master owns the clock, so only it can time the turn-around
+	if(Copy_pstrSPIHandle->SPIConfig.SPI_BusConfig != SPI_BusConfig_HD ||
+			Copy_pstrSPIHandle->SPIConfig.SPI_DeviceMode != SPI_DeviceModeMaster)
+		return ES_NOT_OK;
+
+	if(Copy_pstrSPIHandle->TxState != SPI_Ready || Copy_pstrSPIHandle->RxState != SPI_Ready)
+		return ES_FUNC_IS_BUSY;
+
+	if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits && ((Copy_u32CmdLen | Copy_u32RxLen) & 1))
+		return ES_NOT_OK;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	Copy_pstrSPIHandle->pTxBuffer = Copy_pu8Cmd;
+	Copy_pstrSPIHandle->TxLen = Copy_u32CmdLen;
+	Copy_pstrSPIHandle->pRxBuffer = Copy_pu8RxData;
+	Copy_pstrSPIHandle->RxLen = Copy_u32RxLen;
+	Copy_pstrSPIHandle->HDRxMode = Copy_enuRxMode;
+	Copy_pstrSPIHandle->RxCallBackFunc = CallBack;
+	Copy_pstrSPIHandle->TxState = SPI_BUSY_InHalfDuplex;
+	Copy_pstrSPIHandle->RxState = SPI_BUSY_InHalfDuplex;
+
+	if(Copy_u32CmdLen > 0)
+	{
+		//1. drive the data line and send the command from TXE interrupt
+		MCAL_PSI_Disable(Local_SPIBaseAddr);
+		MCAL_SPI_SetBidiOutput(Local_SPIBaseAddr, ENABLE);
+		MCAL_PSI_Enable(Local_SPIBaseAddr);
+		MCAL_SPI_EnableTxInterrupt(Local_SPIBaseAddr);
+	}
+	else
+	{
+		spi_hd_start_reception(Copy_pstrSPIHandle);
+	}
+
+	Local_enuErrorState = ES_OK;
+
+	return Local_enuErrorState;
+}
+
+
+void SPI_DMA_IRQHandling(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	u8 Local_u8Events = 0;
+
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	if(Copy_pstrSPIHandle->pRxDMAHandle != NULL &&
+			DMA_enuGetAndClearEvents(Copy_pstrSPIHandle->pRxDMAHandle, &Local_u8Events) == ES_OK)
+	{
+		if((Local_u8Events & DMA_EVENT_MASK(DMA_Event_TransferComplete)) &&
+				Copy_pstrSPIHandle->RxState == SPI_BUSY_InHalfDuplex)
+		{
+			//DMA moved all frames but the last one, the last one is taken by RXNE interrupt
+			u32 Local_u32FrameSize = (Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits)? 2 : 1;
+
+			MCAL_SPI_DisableRxDMA(Local_SPIBaseAddr);
+
+			Copy_pstrSPIHandle->pRxBuffer += Copy_pstrSPIHandle->RxLen - Local_u32FrameSize;
+			Copy_pstrSPIHandle->RxLen = Local_u32FrameSize;
+
+			spi_hd_stop_clock(Copy_pstrSPIHandle);
+
+			MCAL_SPI_EnableRxInterrupt(Local_SPIBaseAddr);
+		}
+
+		else if(Copy_pstrSPIHandle->RxState == SPI_BUSY_InTriggeredRx)
+		{
+			u32 Local_u32Half = Copy_pstrSPIHandle->StreamLen / 2;
+
+			if(Local_u8Events & DMA_EVENT_MASK(DMA_Event_HalfTransfer))
+			{
+				Copy_pstrSPIHandle->StreamCallBackFunc(Copy_pstrSPIHandle->pStreamBuffer[0], Local_u32Half);
+			}
+
+			if(Local_u8Events & DMA_EVENT_MASK(DMA_Event_TransferComplete))
+			{
+				Copy_pstrSPIHandle->StreamCallBackFunc(Copy_pstrSPIHandle->pStreamBuffer[0] + Local_u32Half, Local_u32Half);
+			}
+		}
+		else if((Local_u8Events & DMA_EVENT_MASK(DMA_Event_TransferComplete)) &&
+				Copy_pstrSPIHandle->RxState == SPI_BUSY_InDMA)
+		{
+			//the last RX frame implies the last TX frame left the shift register
+			MCAL_SPI_DisableRxDMA(Local_SPIBaseAddr);
+			MCAL_SPI_DisableTxDMA(Local_SPIBaseAddr);
+
+			if(Copy_pstrSPIHandle->CRCEnabled)
+			{
+				//the CRC frame follows the data, it is read from the RXNE interrupt (at once if already there)
+				MCAL_SPI_EnableRxInterrupt(Local_SPIBaseAddr);
+			}
+			else
+			{
+				spi_dma_done(Copy_pstrSPIHandle);
+			}
+		}
+
+		if((Local_u8Events & DMA_EVENT_MASK(DMA_Event_TransferError)) && Copy_pstrSPIHandle->ErrorCallBackFunc != NULL)
+		{
+			Copy_pstrSPIHandle->ErrorCallBackFunc();
+		}
+	}
+
+	//TX stream completion carries no information, only errors are reported
+	if(Copy_pstrSPIHandle->pTxDMAHandle != NULL &&
+			DMA_enuGetAndClearEvents(Copy_pstrSPIHandle->pTxDMAHandle, &Local_u8Events) == ES_OK)
+	{
+		if((Local_u8Events & DMA_EVENT_MASK(DMA_Event_TransferError)) && Copy_pstrSPIHandle->ErrorCallBackFunc != NULL)
+		{
+			Copy_pstrSPIHandle->ErrorCallBackFunc();
+		}
+	}
+}
+
+
 //some helper function implementations
+
+/*
+ * CRC frame of a SPI_enuTransceiveDMA transfer, reading it flushes RXNE and latches CRCERR.
+ * A slave whose master never clocks it stays busy until SPI_enuAbortDMA.
+ */
+static void  spi_dma_crc_rxne_interrupt_handle(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	MCAL_SPI_DisableRxInterrupt(Local_SPIBaseAddr);
+	(void)MCAL_SPI_ReadInline(Local_SPIBaseAddr);
+
+	spi_dma_done(Copy_pstrSPIHandle);
+}
+
+static void  spi_dma_done(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	MCAL_SPI_DisableErrInterrupt(Local_SPIBaseAddr);
+
+	Copy_pstrSPIHandle->TxState = SPI_Ready;
+	Copy_pstrSPIHandle->RxState = SPI_Ready;
+	Copy_pstrSPIHandle->RxCallBackFunc();
+}
+
 static void  spi_txe_interrupt_handle(SPI_Handle_t *Copy_pstrSPIHandle)
 {
 
@@ -271,18 +954,18 @@ static void  spi_rxne_interrupt_handle(SPI_Handle_t *Copy_pstrSPIHandle)
 	if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits)
 	{
 		*((u16*)Copy_pstrSPIHandle->pRxBuffer) = MCAL_SPI_Read(Local_SPIBaseAddr);
-		Copy_pstrSPIHandle->TxLen--;
-		Copy_pstrSPIHandle->TxLen--;
-		(u16*)Copy_pstrSPIHandle->pTxBuffer++;
+		Copy_pstrSPIHandle->RxLen--;
+		Copy_pstrSPIHandle->RxLen--;
+		Copy_pstrSPIHandle->pRxBuffer += 2;
 	}
 	else if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_8Bits)
 	{
 		*Copy_pstrSPIHandle->pRxBuffer = MCAL_SPI_Read(Local_SPIBaseAddr);
-		Copy_pstrSPIHandle->TxLen--;
-		Copy_pstrSPIHandle->pTxBuffer++;
+		Copy_pstrSPIHandle->RxLen--;
+		Copy_pstrSPIHandle->pRxBuffer++;
 	}
 
-	if(Copy_pstrSPIHandle->TxLen == 0)
+	if(Copy_pstrSPIHandle->RxLen == 0)
 	{
 		MCAL_SPI_DisableRxInterrupt(Local_SPIBaseAddr);
 		Copy_pstrSPIHandle->RxState = SPI_Ready;
@@ -294,12 +977,266 @@ static void  spi_rxne_interrupt_handle(SPI_Handle_t *Copy_pstrSPIHandle)
 
 static void  spi_ovr_err_interrupt_handle(SPI_Handle_t *Copy_pstrSPIHandle)
 {
-	if(Copy_pstrSPIHandle->TxState == SPI_BUSY_InTx)
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	//OVR blocks any further reception whatever the mode, DR then SR read clears it
+	MCAL_SPI_ClearOVFLag(Local_SPIBaseAddr);
+
+	if(Copy_pstrSPIHandle->ErrorCallBackFunc != NULL)
 	{
-		SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
-		MCAL_SPI_ClearOVFLag(Local_SPIBaseAddr);
 		Copy_pstrSPIHandle->ErrorCallBackFunc();
 	}
 }
 
 
+static void  spi_stream_rxne_interrupt_handle(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	u8 *Local_pu8Buffer = Copy_pstrSPIHandle->pStreamBuffer[Copy_pstrSPIHandle->StreamActiveBuffer];
+
+	if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits)
+	{
+		*((u16*)&Local_pu8Buffer[Copy_pstrSPIHandle->StreamCount]) = MCAL_SPI_Read(Local_SPIBaseAddr);
+		Copy_pstrSPIHandle->StreamCount += 2;
+	}
+	else if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_8Bits)
+	{
+		Local_pu8Buffer[Copy_pstrSPIHandle->StreamCount] = (u8)MCAL_SPI_Read(Local_SPIBaseAddr);
+		Copy_pstrSPIHandle->StreamCount++;
+	}
+
+	if(Copy_pstrSPIHandle->StreamCount >= Copy_pstrSPIHandle->StreamLen)
+	{
+		spi_stream_handoff(Copy_pstrSPIHandle);
+	}
+}
+
+static void  spi_stream_handoff(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	u8 *Local_pu8Filled = Copy_pstrSPIHandle->pStreamBuffer[Copy_pstrSPIHandle->StreamActiveBuffer];
+	u32 Local_u32Len = Copy_pstrSPIHandle->StreamCount;
+
+	//switch reception to the other buffer first, the next frame may arrive while the application runs
+	Copy_pstrSPIHandle->StreamActiveBuffer ^= 1;
+	Copy_pstrSPIHandle->StreamCount = 0;
+
+	Copy_pstrSPIHandle->StreamCallBackFunc(Local_pu8Filled, Local_u32Len);
+}
+
+
+static void  spi_hd_txe_interrupt_handle(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits)
+	{
+		MCAL_SPI_Write(Local_SPIBaseAddr,*((u16*)Copy_pstrSPIHandle->pTxBuffer));
+		Copy_pstrSPIHandle->TxLen -= 2;
+		Copy_pstrSPIHandle->pTxBuffer += 2;
+	}
+	else
+	{
+		MCAL_SPI_Write(Local_SPIBaseAddr,*Copy_pstrSPIHandle->pTxBuffer);
+		Copy_pstrSPIHandle->TxLen--;
+		Copy_pstrSPIHandle->pTxBuffer++;
+	}
+
+	if(Copy_pstrSPIHandle->TxLen == 0)
+	{
+		MCAL_SPI_DisableTxInterrupt(Local_SPIBaseAddr);
+
+		//2. the line may only be turned around once the last command frame left the shift register,
+		//   this is at most one frame time and there is no interrupt for BSY
+		while( ! MCAL_SPI_GetFlagStatus(Local_SPIBaseAddr,MCAL_SPI_TXE_FLAG));
+		while( MCAL_SPI_GetFlagStatus(Local_SPIBaseAddr,MCAL_SPI_BUSY_FLAG));
+
+		spi_hd_start_reception(Copy_pstrSPIHandle);
+	}
+}
+
+static void  spi_hd_start_reception(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	u32 Local_u32FrameSize = (Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits)? 2 : 1;
+
+	//3. release the data line, in bidirectional receive mode the master clocks as long as SPE is set
+	MCAL_PSI_Disable(Local_SPIBaseAddr);
+	MCAL_SPI_SetBidiOutput(Local_SPIBaseAddr, DISABLE);
+	Copy_pstrSPIHandle->TxState = SPI_Ready;
+
+	if(Copy_pstrSPIHandle->RxLen == 0)
+	{
+		Copy_pstrSPIHandle->RxState = SPI_Ready;
+		Copy_pstrSPIHandle->RxCallBackFunc();
+		return;
+	}
+
+	if(Copy_pstrSPIHandle->HDRxMode == SPI_XferMode_DMA && Copy_pstrSPIHandle->RxLen > Local_u32FrameSize)
+	{
+		DMA_Handle_t *Local_pstrDMAHandle = Copy_pstrSPIHandle->pRxDMAHandle;
+
+		spi_dma_config(Local_pstrDMAHandle, DMA_Dir_PeriphToMem, Copy_pstrSPIHandle->SPIConfig.SPI_DFF, DMA_Inc_Enable, DMA_Mode_Normal);
+
+		//all frames but the last one, SPE must be cleared while the last frame is being received
+		if(DMA_enuStartIT(Local_pstrDMAHandle, MCAL_SPI_GetDataRegAddress(Local_SPIBaseAddr),
+				(u32)Copy_pstrSPIHandle->pRxBuffer, 0,
+				(u16)((Copy_pstrSPIHandle->RxLen / Local_u32FrameSize) - 1)) != ES_OK)
+		{
+			//SPE stays cleared, the master would clock with nobody reading
+			Copy_pstrSPIHandle->RxState = SPI_Ready;
+			Copy_pstrSPIHandle->RxLen = 0;
+			Copy_pstrSPIHandle->pRxBuffer = NULL;
+
+			if(Copy_pstrSPIHandle->ErrorCallBackFunc != NULL)
+			{
+				Copy_pstrSPIHandle->ErrorCallBackFunc();
+			}
+			return;
+		}
+
+		MCAL_SPI_EnableRxDMA(Local_SPIBaseAddr);
+		MCAL_PSI_Enable(Local_SPIBaseAddr);
+	}
+	else
+	{
+		MCAL_SPI_EnableRxInterrupt(Local_SPIBaseAddr);
+		MCAL_PSI_Enable(Local_SPIBaseAddr);
+
+		if(Copy_pstrSPIHandle->RxLen == Local_u32FrameSize)
+		{
+			spi_hd_stop_clock(Copy_pstrSPIHandle);
+		}
+	}
+}
+
+static void  spi_hd_rxne_interrupt_handle(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	if(Copy_pstrSPIHandle->SPIConfig.SPI_DFF == SPI_DFF_16Bits)
+	{
+		*((u16*)Copy_pstrSPIHandle->pRxBuffer) = MCAL_SPI_Read(Local_SPIBaseAddr);
+		Copy_pstrSPIHandle->RxLen -= 2;
+		Copy_pstrSPIHandle->pRxBuffer += 2;
+
+		if(Copy_pstrSPIHandle->RxLen == 2)
+		{
+			spi_hd_stop_clock(Copy_pstrSPIHandle);
+		}
+	}
+	else
+	{
+		*Copy_pstrSPIHandle->pRxBuffer = (u8)MCAL_SPI_Read(Local_SPIBaseAddr);
+		Copy_pstrSPIHandle->RxLen--;
+		Copy_pstrSPIHandle->pRxBuffer++;
+
+		if(Copy_pstrSPIHandle->RxLen == 1)
+		{
+			spi_hd_stop_clock(Copy_pstrSPIHandle);
+		}
+	}
+
+	if(Copy_pstrSPIHandle->RxLen == 0)
+	{
+		MCAL_SPI_DisableRxInterrupt(Local_SPIBaseAddr);
+		Copy_pstrSPIHandle->RxState = SPI_Ready;
+		Copy_pstrSPIHandle->pRxBuffer = NULL;
+		Copy_pstrSPIHandle->RxCallBackFunc();
+	}
+}
+
+/*
+ * Bidirectional receive procedure (RM0090 "Disabling the SPI"): after the second to last RXNE,
+ * wait one SPI clock cycle then clear SPE so the master stops clocking after the last frame.
+ */
+static void  spi_hd_stop_clock(SPI_Handle_t *Copy_pstrSPIHandle)
+{
+	SPI_RegDef_t *Local_SPIBaseAddr = MCAL_SPI_CODE_TO_BASADDR(Copy_pstrSPIHandle->SPIx);
+
+	//one SCK period is 2^(BR+1) APB cycles, the CPU runs at least as fast as the APB
+	for(__vo u32 Local_u32Count = (4UL << MCAL_SPI_GetClkSpeed(Local_SPIBaseAddr)) ; Local_u32Count > 0 ; Local_u32Count--);
+
+	MCAL_PSI_Disable(Local_SPIBaseAddr);
+}
+
+
+/*
+ * Burst loops: a frame is written as soon as TXE is set while at most two frames are in flight
+ * (one in the shift register and one waiting in DR), so the clock never idles between frames
+ * and RX can never be overrun.
+ */
+static void  spi_burst_xfer_8bit(SPI_RegDef_t *pSPIx, u8 *pTxData, u8 *pRxData, u32 Frames)
+{
+	u32 Local_u32TxLeft = Frames;
+	u32 Local_u32RxLeft = Frames;
+	u32 Local_u32Status;
+
+	while(Local_u32RxLeft > 0)
+	{
+		Local_u32Status = MCAL_SPI_GetStatusInline(pSPIx);
+
+		if((Local_u32Status & MCAL_SPI_TXE_FLAG) && Local_u32TxLeft > 0 && (Local_u32RxLeft - Local_u32TxLeft) < 2)
+		{
+			MCAL_SPI_WriteInline(pSPIx, (pTxData != NULL)? *pTxData++ : 0xFF);
+			Local_u32TxLeft--;
+		}
+
+		if(Local_u32Status & MCAL_SPI_RXNE_FLAG)
+		{
+			u8 Local_u8Data = (u8)MCAL_SPI_ReadInline(pSPIx);
+
+			if(pRxData != NULL)
+			{
+				*pRxData++ = Local_u8Data;
+			}
+			Local_u32RxLeft--;
+		}
+	}
+}
+
+static void  spi_burst_xfer_16bit(SPI_RegDef_t *pSPIx, u8 *pTxData, u8 *pRxData, u32 Frames)
+{
+	u16 *Local_pu16TxData = (u16*)pTxData;
+	u16 *Local_pu16RxData = (u16*)pRxData;
+	u32 Local_u32TxLeft = Frames;
+	u32 Local_u32RxLeft = Frames;
+	u32 Local_u32Status;
+
+	while(Local_u32RxLeft > 0)
+	{
+		Local_u32Status = MCAL_SPI_GetStatusInline(pSPIx);
+
+		if((Local_u32Status & MCAL_SPI_TXE_FLAG) && Local_u32TxLeft > 0 && (Local_u32RxLeft - Local_u32TxLeft) < 2)
+		{
+			MCAL_SPI_WriteInline(pSPIx, (Local_pu16TxData != NULL)? *Local_pu16TxData++ : 0xFFFF);
+			Local_u32TxLeft--;
+		}
+
+		if(Local_u32Status & MCAL_SPI_RXNE_FLAG)
+		{
+			u16 Local_u16Data = MCAL_SPI_ReadInline(pSPIx);
+
+			if(Local_pu16RxData != NULL)
+			{
+				*Local_pu16RxData++ = Local_u16Data;
+			}
+			Local_u32RxLeft--;
+		}
+	}
+}
+
+static void  spi_dma_config(DMA_Handle_t *Copy_pstrDMAHandle, DMA_Direction_t Copy_enuDirection, SPI_DFF_t Copy_enuDFF,
+		DMA_IncCtrl_t Copy_enuMemInc, DMA_Mode_t Copy_enuMode)
+{
+	Copy_pstrDMAHandle->DMAConfig.DMA_Direction = Copy_enuDirection;
+	Copy_pstrDMAHandle->DMAConfig.DMA_PeriphDataSize = (Copy_enuDFF == SPI_DFF_16Bits)? DMA_DataSize_HalfWord : DMA_DataSize_Byte;
+	Copy_pstrDMAHandle->DMAConfig.DMA_MemDataSize = Copy_pstrDMAHandle->DMAConfig.DMA_PeriphDataSize;
+	Copy_pstrDMAHandle->DMAConfig.DMA_PeriphInc = DMA_Inc_Disable;
+	Copy_pstrDMAHandle->DMAConfig.DMA_MemInc = Copy_enuMemInc;
+	Copy_pstrDMAHandle->DMAConfig.DMA_Mode = Copy_enuMode;
+	Copy_pstrDMAHandle->DMAConfig.DMA_Priority = DMA_Priority_High;
+
+	DMA_enuInit(Copy_pstrDMAHandle);
+}
@@ -0,0 +1,202 @@
+/**
+ ******************************************************************************
+ ******************************************************************************
+ * @file           : stm32fxxxx_tim.c
+ * @author         : Rezk Ahmed
+ * @Layer          : ECU / Board
+ * @brief          : For control across the entire STM32F4x family,
+ *                   this layer is not aware of specific hardware information
+ *                   such as register addresses.
+ *                   It utilizes all peripherals through MCAL APIs.
+ ******************************************************************************
+ ******************************************************************************
+ */
+#include "std_types.h"
+#include "bit_math.h"
+#include "error_state.h"
+
+#include "stm32f407x_tim.h"
+#include "stm32f4xxx_tim.h"
+
+
+ES_t TIM_enuInit(TIM_Handle_t *Copy_pstrTIMHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrTIMHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrTIMHandle->TIMx > TIM_14)
+		return ES_NOT_OK;
+
+	//only TIM2 and TIM5 have 32 bits counters
+	if(Copy_pstrTIMHandle->TIMx != TIM_2 && Copy_pstrTIMHandle->TIMx != TIM_5 &&
+			Copy_pstrTIMHandle->TIMConfig.TIM_Period > 0xFFFF)
+		return ES_NOT_OK;
+
+	TIM_RegDef_t *Local_TIMBaseAddr = MCAL_TIM_CODE_TO_BASADDR(Copy_pstrTIMHandle->TIMx);
+
+	MCAL_TIM_Disable(Local_TIMBaseAddr);
+
+	MCAL_TIM_SetPrescaler(Local_TIMBaseAddr, Copy_pstrTIMHandle->TIMConfig.TIM_Prescaler);
+
+	MCAL_TIM_SetAutoReload(Local_TIMBaseAddr, Copy_pstrTIMHandle->TIMConfig.TIM_Period);
+
+	MCAL_TIM_EnableAutoReloadPreload(Local_TIMBaseAddr);
+
+	MCAL_TIM_SetCounter(Local_TIMBaseAddr, 0);
+
+	//PSC is only loaded on an update event
+	MCAL_TIM_GenerateUpdate(Local_TIMBaseAddr);
+	MCAL_TIM_ClearFlag(Local_TIMBaseAddr, MCAL_TIM_UPDATE_FLAG);
+
+	Local_enuErrorState = ES_OK;
+
+	return Local_enuErrorState;
+}
+
+
+ES_t TIM_enuStart(TIM_Handle_t *Copy_pstrTIMHandle)
+{
+	if(Copy_pstrTIMHandle==NULL)
+		return ES_NULL_PTR;
+
+	TIM_RegDef_t *Local_TIMBaseAddr = MCAL_TIM_CODE_TO_BASADDR(Copy_pstrTIMHandle->TIMx);
+
+	MCAL_TIM_Enable(Local_TIMBaseAddr);
+
+	return ES_OK;
+}
+
+
+ES_t TIM_enuStop(TIM_Handle_t *Copy_pstrTIMHandle)
+{
+	if(Copy_pstrTIMHandle==NULL)
+		return ES_NULL_PTR;
+
+	TIM_RegDef_t *Local_TIMBaseAddr = MCAL_TIM_CODE_TO_BASADDR(Copy_pstrTIMHandle->TIMx);
+
+	MCAL_TIM_Disable(Local_TIMBaseAddr);
+	MCAL_TIM_DisableUpdateInterrupt(Local_TIMBaseAddr);
+
+	return ES_OK;
+}
+
+
+ES_t TIM_enuStartIT(TIM_Handle_t *Copy_pstrTIMHandle, void (*CallBack)(void))
+{
+	if(Copy_pstrTIMHandle==NULL || CallBack==NULL)
+		return ES_NULL_PTR;
+
+	TIM_RegDef_t *Local_TIMBaseAddr = MCAL_TIM_CODE_TO_BASADDR(Copy_pstrTIMHandle->TIMx);
+
+	Copy_pstrTIMHandle->UpdateCallBackFunc = CallBack;
+
+	MCAL_TIM_ClearFlag(Local_TIMBaseAddr, MCAL_TIM_UPDATE_FLAG);
+	MCAL_TIM_EnableUpdateInterrupt(Local_TIMBaseAddr);
+	MCAL_TIM_Enable(Local_TIMBaseAddr);
+
+	return ES_OK;
+}
+
+
+ES_t TIM_enuConfigOutputCompare(TIM_Handle_t *Copy_pstrTIMHandle, TIM_Channel_t Copy_enuChannel,
+		TIM_OCMode_t Copy_enuMode, TIM_OCPolarity_t Copy_enuPolarity, u32 Copy_u32Pulse)
+{
+	if(Copy_pstrTIMHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_enuChannel > TIM_Channel4 || Copy_enuMode > TIM_OCMode_PWM2 || Copy_enuPolarity > TIM_OCPolarity_Low)
+		return ES_NOT_OK;
+
+	//basic timers have no channels
+	if(Copy_pstrTIMHandle->TIMx == TIM_6 || Copy_pstrTIMHandle->TIMx == TIM_7)
+		return ES_NOT_OK;
+
+	TIM_RegDef_t *Local_TIMBaseAddr = MCAL_TIM_CODE_TO_BASADDR(Copy_pstrTIMHandle->TIMx);
+
+	MCAL_TIM_DisableChannel(Local_TIMBaseAddr, Copy_enuChannel);
+
+	MCAL_TIM_SetOutputCompareMode(Local_TIMBaseAddr, Copy_enuChannel, Copy_enuMode);
+
+	MCAL_TIM_SetOutputPolarity(Local_TIMBaseAddr, Copy_enuChannel, Copy_enuPolarity);
+
+	MCAL_TIM_SetCompare(Local_TIMBaseAddr, Copy_enuChannel, Copy_u32Pulse);
+
+	MCAL_TIM_EnableChannel(Local_TIMBaseAddr, Copy_enuChannel);
+
+	if(MCAL_TIM_IS_ADVANCED(Local_TIMBaseAddr))
+	{
+		MCAL_TIM_EnableMainOutput(Local_TIMBaseAddr);
+	}
+
+	return ES_OK;
+}
+
+
+ES_t TIM_enuSetCompare(TIM_Handle_t *Copy_pstrTIMHandle, TIM_Channel_t Copy_enuChannel, u32 Copy_u32Pulse)
+{
+	if(Copy_pstrTIMHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_enuChannel > TIM_Channel4)
+		return ES_NOT_OK;
+
+	TIM_RegDef_t *Local_TIMBaseAddr = MCAL_TIM_CODE_TO_BASADDR(Copy_pstrTIMHandle->TIMx);
+
+	MCAL_TIM_SetCompare(Local_TIMBaseAddr, Copy_enuChannel, Copy_u32Pulse);
+
+	return ES_OK;
+}
+
+
+ES_t TIM_enuDisableOutputCompare(TIM_Handle_t *Copy_pstrTIMHandle, TIM_Channel_t Copy_enuChannel)
+{
+	if(Copy_pstrTIMHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_enuChannel > TIM_Channel4)
+		return ES_NOT_OK;
+
+	TIM_RegDef_t *Local_TIMBaseAddr = MCAL_TIM_CODE_TO_BASADDR(Copy_pstrTIMHandle->TIMx);
+
+	MCAL_TIM_DisableChannel(Local_TIMBaseAddr, Copy_enuChannel);
+
+	return ES_OK;
+}
+
+
+ES_t TIM_enuUpdateDMAControl(TIM_Handle_t *Copy_pstrTIMHandle, u8 Copy_u8EnOrDi)
+{
+	if(Copy_pstrTIMHandle==NULL)
+		return ES_NULL_PTR;
+
+	TIM_RegDef_t *Local_TIMBaseAddr = MCAL_TIM_CODE_TO_BASADDR(Copy_pstrTIMHandle->TIMx);
+
+	if(Copy_u8EnOrDi == ENABLE)
+	{
+		MCAL_TIM_EnableUpdateDMA(Local_TIMBaseAddr);
+	}
+	else
+	{
+		MCAL_TIM_DisableUpdateDMA(Local_TIMBaseAddr);
+	}
+
+	return ES_OK;
+}
+
+
+void TIM_IRQHandling(TIM_Handle_t *Copy_pstrTIMHandle)
+{
+	TIM_RegDef_t *Local_TIMBaseAddr = MCAL_TIM_CODE_TO_BASADDR(Copy_pstrTIMHandle->TIMx);
+
+	if(MCAL_TIM_GetFlagStatus(Local_TIMBaseAddr, MCAL_TIM_UPDATE_FLAG))
+	{
+		MCAL_TIM_ClearFlag(Local_TIMBaseAddr, MCAL_TIM_UPDATE_FLAG);
+
+		if(Copy_pstrTIMHandle->UpdateCallBackFunc != NULL)
+		{
+			Copy_pstrTIMHandle->UpdateCallBackFunc();
+		}
+	}
+}
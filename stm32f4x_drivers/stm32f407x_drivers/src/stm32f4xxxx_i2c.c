@@ -16,14 +16,61 @@
 #include "error_state.h"
 
 #include "stm32f407x_i2c.h"
+#include "stm32f4xxx_gpio_exti.h"
+#include "stm32f4xxx_dma.h"
 #include "stm32f4xxx_i2c.h"
 
 #include "stm32f4xxx_rcc.h"
+#include "cortexm4_systick.h"
+#include "cortex_m4.h"
 
 
 static void I2C_ClearADDRFlag(I2C_Handle_t *Copy_pstrI2CHandle );
 static void I2C_MasterHandleTXEInterrupt(I2C_Handle_t *Copy_pstrI2CHandle);
 static void I2C_MasterHandleRXNEInterrupt(I2C_Handle_t *Copy_pstrI2CHandle );
+static void I2C_DMAConfig(DMA_Handle_t *Copy_pstrDMAHandle, DMA_Direction_t Copy_enuDirection);
+static u32  I2C_GetTimeout(I2C_Handle_t *Copy_pstrI2CHandle);
+static ES_t I2C_WaitFlag(I2C_Handle_t *Copy_pstrI2CHandle, u32 Copy_u32Flags);
+static ES_t I2C_AbortPolling(I2C_Handle_t *Copy_pstrI2CHandle, ES_t Copy_enuError);
+static ES_t I2C_Claim(I2C_Handle_t *Copy_pstrI2CHandle, I2C_BusyStete_t Copy_enuState);
+static ES_t I2C_Release(I2C_Handle_t *Copy_pstrI2CHandle, I2C_RepStartCtrl_t Copy_enuSr, ES_t Copy_enuError);
+static void I2C_RecoveryDelay(I2C_Handle_t *Copy_pstrI2CHandle);
+static u8   I2C_JobIsBefore(I2C_Job_t *Copy_pstrJob, I2C_Job_t *Copy_pstrOther);
+static u32  I2C_JobLock(void);
+static void I2C_JobUnlock(u32 Copy_u32PriMask);
+static void I2C_JobStartNext(I2C_Handle_t *Copy_pstrI2CHandle);
+static void I2C_JobKick(I2C_Handle_t *Copy_pstrI2CHandle);
+static void I2C_JobDone(I2C_Handle_t *Copy_pstrI2CHandle, ES_t Copy_enuResult);
+static void I2C_JobEnd(I2C_Handle_t *Copy_pstrI2CHandle, ES_t Copy_enuResult);
+static ES_t I2C_MemStartIT(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u16 Copy_u16MemAddr,
+		I2C_MemAddrSize_t Copy_enuMemAddrSize);
+static void I2C_CloseDMA(I2C_Handle_t *Copy_pstrI2CHandle);
+static void I2C_SlaveRegMapEndWrite(I2C_Handle_t *Copy_pstrI2CHandle);
+static u8   I2C_PECFailed(I2C_Handle_t *Copy_pstrI2CHandle);
+static void I2C_SaveStart(I2C_Handle_t *Copy_pstrI2CHandle);
+static u8   I2C_ArloRetry(I2C_Handle_t *Copy_pstrI2CHandle);
+static void I2C_ArloRestart(I2C_Handle_t *Copy_pstrI2CHandle);
+static ES_t I2C_AddressPhase(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u8 Copy_u8Read);
+static void I2C_SlaveRegMapSelect(I2C_Handle_t *Copy_pstrI2CHandle, u8 Copy_u8Slot);
+static void I2C_SlaveNoStretchArm(I2C_Handle_t *Copy_pstrI2CHandle);
+static void I2C_SlaveNoStretchEnd(I2C_Handle_t *Copy_pstrI2CHandle);
+
+
+#ifdef I2C_TRACE_ENABLE
+
+static void I2C_TraceRecord(I2C_t Copy_enuI2CId, I2C_RegDef_t *Copy_pstrI2CBaseAddr, I2C_TraceEvent_t Copy_enuEvent);
+
+static I2C_TraceRecord_t I2C_TraceBuffer[I2C_TRACE_LEN];
+static __vo u32 I2C_TraceHead = 0;
+static __vo u8  I2C_TraceOn = 0;
+
+#define I2C_TRACE(pHandle, pBaseAddr, Event)     I2C_TraceRecord((pHandle)->I2C_ID, (pBaseAddr), (Event))
+
+#else
+
+#define I2C_TRACE(pHandle, pBaseAddr, Event)
+
+#endif
 
 
 ES_t I2C_enuInit(I2C_Handle_t *Copy_pstrI2CHandle)
@@ -34,19 +81,56 @@ ES_t I2C_enuInit(I2C_Handle_t *Copy_pstrI2CHandle)
 
 	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
 
-	MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr,Copy_pstrI2CHandle->I2C_Config.I2C_AckControl);
+	//CCR and TRISE can only be configured while the peripheral is disabled
+	MCAL_I2C_Disable(Local_pstrI2CBaseAddr);
 
 	RCC_enuGetAPB1Value(&Local_u32APB1ClkFreq);
 
 	MCAL_I2c_SetFreqFeild(Local_pstrI2CBaseAddr, Local_u32APB1ClkFreq);
 
-	MCAL_I2C_SetDeviceOwnAddress(Local_pstrI2CBaseAddr, Copy_pstrI2CHandle->I2C_Config.I2C_DeviceAddress);
+	MCAL_I2C_SetDeviceOwnAddress(Local_pstrI2CBaseAddr, Copy_pstrI2CHandle->I2C_Config.I2C_DeviceAddress,
+			(Copy_pstrI2CHandle->I2C_Config.I2C_AddressingMode == I2C_Addr_10Bits) ? MCAL_I2C_ADDMODE_10BITS : MCAL_I2C_ADDMODE_7BITS);
+
+	//OAR2 is only compared while OAR1 is a 7 bits address
+	MCAL_I2C_SetDualAddress(Local_pstrI2CBaseAddr,
+			(Copy_pstrI2CHandle->I2C_Config.I2C_AddressingMode == I2C_Addr_10Bits) ? 0 : Copy_pstrI2CHandle->I2C_Config.I2C_DeviceAddress2);
 
 	MCAL_I2C_SetClockControl(Local_pstrI2CBaseAddr, Local_u32APB1ClkFreq,
 			Copy_pstrI2CHandle->I2C_Config.I2C_SCLSpeed , Copy_pstrI2CHandle->I2C_Config.I2C_FMDutyCycle);
 
 	MCAL_I2C_SetTRISEConfig(Local_pstrI2CBaseAddr, Local_u32APB1ClkFreq, Copy_pstrI2CHandle->I2C_Config.I2C_SCLSpeed );
 
+	MCAL_I2C_SetBusMode(Local_pstrI2CBaseAddr, Copy_pstrI2CHandle->I2C_Config.I2C_BusMode);
+
+	MCAL_I2C_PECControl(Local_pstrI2CBaseAddr, (Copy_pstrI2CHandle->I2C_Config.I2C_PEC == I2C_PEC_Enable));
+
+	MCAL_I2C_Enable(Local_pstrI2CBaseAddr);
+
+	//ACK is cleared by hardware while PE=0
+	MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr,Copy_pstrI2CHandle->I2C_Config.I2C_AckControl);
+
+	Copy_pstrI2CHandle->TxRxState = I2C_Ready;
+	Copy_pstrI2CHandle->Addr10Done = 0;
+	Copy_pstrI2CHandle->SlaveDualMatch = 0;
+	Copy_pstrI2CHandle->MemAddrLen = 0;
+	Copy_pstrI2CHandle->MemAddrIdx = 0;
+	Copy_pstrI2CHandle->MemRead = 0;
+	Copy_pstrI2CHandle->PECLen = 0;
+	Copy_pstrI2CHandle->SMBusBlock = 0;
+	Copy_pstrI2CHandle->PECError = 0;
+	Copy_pstrI2CHandle->ArloAttempts = 0;
+	Copy_pstrI2CHandle->ArloPending = 0;
+	Copy_pstrI2CHandle->ArloSeed = Copy_pstrI2CHandle->I2C_Config.I2C_DeviceAddress;    //masters draw different backoffs
+	Copy_pstrI2CHandle->ArloStats.ArbitrationLost = 0;
+	Copy_pstrI2CHandle->ArloStats.Retries = 0;
+	Copy_pstrI2CHandle->ArloStats.GiveUps = 0;
+	Copy_pstrI2CHandle->pJobHead = NULL;
+	Copy_pstrI2CHandle->pCurrentJob = NULL;
+	Copy_pstrI2CHandle->pRegMap = NULL;
+	Copy_pstrI2CHandle->RegMapSlot[0].pMap = NULL;
+	Copy_pstrI2CHandle->RegMapSlot[1].pMap = NULL;
+	Copy_pstrI2CHandle->RegMapActive = 0;
+
 	Local_enuErrorState = ES_OK;
 
 	return Local_enuErrorState;
@@ -54,10 +138,13 @@ ES_t I2C_enuInit(I2C_Handle_t *Copy_pstrI2CHandle)
 
 
 ES_t I2C_enuMasterSendData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
-		u8 Copy_u8Len, u8 Copy_u8SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr)
+		u32 Copy_u32Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr)
 {
 	ES_t Local_enuErrorState = ES_NOT_OK;
 
+	//IT, DMA and queued transfers are kept off while the bus is polled
+	if(I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInTx) != ES_OK)
+		return ES_FUNC_IS_BUSY;
 
 	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
 
@@ -66,13 +153,18 @@ ES_t I2C_enuMasterSendData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
 
 	//2. confirm that start generation is completed by checking the SB flag in the SR1
 	//   Note: Until SB is cleared SCL will be stretched (pulled to LOW)
-	while( !  MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_SB)   );
+	Local_enuErrorState = I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_SB);
 
-	//3. Send the address of the slave with r/nw bit set to w(0) (total 8 bits )
-	MCAL_I2C_ExecuteAddressPhaseWrite(Local_pstrI2CBaseAddr, Copy_u8SlaveAddr);
+	if(Local_enuErrorState != ES_OK)
+		return I2C_AbortPolling(Copy_pstrI2CHandle, Local_enuErrorState);
 
+	//3. Send the address of the slave with r/nw bit set to w(0) (total 8 bits, header + low byte in 10 bits)
 	//4. Confirm that address phase is completed by checking the ADDR flag in teh SR1
-	while( !  MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_ADDR)   );
+	//   Note: a NACK sets AF instead, it is returned as ES_NOT_OK
+	Local_enuErrorState = I2C_AddressPhase(Copy_pstrI2CHandle, Copy_u16SlaveAddr, 0);
+
+	if(Local_enuErrorState != ES_OK)
+		return I2C_AbortPolling(Copy_pstrI2CHandle, Local_enuErrorState);
 
 	//5. clear the ADDR flag according to its software sequence
 	//   Note: Until ADDR is cleared SCL will be stretched (pulled to LOW)
@@ -80,25 +172,28 @@ ES_t I2C_enuMasterSendData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
 
 	//6. send the data until len becomes 0
 
-	while(Copy_u8Len > 0)
+	while(Copy_u32Len > 0)
 	{
-		while(! MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_TXE) ); //Wait till TXE is set
+		//Wait till TXE is set
+		Local_enuErrorState = I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_TXE);
+
+		if(Local_enuErrorState != ES_OK)
+			return I2C_AbortPolling(Copy_pstrI2CHandle, Local_enuErrorState);
 
 		MCAL_I2C_WriteDataByte(Local_pstrI2CBaseAddr,*Copy_pu8Data);
 
 		Copy_pu8Data++;
-		Copy_u8Len--;
+		Copy_u32Len--;
 	}
 
 	//7. when Len becomes zero wait for TXE=1 and BTF=1 before generating the STOP condition
 	//   Note: TXE=1 , BTF=1 , means that both SR and DR are empty and next transmission should begin
 	//   when BTF=1 SCL will be stretched (pulled to LOW)
 
-	while(! MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_TXE) );
-
-	while(! MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_BTF) );
+	Local_enuErrorState = I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_TXE | MCAL_I2C_FLAG_BTF);
 
-	Local_enuErrorState = ES_OK;
+	if(Local_enuErrorState != ES_OK)
+		return I2C_AbortPolling(Copy_pstrI2CHandle, Local_enuErrorState);
 
 	//8. Generate STOP condition and master need not to wait for the completion of stop condition.
 	//   Note: generating STOP, automatically clears the BTF
@@ -108,14 +203,17 @@ ES_t I2C_enuMasterSendData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
 		MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
 	}
 
-	return Local_enuErrorState;
+	return I2C_Release(Copy_pstrI2CHandle, Copy_enuSr, Local_enuErrorState);
 }
 
 ES_t I2C_enuMasterReceiveData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
-		u8 Copy_u8Len, u8 Copy_u8SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr)
+		u32 Copy_u32Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr)
 {
 	ES_t Local_enuErrorState = ES_NOT_OK;
 
+	if(I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInRx) != ES_OK)
+		return ES_FUNC_IS_BUSY;
+
 	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
 
 	// 1. Generate the START condition
@@ -123,17 +221,22 @@ ES_t I2C_enuMasterReceiveData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
 
 	//2. confirm that start generation is completed by checking the SB flag in the SR1
 	//   Note: Until SB is cleared SCL will be stretched (pulled to LOW)
-	while( !  MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_SB)   );
+	Local_enuErrorState = I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_SB);
 
-	//3. Send the address of the slave with r/nw bit set to w(0) (total 8 bits )
-	MCAL_I2C_ExecuteAddressPhaseRead(Local_pstrI2CBaseAddr, Copy_u8SlaveAddr);
+	if(Local_enuErrorState != ES_OK)
+		return I2C_AbortPolling(Copy_pstrI2CHandle, Local_enuErrorState);
 
+	//3. Send the address of the slave with r/nw bit set to r(1) (total 8 bits )
+	//   Note: a 10 bits read is addressed for write first then goes on with a repeated START
 	//4. wait until address phase is completed by checking the ADDR flag in teh SR1
-	while( !  MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_ADDR)   );
+	Local_enuErrorState = I2C_AddressPhase(Copy_pstrI2CHandle, Copy_u16SlaveAddr, 1);
+
+	if(Local_enuErrorState != ES_OK)
+		return I2C_AbortPolling(Copy_pstrI2CHandle, Local_enuErrorState);
 
 
 	//procedure to read only 1 byte from slave
-	if(Copy_u8Len == 1)
+	if(Copy_u32Len == 1)
 	{
 		//Disable Acking
 		MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_DISABLE);
@@ -142,7 +245,10 @@ ES_t I2C_enuMasterReceiveData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
 		I2C_ClearADDRFlag(Copy_pstrI2CHandle);
 
 		//wait until  RXNE becomes 1
-		while(! MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_RXNE) );
+		Local_enuErrorState = I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_RXNE);
+
+		if(Local_enuErrorState != ES_OK)
+			return I2C_AbortPolling(Copy_pstrI2CHandle, Local_enuErrorState);
 
 		//generate STOP condition
 		if(Copy_enuSr == I2C_DisableRepStart)
@@ -159,16 +265,19 @@ ES_t I2C_enuMasterReceiveData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
 
 
 	//procedure to read data from slave when Len > 1
-	if(Copy_u8Len > 1)
+	if(Copy_u32Len > 1)
 	{
 		//clear the ADDR flag
 		I2C_ClearADDRFlag(Copy_pstrI2CHandle);
 
 		//read the data until Len becomes zero
-		for (u32 i = Copy_u8Len ; i > 0 ; i--)
+		for (u32 i = Copy_u32Len ; i > 0 ; i--)
 		{
 			//wait until RXNE becomes 1
-			while(! MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_RXNE) );
+			Local_enuErrorState = I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_RXNE);
+
+			if(Local_enuErrorState != ES_OK)
+				return I2C_AbortPolling(Copy_pstrI2CHandle, Local_enuErrorState);
 
 			if(i == 2) //if last 2 bytes are remaining
 			{
@@ -200,9 +309,129 @@ ES_t I2C_enuMasterReceiveData(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
 		MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_ENABLE);
 	}
 
+	return I2C_Release(Copy_pstrI2CHandle, Copy_enuSr, Local_enuErrorState);
+}
+
+
+ES_t I2C_enuBusRecovery(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	GPIO_PinState_t Local_enuSDA = GPIO_LOW;
+
+	if(Copy_pstrI2CHandle==NULL || Copy_pstrI2CHandle->pSCLPinHandle==NULL || Copy_pstrI2CHandle->pSDAPinHandle==NULL)
+		return ES_NULL_PTR;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	GPIO_Handle_t Local_strSCL = *Copy_pstrI2CHandle->pSCLPinHandle;
+	GPIO_Handle_t Local_strSDA = *Copy_pstrI2CHandle->pSDAPinHandle;
+
+	GPIO_Port_t Local_enuSCLPort = Local_strSCL.GPIO_Port;
+	GPIO_Pin_t  Local_enuSCLPin = Local_strSCL.GPIO_Config.GPIO_PinNumber;
+	GPIO_Port_t Local_enuSDAPort = Local_strSDA.GPIO_Port;
+	GPIO_Pin_t  Local_enuSDAPin = Local_strSDA.GPIO_Config.GPIO_PinNumber;
+
+	//a peripheral stuck in master mode drops its transfer, the configuration is kept
+	MCAL_I2C_SoftwareResetKeepConfig(Local_pstrI2CBaseAddr);
+
+	//lines are released (ODR high) before the pins leave the alternate function
+	GPIO_enuWriteToOutputPin(Local_enuSCLPort, Local_enuSCLPin, GPIO_HIGH);
+	GPIO_enuWriteToOutputPin(Local_enuSDAPort, Local_enuSDAPin, GPIO_HIGH);
+
+	Local_strSCL.GPIO_Config.GPIO_PinMode = GPIO_Mode_output;
+	Local_strSCL.GPIO_Config.GPIO_PinOPType = GPIO_Output_OD;
+	Local_strSDA.GPIO_Config.GPIO_PinMode = GPIO_Mode_output;
+	Local_strSDA.GPIO_Config.GPIO_PinOPType = GPIO_Output_OD;
+
+	GPIO_enuInit(&Local_strSCL);
+	GPIO_enuInit(&Local_strSDA);
+
+	//a slave holding SDA is in the middle of a byte, up to 9 clocks let it finish and see a NACK
+	for(u8 Local_u8Clock = 0; Local_u8Clock < 9; Local_u8Clock++)
+	{
+		GPIO_enuReadFromInputPin(Local_enuSDAPort, Local_enuSDAPin, &Local_enuSDA);
+
+		if(Local_enuSDA == GPIO_HIGH)
+			break;
+
+		GPIO_enuWriteToOutputPin(Local_enuSCLPort, Local_enuSCLPin, GPIO_LOW);
+		I2C_RecoveryDelay(Copy_pstrI2CHandle);
+		GPIO_enuWriteToOutputPin(Local_enuSCLPort, Local_enuSCLPin, GPIO_HIGH);
+		I2C_RecoveryDelay(Copy_pstrI2CHandle);
+	}
+
+	//STOP: SDA rises while SCL is high
+	GPIO_enuWriteToOutputPin(Local_enuSCLPort, Local_enuSCLPin, GPIO_LOW);
+	I2C_RecoveryDelay(Copy_pstrI2CHandle);
+	GPIO_enuWriteToOutputPin(Local_enuSDAPort, Local_enuSDAPin, GPIO_LOW);
+	I2C_RecoveryDelay(Copy_pstrI2CHandle);
+	GPIO_enuWriteToOutputPin(Local_enuSCLPort, Local_enuSCLPin, GPIO_HIGH);
+	I2C_RecoveryDelay(Copy_pstrI2CHandle);
+	GPIO_enuWriteToOutputPin(Local_enuSDAPort, Local_enuSDAPin, GPIO_HIGH);
+	I2C_RecoveryDelay(Copy_pstrI2CHandle);
+
+	GPIO_enuReadFromInputPin(Local_enuSDAPort, Local_enuSDAPin, &Local_enuSDA);
+
+	Local_enuErrorState = (Local_enuSDA == GPIO_HIGH)? ES_OK : ES_NOT_OK;
+
+	GPIO_enuInit(Copy_pstrI2CHandle->pSCLPinHandle);
+	GPIO_enuInit(Copy_pstrI2CHandle->pSDAPinHandle);
+
+	//the transfer the reset dropped is ended, a polling one is ended by its caller
+	if(Copy_pstrI2CHandle->pCurrentJob != NULL)
+	{
+		I2C_JobEnd(Copy_pstrI2CHandle, ES_TIME_OUT);
+	}
+	else if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTxDMA || Copy_pstrI2CHandle->TxRxState == I2C_BusyInRxDMA)
+	{
+		I2C_CloseDMA(Copy_pstrI2CHandle);
+	}
+	else if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInSlaveDMA)
+	{
+		//DR lost its preloaded byte
+		I2C_SlaveNoStretchArm(Copy_pstrI2CHandle);
+	}
+	else if(Copy_pstrI2CHandle->pRegMap == NULL &&
+			MCAL_I2C_GetInterruptStatus(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT))
+	{
+		Copy_pstrI2CHandle->ArloPending = 0;
+
+		if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx)
+		{
+			I2C_CloseReceiveData(Copy_pstrI2CHandle);
+		}
+		else if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTx)
+		{
+			I2C_CloseSendData(Copy_pstrI2CHandle);
+		}
+	}
+
 	return Local_enuErrorState;
 }
 
+
+ES_t I2C_enuGetWorstCaseLatency(I2C_Handle_t *Copy_pstrI2CHandle, u32 Copy_u32Len, u32 *Copy_pu32Ticks)
+{
+	if(Copy_pstrI2CHandle==NULL || Copy_pu32Ticks==NULL)
+		return ES_NULL_PTR;
+
+	u32 Local_u32SpeedKHz = Copy_pstrI2CHandle->I2C_Config.I2C_SCLSpeed / 1000;
+
+	if(Local_u32SpeedKHz == 0)
+		return ES_NOT_OK;
+
+	//address (up to 3 bytes for a 10 bits read) + data bytes of 9 clocks, one more byte time for START / STOP
+	u32 Local_u32BusUs = ((Copy_u32Len + 4) * 9 * 1000) / Local_u32SpeedKHz;
+
+	//every wait restarts its timeout: SB, up to 4 address events (10 bits read), one per byte (+ BTF for a write),
+	//each one may be stretched up to just below it, recovery (11 clocks) fits in the extra tick
+	*Copy_pu32Ticks = ((Local_u32BusUs + I2C_TICK_US - 1) / I2C_TICK_US) +
+			((Copy_u32Len + 5) * I2C_GetTimeout(Copy_pstrI2CHandle)) + 1;
+
+	return ES_OK;
+}
+
 ES_t I2C_enuSlaveSendData(I2C_t Copy_enuI2CId, u8 Copy_pu8Data)
 {
 	ES_t Local_enuErrorState = ES_NOT_OK;
@@ -232,22 +461,28 @@ ES_t I2C_enuSlaveReceiveData(I2C_t Copy_enuI2CId, u8 *Copy_pu8Data)
  * Data Send and Receive IT (Asynchronous mode)
  */
 ES_t I2C_enuMasterSendDataIT(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
-		u8 Copy_u8Len, u8 Copy_u8SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr)
+		u32 Copy_u32Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr)
 {
 	ES_t Local_enuErrorState = ES_NOT_OK;
 
-	if( (Copy_pstrI2CHandle->TxRxState != I2C_BusyInTx) && (Copy_pstrI2CHandle->TxRxState != I2C_BusyInRx))
+	//a DMA, slave or queued transfer owns the peripheral as well
+	if(I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInTx) != ES_OK)
+	{
+		Local_enuErrorState = ES_FUNC_IS_BUSY;
+	}
+	else
 	{
 
 		I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
 
 
 		Copy_pstrI2CHandle->pTxBuffer = Copy_pu8Data;
-		Copy_pstrI2CHandle->TxLen = Copy_u8Len;
-		Copy_pstrI2CHandle->TxRxState = I2C_BusyInTx;
-		Copy_pstrI2CHandle->DevAddr = Copy_u8SlaveAddr;
+		Copy_pstrI2CHandle->TxLen = Copy_u32Len;
+		Copy_pstrI2CHandle->DevAddr = Copy_u16SlaveAddr;
 		Copy_pstrI2CHandle->Sr = Copy_enuSr;
 
+		I2C_SaveStart(Copy_pstrI2CHandle);
+
 		//Implement code to Generate START Condition
 		MCAL_I2C_GenerateStartCondition(Local_pstrI2CBaseAddr);
 
@@ -268,22 +503,28 @@ ES_t I2C_enuMasterSendDataIT(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
 
 
 ES_t I2C_enuMasterReceiveDataIT(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
-		u8 Copy_u8Len, u8 Copy_u8SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr)
+		u32 Copy_u32Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr)
 {
 	ES_t Local_enuErrorState = ES_NOT_OK;
 
-	if( (Copy_pstrI2CHandle->TxRxState != I2C_BusyInTx) && (Copy_pstrI2CHandle->TxRxState != I2C_BusyInRx))
+	//a DMA, slave or queued transfer owns the peripheral as well
+	if(I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInRx) != ES_OK)
+	{
+		Local_enuErrorState = ES_FUNC_IS_BUSY;
+	}
+	else
 	{
 
 		I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
 
 		Copy_pstrI2CHandle->pRxBuffer = Copy_pu8Data;
-		Copy_pstrI2CHandle->RxLen = Copy_u8Len;
-		Copy_pstrI2CHandle->TxRxState = I2C_BusyInRx;
-		Copy_pstrI2CHandle->RxSize = Copy_u8Len;
-		Copy_pstrI2CHandle->DevAddr = Copy_u8SlaveAddr;
+		Copy_pstrI2CHandle->RxLen = Copy_u32Len;
+		Copy_pstrI2CHandle->RxSize = Copy_u32Len;
+		Copy_pstrI2CHandle->DevAddr = Copy_u16SlaveAddr;
 		Copy_pstrI2CHandle->Sr = Copy_enuSr;
 
+		I2C_SaveStart(Copy_pstrI2CHandle);
+
 		//Implement code to Generate START Condition
 		MCAL_I2C_GenerateStartCondition(Local_pstrI2CBaseAddr);
 
@@ -303,366 +544,2076 @@ ES_t I2C_enuMasterReceiveDataIT(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Dat
 }
 
 
-static void I2C_MasterHandleTXEInterrupt(I2C_Handle_t *Copy_pstrI2CHandle)
+/*
+ * Register access (IT)
+ */
+ES_t I2C_enuMemWriteIT(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u16 Copy_u16MemAddr,
+		I2C_MemAddrSize_t Copy_enuMemAddrSize, u8 *Copy_pu8Data, u32 Copy_u32Len)
 {
-	if(Copy_pstrI2CHandle->TxLen > 0)
-	{
-		I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+	if(Copy_pstrI2CHandle==NULL || Copy_pu8Data==NULL)
+		return ES_NULL_PTR;
 
-		//1. load the data in to DR
-		MCAL_I2C_WriteDataByte(Local_pstrI2CBaseAddr,*Copy_pstrI2CHandle->pTxBuffer);
+	if(Copy_u32Len == 0)
+		return ES_NOT_OK;
 
-		//2. decrement the TxLen
-		Copy_pstrI2CHandle->TxLen--;
+	if(I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInTx) != ES_OK)
+		return ES_FUNC_IS_BUSY;
 
-		//3. Increment the buffer address
-		Copy_pstrI2CHandle->pTxBuffer++;
-	}
+	Copy_pstrI2CHandle->pTxBuffer = Copy_pu8Data;
+	Copy_pstrI2CHandle->TxLen = Copy_u32Len;
+	Copy_pstrI2CHandle->MemRead = 0;
+
+	return I2C_MemStartIT(Copy_pstrI2CHandle, Copy_u16SlaveAddr, Copy_u16MemAddr, Copy_enuMemAddrSize);
 }
 
 
+ES_t I2C_enuMemReadIT(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u16 Copy_u16MemAddr,
+		I2C_MemAddrSize_t Copy_enuMemAddrSize, u8 *Copy_pu8Data, u32 Copy_u32Len)
+{
+	if(Copy_pstrI2CHandle==NULL || Copy_pu8Data==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u32Len == 0)
+		return ES_NOT_OK;
 
-static void I2C_MasterHandleRXNEInterrupt(I2C_Handle_t *Copy_pstrI2CHandle )
+	if(I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInTx) != ES_OK)
+		return ES_FUNC_IS_BUSY;
+
+	//the read phase is started from BTF once the register address is out
+	Copy_pstrI2CHandle->pRxBuffer = Copy_pu8Data;
+	Copy_pstrI2CHandle->RxLen = Copy_u32Len;
+	Copy_pstrI2CHandle->RxSize = Copy_u32Len;
+	Copy_pstrI2CHandle->TxLen = 0;
+	Copy_pstrI2CHandle->MemRead = 1;
+
+	return I2C_MemStartIT(Copy_pstrI2CHandle, Copy_u16SlaveAddr, Copy_u16MemAddr, Copy_enuMemAddrSize);
+}
+
+
+/*
+ * Bus job queue
+ */
+ES_t I2C_enuSubmitJob(I2C_Handle_t *Copy_pstrI2CHandle, I2C_Job_t *Copy_pstrJob)
 {
-	//We have to do the data reception
-	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+	if(Copy_pstrI2CHandle==NULL || Copy_pstrJob==NULL)
+		return ES_NULL_PTR;
 
-	if(Copy_pstrI2CHandle->RxSize == 1)
+	if((Copy_pstrJob->TxLen == 0 && Copy_pstrJob->RxLen == 0) ||
+			(Copy_pstrJob->TxLen > 0 && Copy_pstrJob->pTxData == NULL) ||
+			(Copy_pstrJob->RxLen > 0 && Copy_pstrJob->pRxData == NULL))
+		return ES_NOT_OK;
+
+	Copy_pstrJob->Result = ES_FUNC_IS_BUSY;
+
+	//the event, error and DMA interrupts pop jobs, they are held off while the list is changed
+	u32 Local_u32PriMask = I2C_JobLock();
+
+	I2C_Job_t **Local_ppstrLink = &Copy_pstrI2CHandle->pJobHead;
+
+	while(*Local_ppstrLink != NULL && ! I2C_JobIsBefore(Copy_pstrJob, *Local_ppstrLink))
 	{
-		// Read Just one byte
-		*Copy_pstrI2CHandle->pRxBuffer = MCAL_I2C_ReadDataByte(Local_pstrI2CBaseAddr);
-		Copy_pstrI2CHandle->RxLen--;
+		Local_ppstrLink = &(*Local_ppstrLink)->pNext;
 	}
 
+	Copy_pstrJob->pNext = *Local_ppstrLink;
+	*Local_ppstrLink = Copy_pstrJob;
 
-	if(Copy_pstrI2CHandle->RxSize > 1)
-	{
-		if(Copy_pstrI2CHandle->RxLen == 2)
-		{
-			//clear the ack bit
-			MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_DISABLE);
-		}
+	//an idle bus is started here, a busy one picks the job up when the current transfer ends
+	I2C_JobStartNext(Copy_pstrI2CHandle);
 
-		//read DR
-		*Copy_pstrI2CHandle->pRxBuffer = MCAL_I2C_ReadDataByte(Local_pstrI2CBaseAddr);
-		Copy_pstrI2CHandle->pRxBuffer++;
-		Copy_pstrI2CHandle->RxLen--;
-	}
+	I2C_JobUnlock(Local_u32PriMask);
 
-	if(Copy_pstrI2CHandle->RxLen == 0 )
-	{
-		//close the I2C data reception and notify the application
+	return ES_OK;
+}
 
-		//1. generate the stop condition
-		//generate STOP condition
-		if(Copy_pstrI2CHandle->Sr == I2C_DisableRepStart)
-		{
-			MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
-		}
 
-		//2 . Close the I2C rx
-		I2C_CloseReceiveData(Copy_pstrI2CHandle);
+/*
+ * SMBus
+ */
+ES_t I2C_enuSMBusBlockReadIT(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u8 Copy_u8Command,
+		u8 *Copy_pu8Data)
+{
+	if(Copy_pstrI2CHandle==NULL || Copy_pu8Data==NULL)
+		return ES_NULL_PTR;
 
-		//3. Notify the application
-		if(Copy_pstrI2CHandle->CallBackFun != NULL)
-		{
-			Copy_pstrI2CHandle->CallBackFun(I2C_Event_RxComplete);
-		}
-	}
+	if(I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInTx) != ES_OK)
+		return ES_FUNC_IS_BUSY;
+
+	//RxLen is set from the byte count once it is received
+	Copy_pstrI2CHandle->pRxBuffer = Copy_pu8Data;
+	Copy_pstrI2CHandle->RxLen = I2C_SMBUS_BLOCK_MAX + 1;
+	Copy_pstrI2CHandle->RxSize = I2C_SMBUS_BLOCK_MAX + 1;
+	Copy_pstrI2CHandle->TxLen = 0;
+	Copy_pstrI2CHandle->MemRead = 1;
+	Copy_pstrI2CHandle->SMBusBlock = 1;
+
+	return I2C_MemStartIT(Copy_pstrI2CHandle, Copy_u16SlaveAddr, Copy_u8Command, I2C_MemAddr_8Bits);
 }
 
 
+ES_t I2C_enuSMBusProcessCallIT(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u8 Copy_u8Command,
+		u8 *Copy_pu8TxData, u8 *Copy_pu8RxData)
+{
+	if(Copy_pstrI2CHandle==NULL || Copy_pu8TxData==NULL || Copy_pu8RxData==NULL)
+		return ES_NULL_PTR;
+
+	if(I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInTx) != ES_OK)
+		return ES_FUNC_IS_BUSY;
 
-void I2C_CloseReceiveData(I2C_Handle_t *Copy_pstrI2CHandle)
+	//a register read with a data phase before the turnaround
+	Copy_pstrI2CHandle->pTxBuffer = Copy_pu8TxData;
+	Copy_pstrI2CHandle->TxLen = 2;
+	Copy_pstrI2CHandle->pRxBuffer = Copy_pu8RxData;
+	Copy_pstrI2CHandle->RxLen = 2;
+	Copy_pstrI2CHandle->RxSize = 2;
+	Copy_pstrI2CHandle->MemRead = 1;
+
+	return I2C_MemStartIT(Copy_pstrI2CHandle, Copy_u16SlaveAddr, Copy_u8Command, I2C_MemAddr_8Bits);
+}
+
+
+ES_t I2C_enuSMBusAlertControl(I2C_Handle_t *Copy_pstrI2CHandle, u8 Copy_u8EnOrDi)
 {
-	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+	if(Copy_pstrI2CHandle==NULL)
+		return ES_NULL_PTR;
 
-	//Implement the code to disable ITBUFEN Control Bit
-	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT, DISABLE);
+	if(Copy_pstrI2CHandle->I2C_Config.I2C_BusMode == I2C_Mode_I2C)
+		return ES_NOT_OK;
 
-	//Implement the code to disable ITEVFEN Control Bit
-	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, DISABLE);
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
 
-	Copy_pstrI2CHandle->TxRxState = I2C_Ready;
-	Copy_pstrI2CHandle->pRxBuffer = NULL;
-	Copy_pstrI2CHandle->RxLen = 0;
-	Copy_pstrI2CHandle->RxSize = 0;
+	MCAL_I2C_AlertControl(Local_pstrI2CBaseAddr, Copy_u8EnOrDi);
 
-	if(Copy_pstrI2CHandle->I2C_Config.I2C_AckControl == I2C_ACK_Enable)
+	//the host gets SMBALERT through the error interrupt
+	if(Copy_u8EnOrDi == ENABLE && Copy_pstrI2CHandle->I2C_Config.I2C_BusMode == I2C_Mode_SMBusHost)
 	{
-		MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_ENABLE);
+		MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT, ENABLE);
 	}
-}
 
+	return ES_OK;
+}
 
 
-void I2C_CloseSendData(I2C_Handle_t *Copy_pstrI2CHandle)
+/*
+ * Arbitration lost retry
+ */
+ES_t I2C_enuArloService(I2C_Handle_t *Copy_pstrI2CHandle)
 {
+	u32 Local_u32Now = 0;
+
+	if(Copy_pstrI2CHandle==NULL)
+		return ES_NULL_PTR;
+
+	//a job held back while the bus was still owned
+	if(Copy_pstrI2CHandle->pJobHead != NULL && Copy_pstrI2CHandle->TxRxState == I2C_Ready)
+	{
+		I2C_JobKick(Copy_pstrI2CHandle);
+
+		return (Copy_pstrI2CHandle->pCurrentJob != NULL)? ES_OK : ES_FUNC_IS_BUSY;
+	}
+
+	if(! Copy_pstrI2CHandle->ArloPending)
+		return ES_FUNC_IS_IDLE;
 
 	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
 
-	//Implement the code to disable ITBUFEN Control Bit
-	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT, DISABLE);
+	SysTick_enuGetTicks(&Local_u32Now);
 
-	//Implement the code to disable ITEVFEN Control Bit
-	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, DISABLE);
+	//the winner still owns the bus until its STOP
+	if((Local_u32Now - Copy_pstrI2CHandle->ArloTick) < Copy_pstrI2CHandle->ArloBackoff ||
+			MCAL_I2C_GetBusBusy(Local_pstrI2CBaseAddr))
+		return ES_FUNC_IS_BUSY;
 
+	I2C_ArloRestart(Copy_pstrI2CHandle);
 
-	Copy_pstrI2CHandle->TxRxState = I2C_Ready;
-	Copy_pstrI2CHandle->pTxBuffer = NULL;
-	Copy_pstrI2CHandle->TxLen = 0;
+	return ES_OK;
 }
 
 
+ES_t I2C_enuGetArloStats(I2C_Handle_t *Copy_pstrI2CHandle, I2C_ArloStats_t *Copy_pstrStats)
+{
+	if(Copy_pstrI2CHandle==NULL || Copy_pstrStats==NULL)
+		return ES_NULL_PTR;
+
+	*Copy_pstrStats = Copy_pstrI2CHandle->ArloStats;
 
-void I2C_EV_IRQHandling(I2C_Handle_t *Copy_pstrI2CHandle)
+	return ES_OK;
+}
+
+
+/*
+ * Trace
+ */
+ES_t I2C_enuTraceStart(void)
 {
-	//Interrupt handling for both master and slave mode of a device
+#ifdef I2C_TRACE_ENABLE
+	I2C_TraceOn = 0;
 
-	u32 temp1, temp2, temp3;
+	MCAL_DWT_EnableCycleCounter();
 
-	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+	I2C_TraceHead = 0;
+	I2C_TraceOn = 1;
 
-	temp1   = MCAL_I2C_GetInterruptStatus(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT);
-	temp2   = MCAL_I2C_GetInterruptStatus(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT);
+	return ES_OK;
+#else
+	return ES_NOT_OK;
+#endif
+}
 
 
-	temp3   = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_SB);
+ES_t I2C_enuTraceStop(void)
+{
+#ifdef I2C_TRACE_ENABLE
+	I2C_TraceOn = 0;
 
-	//1. Handle For interrupt generated by SB event
-	//	Note : SB flag is only applicable in Master mode
-	if(temp1 && temp3)
-	{
-		//The interrupt is generated because of SB event
-		//This block will not be executed in slave mode because for slave SB is always zero
-		//In this block lets executed the address phase
-		if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTx)
-		{
-			MCAL_I2C_ExecuteAddressPhaseWrite(Local_pstrI2CBaseAddr,Copy_pstrI2CHandle->DevAddr);
-		}
-		else if (Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx )
-		{
-			MCAL_I2C_ExecuteAddressPhaseRead(Local_pstrI2CBaseAddr,Copy_pstrI2CHandle->DevAddr);
-		}
-	}
+	return ES_OK;
+#else
+	return ES_NOT_OK;
+#endif
+}
 
-	temp3   = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_ADDR);
-	//2. Handle For interrupt generated by ADDR event
-	//Note : When master mode : Address is sent
-	//		 When Slave mode   : Address matched with own address
-	if(temp1 && temp3)
-	{
-		// interrupt is generated because of ADDR event
-		I2C_ClearADDRFlag(Copy_pstrI2CHandle);
-	}
 
+ES_t I2C_enuTraceDump(void (*Write)(const u8 *pData, u32 Len))
+{
+#ifdef I2C_TRACE_ENABLE
+	I2C_TraceHeader_t Local_strHeader;
 
-	temp3   = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_BTF);
-	//3. Handle For interrupt generated by BTF(Byte Transfer Finished) event
-	if(temp1 && temp3)
-	{
-		//BTF flag is set
-		if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTx)
-		{
-			//make sure that TXE is also set .
-			if( MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_TXE) )
-			{
-				//BTF, TXE = 1
-				if(Copy_pstrI2CHandle->TxLen == 0)
-				{
-					//1. generate the STOP condition
-					if(Copy_pstrI2CHandle->Sr == I2C_DisableRepStart)
-					{
-						MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
-					}
+	if(Write == NULL)
+		return ES_NULL_PTR;
 
-					//2. reset all the member elements of the handle structure.
-					I2C_CloseSendData(Copy_pstrI2CHandle);
+	u8  Local_u8WasOn = I2C_TraceOn;
+	u32 Local_u32Head = 0;
+	u32 Local_u32First = 0;
 
-					//3. notify the application about transmission complete
-					Copy_pstrI2CHandle->CallBackFun(I2C_Event_TxComplete);
-				}
-			}
-		}
-	}
+	//the interrupts must not overwrite what is being sent
+	I2C_TraceOn = 0;
 
-	temp3   = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_STOPF);
-	//4. Handle For interrupt generated by STOPF event
-	// Note : Stop detection flag is applicable only slave mode . For master this flag will never be set
-	//The below code block will not be executed by the master since STOPF will not set in master mode
-	if(temp1 && temp3)
-	{
-		//STOF flag is set
-		//Clear the STOPF ( i.e 1) read SR1 2) Write to CR1 )
-		MCAL_I2C_ClearSTOPFlag(Local_pstrI2CBaseAddr);
+	Local_u32Head = I2C_TraceHead;
 
-		//Notify the application that STOP is detected
-		Copy_pstrI2CHandle->CallBackFun(I2C_Event_Stop);
-	}
+	Local_strHeader.Magic = I2C_TRACE_MAGIC;
+	Local_strHeader.Version = I2C_TRACE_VERSION;
+	Local_strHeader.RecordSize = sizeof(I2C_TraceRecord_t);
+	Local_strHeader.Count = (Local_u32Head > I2C_TRACE_LEN)? I2C_TRACE_LEN : Local_u32Head;
+	Local_strHeader.Dropped = Local_u32Head - Local_strHeader.Count;
+	Local_strHeader.CycleFreq = 0;
 
+	//the cycle counter runs at HCLK
+	RCC_enuGetAHBValue(&Local_strHeader.CycleFreq);
 
-	temp3  = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_TXE);
-	//5. Handle For interrupt generated by TXE event
-	if(temp1 && temp2 && temp3)
+	Write((const u8 *)&Local_strHeader, sizeof(Local_strHeader));
+
+	//oldest record first, the ring is sent in at most two pieces
+	Local_u32First = (Local_u32Head - Local_strHeader.Count) & (I2C_TRACE_LEN - 1);
+
+	if(Local_u32First + Local_strHeader.Count > I2C_TRACE_LEN)
 	{
+		Write((const u8 *)&I2C_TraceBuffer[Local_u32First], (I2C_TRACE_LEN - Local_u32First) * sizeof(I2C_TraceRecord_t));
+		Write((const u8 *)&I2C_TraceBuffer[0], (Local_u32First + Local_strHeader.Count - I2C_TRACE_LEN) * sizeof(I2C_TraceRecord_t));
+	}
+	else
+	{
+		Write((const u8 *)&I2C_TraceBuffer[Local_u32First], Local_strHeader.Count * sizeof(I2C_TraceRecord_t));
+	}
+
+	I2C_TraceOn = Local_u8WasOn;
+
+	return ES_OK;
+#else
+	(void)Write;
+
+	return ES_NOT_OK;
+#endif
+}
+
+
+/*
+ * Slave register map
+ */
+ES_t I2C_enuSlaveRegMapStart(I2C_Handle_t *Copy_pstrI2CHandle, u8 *Copy_pu8RegMap, u16 Copy_u16Size,
+		void (*RegWrite)(u16 Start, u16 Len))
+{
+	if(Copy_pstrI2CHandle==NULL || Copy_pu8RegMap==NULL)
+		return ES_NULL_PTR;
+
+	//the register pointer is one byte
+	if(Copy_u16Size == 0 || Copy_u16Size > 256)
+		return ES_NOT_OK;
+
+	if(Copy_pstrI2CHandle->TxRxState != I2C_Ready || Copy_pstrI2CHandle->pCurrentJob != NULL)
+		return ES_FUNC_IS_BUSY;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	Copy_pstrI2CHandle->RegMapSize = Copy_u16Size;
+	Copy_pstrI2CHandle->RegPtr = 0;
+	Copy_pstrI2CHandle->RegPtrPending = 0;
+	Copy_pstrI2CHandle->RegWriteStart = 0;
+	Copy_pstrI2CHandle->RegWriteLen = 0;
+	Copy_pstrI2CHandle->RegWriteCallBackFunc = RegWrite;
+	Copy_pstrI2CHandle->RegMapSlot[0].pMap = Copy_pu8RegMap;
+	Copy_pstrI2CHandle->RegMapSlot[0].Size = Copy_u16Size;
+	Copy_pstrI2CHandle->RegMapSlot[0].Ptr = 0;
+	Copy_pstrI2CHandle->RegMapSlot[1].Ptr = 0;
+	Copy_pstrI2CHandle->RegMapActive = 0;
+	Copy_pstrI2CHandle->pRegMap = Copy_pu8RegMap;
+
+	//the own address is only acknowledged with ACK set
+	MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_ENABLE);
+
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT, ENABLE);
+
+	return ES_OK;
+}
+
+
+ES_t I2C_enuSlaveRegMapStop(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	if(Copy_pstrI2CHandle==NULL)
+		return ES_NULL_PTR;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT, DISABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, DISABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT, DISABLE);
+
+	Copy_pstrI2CHandle->pRegMap = NULL;
+	Copy_pstrI2CHandle->RegMapSlot[0].pMap = NULL;
+	Copy_pstrI2CHandle->RegMapSlot[1].pMap = NULL;
+
+	if(Copy_pstrI2CHandle->I2C_Config.I2C_AckControl == I2C_ACK_Disable)
+	{
+		MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_DISABLE);
+	}
+
+	return ES_OK;
+}
+
+
+ES_t I2C_enuSlaveRegMapSetDual(I2C_Handle_t *Copy_pstrI2CHandle, u8 *Copy_pu8RegMap, u16 Copy_u16Size)
+{
+	if(Copy_pstrI2CHandle==NULL || Copy_pu8RegMap==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u16Size == 0 || Copy_u16Size > 256)
+		return ES_NOT_OK;
+
+	Copy_pstrI2CHandle->RegMapSlot[1].Size = Copy_u16Size;
+	Copy_pstrI2CHandle->RegMapSlot[1].Ptr = 0;
+	Copy_pstrI2CHandle->RegMapSlot[1].pMap = Copy_pu8RegMap;
+
+	//replaced while it is the active one
+	if(Copy_pstrI2CHandle->RegMapActive == 1)
+	{
+		Copy_pstrI2CHandle->RegMapSize = Copy_u16Size;
+		Copy_pstrI2CHandle->RegPtr = 0;
+		Copy_pstrI2CHandle->pRegMap = Copy_pu8RegMap;
+	}
+
+	return ES_OK;
+}
+
+
+ES_t I2C_enuGetSlaveAddrMatch(I2C_Handle_t *Copy_pstrI2CHandle, u8 *Copy_pu8Match)
+{
+	if(Copy_pstrI2CHandle==NULL || Copy_pu8Match==NULL)
+		return ES_NULL_PTR;
+
+	*Copy_pu8Match = Copy_pstrI2CHandle->SlaveDualMatch;
+
+	return ES_OK;
+}
+
+
+/*
+ * No-stretch slave
+ */
+ES_t I2C_enuSlaveNoStretchStart(I2C_Handle_t *Copy_pstrI2CHandle, u8 *Copy_pu8TxBuffer, u16 Copy_u16TxLen,
+		u8 *Copy_pu8RxBuffer, u16 Copy_u16RxLen)
+{
+	if(Copy_pstrI2CHandle==NULL || (Copy_pu8TxBuffer==NULL && Copy_pu8RxBuffer==NULL))
+		return ES_NULL_PTR;
+
+	if((Copy_pu8TxBuffer!=NULL && Copy_pstrI2CHandle->pTxDMAHandle==NULL) ||
+			(Copy_pu8RxBuffer!=NULL && Copy_pstrI2CHandle->pRxDMAHandle==NULL))
+		return ES_NULL_PTR;
+
+	if((Copy_pu8TxBuffer!=NULL && Copy_u16TxLen == 0) || (Copy_pu8RxBuffer!=NULL && Copy_u16RxLen == 0))
+		return ES_NOT_OK;
+
+	if(Copy_pstrI2CHandle->pCurrentJob != NULL || Copy_pstrI2CHandle->pRegMap != NULL ||
+			I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInSlaveDMA) != ES_OK)
+		return ES_FUNC_IS_BUSY;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	Copy_pstrI2CHandle->pTxBuffer = Copy_pu8TxBuffer;
+	Copy_pstrI2CHandle->TxLen = Copy_u16TxLen;
+	Copy_pstrI2CHandle->pRxBuffer = Copy_pu8RxBuffer;
+	Copy_pstrI2CHandle->RxSize = Copy_u16RxLen;
+
+	Copy_pstrI2CHandle->SlaveStats.Transactions = 0;
+	Copy_pstrI2CHandle->SlaveStats.RxBytes = 0;
+	Copy_pstrI2CHandle->SlaveStats.LastRxLen = 0;
+	Copy_pstrI2CHandle->SlaveStats.Overruns = 0;
+	Copy_pstrI2CHandle->SlaveStats.Underruns = 0;
+
+	if(Copy_pu8TxBuffer != NULL)
+	{
+		I2C_DMAConfig(Copy_pstrI2CHandle->pTxDMAHandle, DMA_Dir_MemToPeriph);
+	}
+
+	if(Copy_pu8RxBuffer != NULL)
+	{
+		I2C_DMAConfig(Copy_pstrI2CHandle->pRxDMAHandle, DMA_Dir_PeriphToMem);
+	}
+
+	MCAL_I2C_Disable(Local_pstrI2CBaseAddr);
+	MCAL_I2C_ClockStretchControl(Local_pstrI2CBaseAddr, DISABLE);
+	MCAL_I2C_Enable(Local_pstrI2CBaseAddr);
+
+	//the own address is only acknowledged with ACK set (PE=0 cleared it)
+	MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_ENABLE);
+
+	I2C_SlaveNoStretchArm(Copy_pstrI2CHandle);
+
+	MCAL_I2C_DMAControl(Local_pstrI2CBaseAddr, ENABLE);
+
+	//ITBUFEN stays disabled, only ADDR / STOPF and the errors interrupt
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT, ENABLE);
+
+	return ES_OK;
+}
+
+
+ES_t I2C_enuSlaveNoStretchStop(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	if(Copy_pstrI2CHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_pstrI2CHandle->TxRxState != I2C_BusyInSlaveDMA)
+		return ES_FUNC_IS_IDLE;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, DISABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT, DISABLE);
+
+	MCAL_I2C_DMAControl(Local_pstrI2CBaseAddr, DISABLE);
+
+	if(Copy_pstrI2CHandle->pTxBuffer != NULL)
+	{
+		DMA_enuStop(Copy_pstrI2CHandle->pTxDMAHandle);
+	}
+
+	if(Copy_pstrI2CHandle->pRxBuffer != NULL)
+	{
+		DMA_enuStop(Copy_pstrI2CHandle->pRxDMAHandle);
+	}
+
+	MCAL_I2C_Disable(Local_pstrI2CBaseAddr);
+	MCAL_I2C_ClockStretchControl(Local_pstrI2CBaseAddr, ENABLE);
+	MCAL_I2C_Enable(Local_pstrI2CBaseAddr);
+
+	MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, Copy_pstrI2CHandle->I2C_Config.I2C_AckControl);
+
+	Copy_pstrI2CHandle->pTxBuffer = NULL;
+	Copy_pstrI2CHandle->pRxBuffer = NULL;
+	Copy_pstrI2CHandle->TxLen = 0;
+	Copy_pstrI2CHandle->RxSize = 0;
+
+	Copy_pstrI2CHandle->TxRxState = I2C_Ready;
+
+	//jobs submitted meanwhile are waiting for the bus
+	I2C_JobKick(Copy_pstrI2CHandle);
+
+	return ES_OK;
+}
+
+
+ES_t I2C_enuGetSlaveStats(I2C_Handle_t *Copy_pstrI2CHandle, I2C_SlaveStats_t *Copy_pstrStats)
+{
+	if(Copy_pstrI2CHandle==NULL || Copy_pstrStats==NULL)
+		return ES_NULL_PTR;
+
+	*Copy_pstrStats = Copy_pstrI2CHandle->SlaveStats;
+
+	return ES_OK;
+}
+
+
+/*
+ * Data Send and Receive DMA (Asynchronous mode)
+ */
+ES_t I2C_enuMasterSendDataDMA(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
+		u16 Copy_u16Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrI2CHandle==NULL || Copy_pu8Data==NULL || Copy_pstrI2CHandle->pTxDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u16Len == 0)
+		return ES_NOT_OK;
+
+	if(I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInTxDMA) != ES_OK)
+		return ES_FUNC_IS_BUSY;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	Copy_pstrI2CHandle->pTxBuffer = Copy_pu8Data;
+	Copy_pstrI2CHandle->TxLen = Copy_u16Len;
+	Copy_pstrI2CHandle->DevAddr = Copy_u16SlaveAddr;
+	Copy_pstrI2CHandle->Addr10Done = 0;
+	Copy_pstrI2CHandle->Sr = Copy_enuSr;
+
+	I2C_DMAConfig(Copy_pstrI2CHandle->pTxDMAHandle, DMA_Dir_MemToPeriph);
+
+	//the stream waits for the first TXE request after the address phase
+	Local_enuErrorState = DMA_enuStartIT(Copy_pstrI2CHandle->pTxDMAHandle, MCAL_I2C_GetDataRegAddress(Local_pstrI2CBaseAddr),
+			(u32)Copy_pu8Data, 0, Copy_u16Len);
+
+	//no START without a running stream, SCL would be stretched for ever
+	if(Local_enuErrorState != ES_OK)
+		return I2C_Release(Copy_pstrI2CHandle, I2C_DisableRepStart, Local_enuErrorState);
+
+	MCAL_I2C_DMAControl(Local_pstrI2CBaseAddr, ENABLE);
+
+	//ITBUFEN stays disabled, TXE is served by the DMA
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT, ENABLE);
+
+	MCAL_I2C_GenerateStartCondition(Local_pstrI2CBaseAddr);
+
+	Local_enuErrorState = ES_OK;
+
+	return Local_enuErrorState;
+}
+
+
+ES_t I2C_enuMasterReceiveDataDMA(I2C_Handle_t *Copy_pstrI2CHandle,u8 *Copy_pu8Data,
+		u16 Copy_u16Len, u16 Copy_u16SlaveAddr,I2C_RepStartCtrl_t Copy_enuSr)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	if(Copy_pstrI2CHandle==NULL || Copy_pu8Data==NULL || Copy_pstrI2CHandle->pRxDMAHandle==NULL)
+		return ES_NULL_PTR;
+
+	if(Copy_u16Len == 0)
+		return ES_NOT_OK;
+
+	if(I2C_Claim(Copy_pstrI2CHandle, I2C_BusyInRxDMA) != ES_OK)
+		return ES_FUNC_IS_BUSY;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	Copy_pstrI2CHandle->pRxBuffer = Copy_pu8Data;
+	Copy_pstrI2CHandle->RxLen = Copy_u16Len;
+	Copy_pstrI2CHandle->RxSize = Copy_u16Len;
+	Copy_pstrI2CHandle->DevAddr = Copy_u16SlaveAddr;
+	Copy_pstrI2CHandle->Addr10Done = 0;
+	Copy_pstrI2CHandle->Sr = Copy_enuSr;
+
+	I2C_DMAConfig(Copy_pstrI2CHandle->pRxDMAHandle, DMA_Dir_PeriphToMem);
+
+	Local_enuErrorState = DMA_enuStartIT(Copy_pstrI2CHandle->pRxDMAHandle, MCAL_I2C_GetDataRegAddress(Local_pstrI2CBaseAddr),
+			(u32)Copy_pu8Data, 0, Copy_u16Len);
+
+	//checked before ACK, LAST and DMAEN are touched, nothing is left to undo
+	if(Local_enuErrorState != ES_OK)
+		return I2C_Release(Copy_pstrI2CHandle, I2C_DisableRepStart, Local_enuErrorState);
+
+	//bytes 1..N-1 are ACKed, a single byte is NACKed when ADDR is cleared
+	MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_ENABLE);
+
+	if(Copy_u16Len > 1)
+	{
+		//hardware NACKs byte N (the DMA EOT byte), no N-2 / N-1 software step is needed
+		MCAL_I2C_LastTransferControl(Local_pstrI2CBaseAddr, ENABLE);
+	}
+
+	MCAL_I2C_DMAControl(Local_pstrI2CBaseAddr, ENABLE);
+
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT, ENABLE);
+
+	MCAL_I2C_GenerateStartCondition(Local_pstrI2CBaseAddr);
+
+	Local_enuErrorState = ES_OK;
+
+	return Local_enuErrorState;
+}
+
+
+void I2C_DMA_IRQHandling(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	u8 Local_u8Events = 0;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	if(Copy_pstrI2CHandle->pRxDMAHandle != NULL &&
+			DMA_enuGetAndClearEvents(Copy_pstrI2CHandle->pRxDMAHandle, &Local_u8Events) == ES_OK)
+	{
+		if((Local_u8Events & DMA_EVENT_MASK(DMA_Event_TransferComplete)) &&
+				Copy_pstrI2CHandle->TxRxState == I2C_BusyInRxDMA)
+		{
+			//byte N is received and NACKed, STOP goes in the EOT path (already sent for a single byte)
+			if(Copy_pstrI2CHandle->Sr == I2C_DisableRepStart && Copy_pstrI2CHandle->RxSize > 1)
+			{
+				MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
+			}
+
+			Copy_pstrI2CHandle->RxLen = 0;
+
+			I2C_CloseDMA(Copy_pstrI2CHandle);
+
+			if(Copy_pstrI2CHandle->CallBackFun != NULL)
+			{
+				Copy_pstrI2CHandle->CallBackFun(I2C_Event_RxComplete);
+			}
+		}
+
+		if((Local_u8Events & DMA_EVENT_MASK(DMA_Event_TransferError)) &&
+				Copy_pstrI2CHandle->TxRxState == I2C_BusyInRxDMA)
+		{
+			MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
+
+			I2C_CloseDMA(Copy_pstrI2CHandle);
+
+			if(Copy_pstrI2CHandle->CallBackFun != NULL)
+			{
+				Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorDMA);
+			}
+		}
+	}
+
+	//TX completion is taken from BTF (last byte on the bus), only errors are handled here
+	if(Copy_pstrI2CHandle->pTxDMAHandle != NULL &&
+			DMA_enuGetAndClearEvents(Copy_pstrI2CHandle->pTxDMAHandle, &Local_u8Events) == ES_OK)
+	{
+		if((Local_u8Events & DMA_EVENT_MASK(DMA_Event_TransferError)) &&
+				Copy_pstrI2CHandle->TxRxState == I2C_BusyInTxDMA)
+		{
+			MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
+
+			I2C_CloseDMA(Copy_pstrI2CHandle);
+
+			if(Copy_pstrI2CHandle->CallBackFun != NULL)
+			{
+				Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorDMA);
+			}
+		}
+	}
+}
+
+
+static void I2C_MasterHandleTXEInterrupt(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	if(Copy_pstrI2CHandle->MemAddrIdx < Copy_pstrI2CHandle->MemAddrLen)
+	{
+		I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+		//register address goes first
+		MCAL_I2C_WriteDataByte(Local_pstrI2CBaseAddr,Copy_pstrI2CHandle->MemAddr[Copy_pstrI2CHandle->MemAddrIdx]);
+
+		Copy_pstrI2CHandle->MemAddrIdx++;
+	}
+	else if(Copy_pstrI2CHandle->TxLen > 0)
+	{
+		I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+		//1. load the data in to DR
+		MCAL_I2C_WriteDataByte(Local_pstrI2CBaseAddr,*Copy_pstrI2CHandle->pTxBuffer);
+
+		//2. decrement the TxLen
+		Copy_pstrI2CHandle->TxLen--;
+
+		//3. Increment the buffer address
+		Copy_pstrI2CHandle->pTxBuffer++;
+	}
+	else if(Copy_pstrI2CHandle->MemRead == 0 && Copy_pstrI2CHandle->PECLen == 0 &&
+			Copy_pstrI2CHandle->I2C_Config.I2C_PEC == I2C_PEC_Enable)
+	{
+		I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+		//last byte is in the shift register, the PEC follows it (BTF comes after the PEC)
+		Copy_pstrI2CHandle->PECLen = 1;
+		MCAL_I2C_TransferPEC(Local_pstrI2CBaseAddr);
+	}
+}
+
+
+
+static void I2C_MasterHandleRXNEInterrupt(I2C_Handle_t *Copy_pstrI2CHandle )
+{
+	//We have to do the data reception
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	if(Copy_pstrI2CHandle->RxSize == 1)
+	{
+		// Read Just one byte
+		*Copy_pstrI2CHandle->pRxBuffer = MCAL_I2C_ReadDataByte(Local_pstrI2CBaseAddr);
+		Copy_pstrI2CHandle->RxLen--;
+	}
+
+
+	if(Copy_pstrI2CHandle->RxSize > 1)
+	{
+		u8 Local_u8Data = 0;
+		u8 Local_u8Read = 0;
+
+		if(Copy_pstrI2CHandle->SMBusBlock)
+		{
+			//the first byte of a block read is its byte count, the length is only known now
+			Local_u8Data = (u8)MCAL_I2C_ReadDataByte(Local_pstrI2CBaseAddr);
+			Local_u8Read = 1;
+
+			if(Local_u8Data > I2C_SMBUS_BLOCK_MAX)
+			{
+				Local_u8Data = I2C_SMBUS_BLOCK_MAX;
+			}
+
+			Copy_pstrI2CHandle->SMBusBlock = 0;
+			Copy_pstrI2CHandle->RxLen = Local_u8Data + Copy_pstrI2CHandle->PECLen + 1;
+		}
+
+		if(Copy_pstrI2CHandle->RxLen == 2)
+		{
+			//clear the ack bit
+			MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_DISABLE);
+
+			//the last byte is then compared with the PEC
+			if(Copy_pstrI2CHandle->PECLen)
+			{
+				MCAL_I2C_TransferPEC(Local_pstrI2CBaseAddr);
+			}
+		}
+
+		//read DR
+		if(! Local_u8Read)
+		{
+			Local_u8Data = (u8)MCAL_I2C_ReadDataByte(Local_pstrI2CBaseAddr);
+		}
+
+		//the PEC byte is not stored
+		if(Copy_pstrI2CHandle->RxLen > 1 || Copy_pstrI2CHandle->PECLen == 0)
+		{
+			*Copy_pstrI2CHandle->pRxBuffer = Local_u8Data;
+			Copy_pstrI2CHandle->pRxBuffer++;
+		}
+
+		Copy_pstrI2CHandle->RxLen--;
+	}
+
+	if(Copy_pstrI2CHandle->RxLen == 0 && Copy_pstrI2CHandle->pCurrentJob != NULL)
+	{
+		I2C_JobDone(Copy_pstrI2CHandle, (I2C_PECFailed(Copy_pstrI2CHandle))? ES_NOT_OK : ES_OK);
+	}
+	else if(Copy_pstrI2CHandle->RxLen == 0 )
+	{
+		u8 Local_u8PECFailed = I2C_PECFailed(Copy_pstrI2CHandle);
+
+		//close the I2C data reception and notify the application
+
+		//1. generate the stop condition
+		//generate STOP condition
+		if(Copy_pstrI2CHandle->Sr == I2C_DisableRepStart)
+		{
+			MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
+		}
+
+		//2 . Close the I2C rx
+		I2C_CloseReceiveData(Copy_pstrI2CHandle);
+
+		//3. Notify the application
+		if(Copy_pstrI2CHandle->CallBackFun != NULL)
+		{
+			Copy_pstrI2CHandle->CallBackFun((Local_u8PECFailed)? I2C_Event_ErrorPec : I2C_Event_RxComplete);
+		}
+	}
+}
+
+
+
+void I2C_CloseReceiveData(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	//Implement the code to disable ITBUFEN Control Bit
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT, DISABLE);
+
+	//Implement the code to disable ITEVFEN Control Bit
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, DISABLE);
+
+	Copy_pstrI2CHandle->TxRxState = I2C_Ready;
+	Copy_pstrI2CHandle->pRxBuffer = NULL;
+	Copy_pstrI2CHandle->RxLen = 0;
+	Copy_pstrI2CHandle->RxSize = 0;
+	Copy_pstrI2CHandle->PECLen = 0;
+	Copy_pstrI2CHandle->SMBusBlock = 0;
+
+	if(Copy_pstrI2CHandle->I2C_Config.I2C_AckControl == I2C_ACK_Enable)
+	{
+		MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_ENABLE);
+	}
+
+	//jobs submitted during the transfer, a bus kept for a repeated START stays with the caller
+	if(Copy_pstrI2CHandle->Sr == I2C_DisableRepStart || MCAL_I2C_GetStopStatus(Local_pstrI2CBaseAddr))
+	{
+		I2C_JobKick(Copy_pstrI2CHandle);
+	}
+}
+
+
+
+void I2C_CloseSendData(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	//Implement the code to disable ITBUFEN Control Bit
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT, DISABLE);
+
+	//Implement the code to disable ITEVFEN Control Bit
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, DISABLE);
+
+
+	Copy_pstrI2CHandle->TxRxState = I2C_Ready;
+	Copy_pstrI2CHandle->pTxBuffer = NULL;
+	Copy_pstrI2CHandle->TxLen = 0;
+	Copy_pstrI2CHandle->MemAddrLen = 0;
+	Copy_pstrI2CHandle->MemAddrIdx = 0;
+	Copy_pstrI2CHandle->MemRead = 0;
+	Copy_pstrI2CHandle->PECLen = 0;
+
+	//jobs submitted during the transfer, a bus kept for a repeated START stays with the caller
+	if(Copy_pstrI2CHandle->Sr == I2C_DisableRepStart || MCAL_I2C_GetStopStatus(Local_pstrI2CBaseAddr))
+	{
+		I2C_JobKick(Copy_pstrI2CHandle);
+	}
+}
+
+
+
+void I2C_EV_IRQHandling(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	//Interrupt handling for both master and slave mode of a device
+
+	u32 temp1, temp2, temp3;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	temp1   = MCAL_I2C_GetInterruptStatus(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT);
+	temp2   = MCAL_I2C_GetInterruptStatus(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT);
+
+
+	temp3   = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_SB);
+
+	//1. Handle For interrupt generated by SB event
+	//	Note : SB flag is only applicable in Master mode
+	//	Note : SB, ADDR, BTF and STOPF are ITEVTEN events, ITBUFEN is off in DMA mode
+	if(temp2 && temp3)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_SB);
+
+		//The interrupt is generated because of SB event
+		//This block will not be executed in slave mode because for slave SB is always zero
+		//In this block lets executed the address phase
+		if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTx || Copy_pstrI2CHandle->TxRxState == I2C_BusyInTxDMA)
+		{
+			if(Copy_pstrI2CHandle->DevAddr & I2C_ADDR_10BITS)
+			{
+				//the low byte follows at ADD10
+				MCAL_I2C_ExecuteAddressHeader10Bits(Local_pstrI2CBaseAddr, Copy_pstrI2CHandle->DevAddr, 0);
+			}
+			else
+			{
+				MCAL_I2C_ExecuteAddressPhaseWrite(Local_pstrI2CBaseAddr,(u8)Copy_pstrI2CHandle->DevAddr);
+			}
+		}
+		else if (Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx || Copy_pstrI2CHandle->TxRxState == I2C_BusyInRxDMA)
+		{
+			if((Copy_pstrI2CHandle->DevAddr & I2C_ADDR_10BITS) && Copy_pstrI2CHandle->Addr10Done == 0)
+			{
+				//a 10 bits read sends the whole address for write first, the read header follows a repeated START
+				MCAL_I2C_ExecuteAddressHeader10Bits(Local_pstrI2CBaseAddr, Copy_pstrI2CHandle->DevAddr, 0);
+			}
+			else
+			{
+				//the PEC is one more byte of the read phase
+				if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx && Copy_pstrI2CHandle->I2C_Config.I2C_PEC == I2C_PEC_Enable)
+				{
+					Copy_pstrI2CHandle->PECLen = 1;
+					Copy_pstrI2CHandle->PECError = 0;
+					Copy_pstrI2CHandle->RxLen++;
+					Copy_pstrI2CHandle->RxSize++;
+				}
+
+				if(Copy_pstrI2CHandle->DevAddr & I2C_ADDR_10BITS)
+				{
+					//the slave is still addressed, the header alone selects it
+					MCAL_I2C_ExecuteAddressHeader10Bits(Local_pstrI2CBaseAddr, Copy_pstrI2CHandle->DevAddr, 1);
+				}
+				else
+				{
+					MCAL_I2C_ExecuteAddressPhaseRead(Local_pstrI2CBaseAddr,(u8)Copy_pstrI2CHandle->DevAddr);
+				}
+			}
+		}
+	}
+
+	temp3   = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_ADD10);
+	//Handle For interrupt generated by ADD10 event
+	//	Note : master only, the 10 bits header is acknowledged, writing the low byte clears ADD10
+	if(temp2 && temp3)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_ADD10);
+
+		MCAL_I2C_ExecuteAddressLow10Bits(Local_pstrI2CBaseAddr, Copy_pstrI2CHandle->DevAddr);
+	}
+
+	temp3   = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_ADDR);
+	//2. Handle For interrupt generated by ADDR event
+	//Note : When master mode : Address is sent
+	//		 When Slave mode   : Address matched with own address
+	if(temp2 && temp3)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_ADDR);
+
+		//a NACK from now on is not an address NACK
+		Copy_pstrI2CHandle->AddrAcked = 1;
+
+		// interrupt is generated because of ADDR event
+		I2C_ClearADDRFlag(Copy_pstrI2CHandle);
+	}
+
+
+	temp3   = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_BTF);
+	//3. Handle For interrupt generated by BTF(Byte Transfer Finished) event
+	if(temp2 && temp3)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_BTF);
+
+		//BTF flag is set
+		if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTx)
+		{
+			//make sure that TXE is also set .
+			if( MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_TXE) )
+			{
+				//BTF, TXE = 1
+				if(Copy_pstrI2CHandle->TxLen == 0 && Copy_pstrI2CHandle->MemAddrIdx == Copy_pstrI2CHandle->MemAddrLen &&
+						Copy_pstrI2CHandle->MemRead)
+				{
+					//register address is out, turn around with a repeated START (it clears BTF)
+					Copy_pstrI2CHandle->MemRead = 0;
+					Copy_pstrI2CHandle->MemAddrLen = 0;
+					Copy_pstrI2CHandle->MemAddrIdx = 0;
+					Copy_pstrI2CHandle->TxRxState = I2C_BusyInRx;
+
+					MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_ENABLE);
+
+					MCAL_I2C_GenerateStartCondition(Local_pstrI2CBaseAddr);
+				}
+				else if(Copy_pstrI2CHandle->TxLen == 0 && Copy_pstrI2CHandle->pCurrentJob != NULL)
+				{
+					I2C_JobDone(Copy_pstrI2CHandle, ES_OK);
+
+					//TXE is still set from this job, the next one must not see it before its address phase
+					return;
+				}
+				else if(Copy_pstrI2CHandle->TxLen == 0 && Copy_pstrI2CHandle->MemAddrIdx == Copy_pstrI2CHandle->MemAddrLen)
+				{
+					//1. generate the STOP condition
+					if(Copy_pstrI2CHandle->Sr == I2C_DisableRepStart)
+					{
+						MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
+					}
+
+					//2. reset all the member elements of the handle structure.
+					I2C_CloseSendData(Copy_pstrI2CHandle);
+
+					//3. notify the application about transmission complete
+					Copy_pstrI2CHandle->CallBackFun(I2C_Event_TxComplete);
+				}
+			}
+		}
+		else if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTxDMA)
+		{
+			u16 Local_u16Remaining = 0;
+
+			//BTF may also be a DMA write that came late, the flag stays set until DR is written
+			DMA_enuGetRemaining(Copy_pstrI2CHandle->pTxDMAHandle, &Local_u16Remaining);
+
+			if(Local_u16Remaining == 0)
+			{
+				if(Copy_pstrI2CHandle->Sr == I2C_DisableRepStart)
+				{
+					MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
+				}
+
+				Copy_pstrI2CHandle->TxLen = 0;
+
+				I2C_CloseDMA(Copy_pstrI2CHandle);
+
+				if(Copy_pstrI2CHandle->CallBackFun != NULL)
+				{
+					Copy_pstrI2CHandle->CallBackFun(I2C_Event_TxComplete);
+				}
+			}
+		}
+	}
+
+	temp3   = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_STOPF);
+	//4. Handle For interrupt generated by STOPF event
+	// Note : Stop detection flag is applicable only slave mode . For master this flag will never be set
+	//The below code block will not be executed by the master since STOPF will not set in master mode
+	if(temp2 && temp3)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_STOPF);
+
+		//STOF flag is set
+		//Clear the STOPF ( i.e 1) read SR1 2) Write to CR1 )
+		MCAL_I2C_ClearSTOPFlag(Local_pstrI2CBaseAddr);
+
+		if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInSlaveDMA)
+		{
+			I2C_SlaveNoStretchEnd(Copy_pstrI2CHandle);
+		}
+		else if(Copy_pstrI2CHandle->pRegMap != NULL)
+		{
+			I2C_SlaveRegMapEndWrite(Copy_pstrI2CHandle);
+		}
+		else
+		{
+			//Notify the application that STOP is detected
+			Copy_pstrI2CHandle->CallBackFun(I2C_Event_Stop);
+		}
+	}
+
+
+	temp3  = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_TXE);
+	//5. Handle For interrupt generated by TXE event
+	if(temp1 && temp2 && temp3)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_TXE);
+
 		//Check for device mode
 		if(MCAL_I2C_GetDeviceMode(Local_pstrI2CBaseAddr) == MCAL_I2C_MASTER)
 		{
-			//TXE flag is set
-			//We have to do the data transmission
-			if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTx)
+			//TXE flag is set
+			//We have to do the data transmission
+			if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTx)
+			{
+				I2C_MasterHandleTXEInterrupt(Copy_pstrI2CHandle);
+			}
+		}
+		else
+		{
+			//slave
+			//make sure that the slave is really in transmitter mode
+			if(MCAL_I2C_GetTransceiverMode(Local_pstrI2CBaseAddr)==MCAL_I2C_TRANSMITTER)
+			{
+				if(Copy_pstrI2CHandle->pRegMap != NULL)
+				{
+					MCAL_I2C_WriteDataByte(Local_pstrI2CBaseAddr, Copy_pstrI2CHandle->pRegMap[Copy_pstrI2CHandle->RegPtr]);
+
+					Copy_pstrI2CHandle->RegPtr = (Copy_pstrI2CHandle->RegPtr + 1) % Copy_pstrI2CHandle->RegMapSize;
+				}
+				else
+				{
+					Copy_pstrI2CHandle->CallBackFun(I2C_Event_DataReq);
+				}
+			}
+		}
+	}
+
+	temp3  = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_RXNE);
+	//6. Handle For interrupt generated by RXNE event
+	if(temp1 && temp2 && temp3)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_RXNE);
+
+		//check device mode .
+		if(MCAL_I2C_GetDeviceMode(Local_pstrI2CBaseAddr) == MCAL_I2C_MASTER)
+		{
+			//The device is master
+			//RXNE flag is set
+			if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx)
+			{
+				I2C_MasterHandleRXNEInterrupt(Copy_pstrI2CHandle);
+			}
+
+		}
+		else
+		{
+			//slave
+			//make sure that the slave is really in receiver mode
+			if(MCAL_I2C_GetTransceiverMode(Local_pstrI2CBaseAddr)==MCAL_I2C_RECEIVER)
+			{
+				if(Copy_pstrI2CHandle->pRegMap != NULL)
+				{
+					u8 Local_u8Data = (u8)MCAL_I2C_ReadDataByte(Local_pstrI2CBaseAddr);
+
+					if(Copy_pstrI2CHandle->RegPtrPending)
+					{
+						Copy_pstrI2CHandle->RegPtrPending = 0;
+						Copy_pstrI2CHandle->RegPtr = Local_u8Data % Copy_pstrI2CHandle->RegMapSize;
+					}
+					else
+					{
+						if(Copy_pstrI2CHandle->RegWriteLen == 0)
+						{
+							Copy_pstrI2CHandle->RegWriteStart = Copy_pstrI2CHandle->RegPtr;
+						}
+
+						Copy_pstrI2CHandle->pRegMap[Copy_pstrI2CHandle->RegPtr] = Local_u8Data;
+						Copy_pstrI2CHandle->RegWriteLen++;
+
+						Copy_pstrI2CHandle->RegPtr = (Copy_pstrI2CHandle->RegPtr + 1) % Copy_pstrI2CHandle->RegMapSize;
+					}
+				}
+				else
+				{
+					Copy_pstrI2CHandle->CallBackFun(I2C_Event_DataRcv);
+				}
+			}
+		}
+	}
+}
+
+
+
+static void I2C_ClearADDRFlag(I2C_Handle_t *Copy_pstrI2CHandle )
+{
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	//check for device mode
+	if(Local_pstrI2CBaseAddr->SR2 & ( 1 << MCAL_I2C_SR2_MSL))
+	{
+		//device is in master mode
+		if((Copy_pstrI2CHandle->DevAddr & I2C_ADDR_10BITS) && Copy_pstrI2CHandle->Addr10Done == 0)
+		{
+			//first ADDR of a 10 bits address (header + low byte, written), a read repeats START for the read header
+			Copy_pstrI2CHandle->Addr10Done = 1;
+
+			MCAL_I2C_ClearADDRFlag(Local_pstrI2CBaseAddr);
+
+			if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx || Copy_pstrI2CHandle->TxRxState == I2C_BusyInRxDMA)
+			{
+				MCAL_I2C_GenerateStartCondition(Local_pstrI2CBaseAddr);
+			}
+		}
+		else if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx || Copy_pstrI2CHandle->TxRxState == I2C_BusyInRxDMA)
+		{
+			if(Copy_pstrI2CHandle->RxSize  == 1)
+			{
+				//first disable the ack
+				MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_DISABLE);
+				MCAL_I2C_ClearADDRFlag(Local_pstrI2CBaseAddr);
+
+				//with DMA nothing runs between the byte and the EOT, STOP is programmed now
+				if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRxDMA && Copy_pstrI2CHandle->Sr == I2C_DisableRepStart)
+				{
+					MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
+				}
+			}
+			else
+			{
+				MCAL_I2C_ClearADDRFlag(Local_pstrI2CBaseAddr);
+			}
+		}
+		else
+		{
+			MCAL_I2C_ClearADDRFlag(Local_pstrI2CBaseAddr);
+		}
+
+	}
+	else//device is in slave mode
+	{
+		//a write transaction starts with the register pointer, a repeated START may end a write without STOP
+		//DUALF is kept until STOP / repeated START
+		Copy_pstrI2CHandle->SlaveDualMatch = MCAL_I2C_GetDualFlag(Local_pstrI2CBaseAddr);
+
+		if(Copy_pstrI2CHandle->pRegMap != NULL)
+		{
+			I2C_SlaveRegMapEndWrite(Copy_pstrI2CHandle);
+
+			I2C_SlaveRegMapSelect(Copy_pstrI2CHandle, Copy_pstrI2CHandle->SlaveDualMatch);
+
+			Copy_pstrI2CHandle->RegPtrPending =
+					(MCAL_I2C_GetTransceiverMode(Local_pstrI2CBaseAddr) == MCAL_I2C_RECEIVER);
+		}
+
+		MCAL_I2C_ClearADDRFlag(Local_pstrI2CBaseAddr);
+	}
+
+}
+
+
+void I2C_ER_IRQHandling(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+
+	u32 temp1,temp2;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	temp2   = MCAL_I2C_GetInterruptStatus(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT);
+
+	/***********************Check for Bus error************************************/
+	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_BERR);
+	if(temp1  && temp2 )
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_BERR);
+
+		//This is Bus error
+
+		//Implement the code to clear the buss error flag
+		MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_BERR);
+
+		//a DMA transfer would wait forever for requests that will not come
+		I2C_CloseDMA(Copy_pstrI2CHandle);
+
+		//Implement the code to notify the application about the error
+		if(Copy_pstrI2CHandle->pCurrentJob != NULL)
+		{
+			I2C_JobDone(Copy_pstrI2CHandle, ES_NOT_OK);
+		}
+		else
+		{
+			Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorBerr);
+		}
+	}
+
+	/***********************Check for arbitration lost error************************************/
+	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_ARLO);
+	if(temp1  && temp2)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_ARLO);
+
+		//This is arbitration lost error
+
+		//Implement the code to clear the buss error flag
+		MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_ARLO);
+
+		Copy_pstrI2CHandle->ArloStats.ArbitrationLost++;
+
+		//the peripheral is back in slave mode, an IT transfer is restarted later from its start
+		if(I2C_ArloRetry(Copy_pstrI2CHandle))
+		{
+			Copy_pstrI2CHandle->ArloStats.Retries++;
+		}
+		else
+		{
+			if(Copy_pstrI2CHandle->I2C_Config.I2C_ArloRetries > 0)
 			{
-				I2C_MasterHandleTXEInterrupt(Copy_pstrI2CHandle);
+				Copy_pstrI2CHandle->ArloStats.GiveUps++;
+			}
+
+			//a DMA transfer would wait forever for requests that will not come
+			I2C_CloseDMA(Copy_pstrI2CHandle);
+
+			//Implement the code to notify the application about the error
+			if(Copy_pstrI2CHandle->pCurrentJob != NULL)
+			{
+				I2C_JobDone(Copy_pstrI2CHandle, ES_NOT_OK);
+			}
+			else
+			{
+				if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx)
+				{
+					I2C_CloseReceiveData(Copy_pstrI2CHandle);
+				}
+				else if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTx)
+				{
+					I2C_CloseSendData(Copy_pstrI2CHandle);
+				}
+
+				Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorArlo);
+			}
+		}
+
+	}
+
+	/***********************Check for ACK failure  error************************************/
+
+	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_AF);
+	if(temp1  && temp2)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_AF);
+
+		//This is ACK failure error
+
+		//Implement the code to clear the buss error flag
+		MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_AF);
+
+		//a DMA transfer would wait forever for requests that will not come, the master releases the bus
+		if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTxDMA || Copy_pstrI2CHandle->TxRxState == I2C_BusyInRxDMA)
+		{
+			MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
+			I2C_CloseDMA(Copy_pstrI2CHandle);
+		}
+
+		//Implement the code to notify the application about the error
+		if(Copy_pstrI2CHandle->pCurrentJob != NULL)
+		{
+			Copy_pstrI2CHandle->pCurrentJob->AddrNack = ! Copy_pstrI2CHandle->AddrAcked;
+
+			I2C_JobDone(Copy_pstrI2CHandle, ES_NOT_OK);
+		}
+		else if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInSlaveDMA)
+		{
+			//end of a master read, DR is preloaded again for the next one
+			Copy_pstrI2CHandle->SlaveStats.Transactions++;
+
+			I2C_SlaveNoStretchArm(Copy_pstrI2CHandle);
+		}
+		else if(Copy_pstrI2CHandle->pRegMap != NULL)
+		{
+			//the master NACKs the last byte it reads, this is the end of the read not an error,
+			//the byte already loaded in DR after it was not sent
+			Copy_pstrI2CHandle->RegPtr = (Copy_pstrI2CHandle->RegPtr + Copy_pstrI2CHandle->RegMapSize - 1) %
+					Copy_pstrI2CHandle->RegMapSize;
+		}
+		else
+		{
+			Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorAf);
+		}
+	}
+
+	/***********************Check for Overrun/underrun error************************************/
+	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_OVR);
+	if(temp1  && temp2)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_OVR);
+
+		//This is Overrun/underrun
+
+		//Implement the code to clear the buss error flag
+			MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_OVR);
+
+			if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInSlaveDMA)
+			{
+				//without stretching this is the master running past the buffers, counted not notified
+				if(MCAL_I2C_GetTransceiverMode(Local_pstrI2CBaseAddr) == MCAL_I2C_TRANSMITTER)
+				{
+					Copy_pstrI2CHandle->SlaveStats.Underruns++;
+				}
+				else
+				{
+					Copy_pstrI2CHandle->SlaveStats.Overruns++;
+				}
+			}
+			else
+			{
+				//Implement the code to notify the application about the error
+				Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorOvr);
 			}
+	}
+
+	/***********************Check for Time out error************************************/
+	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_TIMEOUT);
+	if(temp1  && temp2)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_TIMEOUT);
+
+		//This is SMBus timeout, SCL was held low too long
+		//a master has sent STOP and a slave has released the lines by hardware
+
+		//Implement the code to clear the buss error flag
+		MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_TIMEOUT);
+
+		I2C_CloseDMA(Copy_pstrI2CHandle);
+
+		//Implement the code to notify the application about the error
+		if(Copy_pstrI2CHandle->pCurrentJob != NULL)
+		{
+			I2C_JobDone(Copy_pstrI2CHandle, ES_TIME_OUT);
 		}
 		else
 		{
-			//slave
-			//make sure that the slave is really in transmitter mode
-			if(MCAL_I2C_GetTransceiverMode(Local_pstrI2CBaseAddr)==MCAL_I2C_TRANSMITTER)
+			if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx)
+			{
+				I2C_CloseReceiveData(Copy_pstrI2CHandle);
+			}
+			else if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTx)
 			{
-				Copy_pstrI2CHandle->CallBackFun(I2C_Event_DataReq);
+				I2C_CloseSendData(Copy_pstrI2CHandle);
 			}
+
+			Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorTimeout);
+		}
+	}
+
+	/***********************Check for PEC error************************************/
+	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_PECERR);
+	if(temp1  && temp2)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_PECERR);
+
+		MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_PECERR);
+
+		//a master reception reports it with its last byte
+		if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx)
+		{
+			Copy_pstrI2CHandle->PECError = 1;
+		}
+		else
+		{
+			Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorPec);
+		}
+	}
+
+	/***********************Check for SMBus alert************************************/
+	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_SMBALERT);
+	if(temp1  && temp2)
+	{
+		I2C_TRACE(Copy_pstrI2CHandle, Local_pstrI2CBaseAddr, I2C_Trace_SMBALERT);
+
+		MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_SMBALERT);
+
+		Copy_pstrI2CHandle->CallBackFun(I2C_Event_SMBusAlert);
+	}
+}
+
+
+
+static void I2C_DMAConfig(DMA_Handle_t *Copy_pstrDMAHandle, DMA_Direction_t Copy_enuDirection)
+{
+	Copy_pstrDMAHandle->DMAConfig.DMA_Direction = Copy_enuDirection;
+	Copy_pstrDMAHandle->DMAConfig.DMA_PeriphDataSize = DMA_DataSize_Byte;
+	Copy_pstrDMAHandle->DMAConfig.DMA_MemDataSize = DMA_DataSize_Byte;
+	Copy_pstrDMAHandle->DMAConfig.DMA_PeriphInc = DMA_Inc_Disable;
+	Copy_pstrDMAHandle->DMAConfig.DMA_MemInc = DMA_Inc_Enable;
+	Copy_pstrDMAHandle->DMAConfig.DMA_Mode = DMA_Mode_Normal;
+	Copy_pstrDMAHandle->DMAConfig.DMA_Priority = DMA_Priority_High;
+
+	DMA_enuInit(Copy_pstrDMAHandle);
+}
+
+
+static void I2C_CloseDMA(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInTxDMA)
+	{
+		DMA_enuStop(Copy_pstrI2CHandle->pTxDMAHandle);
+	}
+	else if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRxDMA)
+	{
+		DMA_enuStop(Copy_pstrI2CHandle->pRxDMAHandle);
+		MCAL_I2C_LastTransferControl(Local_pstrI2CBaseAddr, DISABLE);
+	}
+	else
+	{
+		return;
+	}
+
+	MCAL_I2C_DMAControl(Local_pstrI2CBaseAddr, DISABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, DISABLE);
+
+	if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRxDMA)
+	{
+		I2C_CloseReceiveData(Copy_pstrI2CHandle);
+	}
+	else
+	{
+		I2C_CloseSendData(Copy_pstrI2CHandle);
+	}
+}
+
+
+static ES_t I2C_MemStartIT(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u16 Copy_u16MemAddr,
+		I2C_MemAddrSize_t Copy_enuMemAddrSize)
+{
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	if(Copy_enuMemAddrSize == I2C_MemAddr_16Bits)
+	{
+		Copy_pstrI2CHandle->MemAddr[0] = (u8)(Copy_u16MemAddr >> 8);
+		Copy_pstrI2CHandle->MemAddr[1] = (u8)Copy_u16MemAddr;
+	}
+	else if(Copy_enuMemAddrSize == I2C_MemAddr_8Bits)
+	{
+		Copy_pstrI2CHandle->MemAddr[0] = (u8)Copy_u16MemAddr;
+	}
+	else
+	{
+		Copy_pstrI2CHandle->MemRead = 0;
+		return I2C_Release(Copy_pstrI2CHandle, I2C_DisableRepStart, ES_NOT_OK);
+	}
+
+	Copy_pstrI2CHandle->MemAddrLen = Copy_enuMemAddrSize;
+	Copy_pstrI2CHandle->MemAddrIdx = 0;
+	Copy_pstrI2CHandle->DevAddr = Copy_u16SlaveAddr;
+	Copy_pstrI2CHandle->Sr = I2C_DisableRepStart;
+
+	I2C_SaveStart(Copy_pstrI2CHandle);
+
+	MCAL_I2C_GenerateStartCondition(Local_pstrI2CBaseAddr);
+
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT, ENABLE);
+
+	return ES_OK;
+}
+
+
+static u32 I2C_GetTimeout(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	if(Copy_pstrI2CHandle->I2C_Config.I2C_TimeoutTicks == 0)
+	{
+		return I2C_DEFAULT_TIMEOUT_TICKS;
+	}
+
+	return Copy_pstrI2CHandle->I2C_Config.I2C_TimeoutTicks;
+}
+
+
+static ES_t I2C_WaitFlag(I2C_Handle_t *Copy_pstrI2CHandle, u32 Copy_u32Flags)
+{
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	u32 Local_u32Start = 0;
+	u32 Local_u32Now = 0;
+	u32 Local_u32Timeout = I2C_GetTimeout(Copy_pstrI2CHandle);
+
+	SysTick_enuGetTicks(&Local_u32Start);
+
+	//all flags of Copy_u32Flags must be set
+	while((Local_pstrI2CBaseAddr->SR1 & Copy_u32Flags) != Copy_u32Flags)
+	{
+		//NACK, lost arbitration and bus error end the transfer at once
+		if(MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_AF | MCAL_I2C_FLAG_ARLO | MCAL_I2C_FLAG_BERR))
+		{
+			MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_AF | MCAL_I2C_FLAG_ARLO | MCAL_I2C_FLAG_BERR);
+			return ES_NOT_OK;
+		}
+
+		SysTick_enuGetTicks(&Local_u32Now);
+
+		if((Local_u32Now - Local_u32Start) >= Local_u32Timeout)
+		{
+			return ES_TIME_OUT;
+		}
+	}
+
+	return ES_OK;
+}
+
+
+static ES_t I2C_AbortPolling(I2C_Handle_t *Copy_pstrI2CHandle, ES_t Copy_enuError)
+{
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	if(Copy_enuError == ES_TIME_OUT && Copy_pstrI2CHandle->pSCLPinHandle != NULL &&
+			Copy_pstrI2CHandle->pSDAPinHandle != NULL)
+	{
+		//a slave holding the lines, or a peripheral stuck in BUSY
+		I2C_enuBusRecovery(Copy_pstrI2CHandle);
+	}
+	else
+	{
+		MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
+
+		if(Copy_pstrI2CHandle->I2C_Config.I2C_AckControl == I2C_ACK_Enable)
+		{
+			MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_ENABLE);
 		}
 	}
 
-	temp3  = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_RXNE);
-	//6. Handle For interrupt generated by RXNE event
-	if(temp1 && temp2 && temp3)
+	return I2C_Release(Copy_pstrI2CHandle, I2C_DisableRepStart, Copy_enuError);
+}
+
+
+static ES_t I2C_Claim(I2C_Handle_t *Copy_pstrI2CHandle, I2C_BusyStete_t Copy_enuState)
+{
+	ES_t Local_enuErrorState = ES_FUNC_IS_BUSY;
+
+	//the event, error and DMA interrupts and I2C_enuArloService start jobs, one may start between the test and the claim
+	u32 Local_u32PriMask = I2C_JobLock();
+
+	if(Copy_pstrI2CHandle->TxRxState == I2C_Ready)
+	{
+		Copy_pstrI2CHandle->TxRxState = Copy_enuState;
+
+		Local_enuErrorState = ES_OK;
+	}
+
+	I2C_JobUnlock(Local_u32PriMask);
+
+	return Local_enuErrorState;
+}
+
+
+static ES_t I2C_Release(I2C_Handle_t *Copy_pstrI2CHandle, I2C_RepStartCtrl_t Copy_enuSr, ES_t Copy_enuError)
+{
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	Copy_pstrI2CHandle->TxRxState = I2C_Ready;
+
+	//jobs submitted meanwhile, the bus kept for a repeated START stays with the caller
+	if(Copy_enuSr == I2C_DisableRepStart || Copy_enuError != ES_OK || MCAL_I2C_GetStopStatus(Local_pstrI2CBaseAddr))
+	{
+		I2C_JobKick(Copy_pstrI2CHandle);
+	}
+
+	return Copy_enuError;
+}
+
+
+static void I2C_RecoveryDelay(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	u32 Local_u32APB1ClkFreq = 0;
+
+	RCC_enuGetAPB1Value(&Local_u32APB1ClkFreq);
+
+	//half an SCL period in APB1 cycles, the core runs at least as fast and a loop takes several cycles
+	__vo u32 Local_u32Loops = Local_u32APB1ClkFreq / (2 * Copy_pstrI2CHandle->I2C_Config.I2C_SCLSpeed);
+
+	while(Local_u32Loops > 0)
+	{
+		Local_u32Loops--;
+	}
+}
+
+
+static u8 I2C_JobIsBefore(I2C_Job_t *Copy_pstrJob, I2C_Job_t *Copy_pstrOther)
+{
+	if(Copy_pstrJob->Priority != Copy_pstrOther->Priority)
 	{
-		//check device mode .
-		if(MCAL_I2C_GetDeviceMode(Local_pstrI2CBaseAddr) == MCAL_I2C_MASTER)
-		{
-			//The device is master
-			//RXNE flag is set
-			if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx)
-			{
-				I2C_MasterHandleRXNEInterrupt(Copy_pstrI2CHandle);
-			}
+		return (Copy_pstrJob->Priority > Copy_pstrOther->Priority);
+	}
 
-		}
-		else
-		{
-			//slave
-			//make sure that the slave is really in receiver mode
-			if(MCAL_I2C_GetTransceiverMode(Local_pstrI2CBaseAddr)==MCAL_I2C_RECEIVER)
-			{
-				Copy_pstrI2CHandle->CallBackFun(I2C_Event_DataRcv);
-			}
-		}
+	//same priority, earliest deadline first, a job without deadline keeps submission order
+	if(Copy_pstrJob->Deadline == 0)
+	{
+		return 0;
+	}
+
+	if(Copy_pstrOther->Deadline == 0)
+	{
+		return 1;
 	}
+
+	//wrap safe comparison of tick values
+	return ((s32)(Copy_pstrJob->Deadline - Copy_pstrOther->Deadline) < 0);
 }
 
 
+static u32 I2C_JobLock(void)
+{
+	//the DMA interrupts close transfers too, the I2C interrupt enables alone do not hold them off
+	return MCAL_PRIMASK_DisableIRQ();
+}
 
-static void I2C_ClearADDRFlag(I2C_Handle_t *Copy_pstrI2CHandle )
+
+static void I2C_JobUnlock(u32 Copy_u32PriMask)
+{
+	MCAL_PRIMASK_RestoreIRQ(Copy_u32PriMask);
+}
+
+
+static void I2C_JobStartNext(I2C_Handle_t *Copy_pstrI2CHandle)
 {
+	I2C_Job_t *Local_pstrJob = Copy_pstrI2CHandle->pJobHead;
+
+	if(Local_pstrJob == NULL || Copy_pstrI2CHandle->pCurrentJob != NULL || Copy_pstrI2CHandle->TxRxState != I2C_Ready)
+		return;
+
 	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
 
-	//check for device mode
-	if(Local_pstrI2CBaseAddr->SR2 & ( 1 << MCAL_I2C_SR2_MSL))
-	{
-		//device is in master mode
-		if(Copy_pstrI2CHandle->TxRxState == MCAL_I2C_BUSY_IN_RX)
-		{
-			if(Copy_pstrI2CHandle->RxSize  == 1)
-			{
-				//first disable the ack
-				MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_DISABLE);
-				MCAL_I2C_ClearADDRFlag(Local_pstrI2CBaseAddr);
-			}
-		}
-		else
-		{
-			MCAL_I2C_ClearADDRFlag(Local_pstrI2CBaseAddr);
-		}
+	//the bus is still ours: the STOP of the previous transfer on its way or a caller keeping it
+	//for a repeated START, the job stays queued for I2C_enuArloService (interrupts are masked here)
+	if(MCAL_I2C_GetStopStatus(Local_pstrI2CBaseAddr) || MCAL_I2C_GetMasterStatus(Local_pstrI2CBaseAddr))
+		return;
+
+	Copy_pstrI2CHandle->pJobHead = Local_pstrJob->pNext;
+	Copy_pstrI2CHandle->pCurrentJob = Local_pstrJob;
 
+	Local_pstrJob->AddrNack = 0;
+
+	Copy_pstrI2CHandle->DevAddr = Local_pstrJob->SlaveAddr;
+	Copy_pstrI2CHandle->Sr = I2C_DisableRepStart;
+	Copy_pstrI2CHandle->MemAddrLen = 0;
+	Copy_pstrI2CHandle->MemAddrIdx = 0;
+	Copy_pstrI2CHandle->pRxBuffer = Local_pstrJob->pRxData;
+	Copy_pstrI2CHandle->RxLen = Local_pstrJob->RxLen;
+	Copy_pstrI2CHandle->RxSize = Local_pstrJob->RxLen;
+
+	if(Local_pstrJob->TxLen > 0)
+	{
+		//a read after the write turns around at BTF as a register read
+		Copy_pstrI2CHandle->pTxBuffer = Local_pstrJob->pTxData;
+		Copy_pstrI2CHandle->TxLen = Local_pstrJob->TxLen;
+		Copy_pstrI2CHandle->MemRead = (Local_pstrJob->RxLen > 0);
+		Copy_pstrI2CHandle->TxRxState = I2C_BusyInTx;
 	}
-	else//device is in slave mode
+	else
 	{
-		MCAL_I2C_ClearADDRFlag(Local_pstrI2CBaseAddr);
+		Copy_pstrI2CHandle->TxLen = 0;
+		Copy_pstrI2CHandle->MemRead = 0;
+		Copy_pstrI2CHandle->TxRxState = I2C_BusyInRx;
+
+		MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_ENABLE);
 	}
 
+	I2C_SaveStart(Copy_pstrI2CHandle);
+
+	//START on an owned bus is a repeated START
+	MCAL_I2C_GenerateStartCondition(Local_pstrI2CBaseAddr);
+
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT, ENABLE);
 }
 
 
-void I2C_ER_IRQHandling(I2C_Handle_t *Copy_pstrI2CHandle)
+static void I2C_JobKick(I2C_Handle_t *Copy_pstrI2CHandle)
 {
+	u32 Local_u32PriMask = I2C_JobLock();
 
-	u32 temp1,temp2;
+	I2C_JobStartNext(Copy_pstrI2CHandle);
+
+	I2C_JobUnlock(Local_u32PriMask);
+}
 
+
+static void I2C_JobDone(I2C_Handle_t *Copy_pstrI2CHandle, ES_t Copy_enuResult)
+{
 	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
 
-	temp2   = MCAL_I2C_GetInterruptStatus(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT);
+	I2C_Job_t *Local_pstrJob = Copy_pstrI2CHandle->pCurrentJob;
 
-	/***********************Check for Bus error************************************/
-	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_BERR);
-	if(temp1  && temp2 )
+	//the bus is kept for the next job only after a clean transfer that allows it
+	if(Copy_enuResult != ES_OK || Local_pstrJob->Sr != I2C_EnableRepStart || Copy_pstrI2CHandle->pJobHead == NULL)
 	{
-		//This is Bus error
+		MCAL_I2C_GenerateStopCondition(Local_pstrI2CBaseAddr);
+	}
 
-		//Implement the code to clear the buss error flag
-		MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_BERR);
+	I2C_JobEnd(Copy_pstrI2CHandle, Copy_enuResult);
+}
 
-		//Implement the code to notify the application about the error
-		Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorBerr);
+
+/*
+ * Completes the current job without touching the bus
+ */
+static void I2C_JobEnd(I2C_Handle_t *Copy_pstrI2CHandle, ES_t Copy_enuResult)
+{
+	I2C_Job_t *Local_pstrJob = Copy_pstrI2CHandle->pCurrentJob;
+
+	Copy_pstrI2CHandle->ArloPending = 0;
+
+	if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx)
+	{
+		I2C_CloseReceiveData(Copy_pstrI2CHandle);
+	}
+	else
+	{
+		I2C_CloseSendData(Copy_pstrI2CHandle);
 	}
 
-	/***********************Check for arbitration lost error************************************/
-	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_ARLO);
-	if(temp1  && temp2)
+	Copy_pstrI2CHandle->pCurrentJob = NULL;
+
+	Local_pstrJob->Result = Copy_enuResult;
+
+	if(Local_pstrJob->CallBackFunc != NULL)
 	{
-		//This is arbitration lost error
+		Local_pstrJob->CallBackFunc(Local_pstrJob);
+	}
 
-		//Implement the code to clear the buss error flag
-		MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_ARLO);
+	//the callback may have submitted (and started) a job already
+	I2C_JobStartNext(Copy_pstrI2CHandle);
+}
 
-		//Implement the code to notify the application about the error
-		Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorArlo);
 
+static void I2C_SlaveRegMapEndWrite(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	u16 Local_u16Len = Copy_pstrI2CHandle->RegWriteLen;
+
+	if(Local_u16Len == 0)
+		return;
+
+	Copy_pstrI2CHandle->RegWriteLen = 0;
+
+	if(Copy_pstrI2CHandle->RegWriteCallBackFunc != NULL)
+	{
+		Copy_pstrI2CHandle->RegWriteCallBackFunc(Copy_pstrI2CHandle->RegWriteStart, Local_u16Len);
 	}
+}
 
-	/***********************Check for ACK failure  error************************************/
 
-	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_AF);
-	if(temp1  && temp2)
+static u8 I2C_PECFailed(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	u8 Local_u8Failed = 0;
+
+	if(Copy_pstrI2CHandle->PECLen == 0)
+		return 0;
+
+	//PECERR comes with the RXNE of the PEC byte, the error interrupt may have taken it already
+	if(MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_PECERR))
 	{
-		//This is ACK failure error
+		MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_PECERR);
+		Copy_pstrI2CHandle->PECError = 1;
+	}
 
-		//Implement the code to clear the buss error flag
-		MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_AF);
+	Local_u8Failed = Copy_pstrI2CHandle->PECError;
 
-		//Implement the code to notify the application about the error
-		Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorAf);
+	Copy_pstrI2CHandle->PECError = 0;
+
+	return Local_u8Failed;
+}
+
+
+static void I2C_SaveStart(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	Copy_pstrI2CHandle->XferStart.pTxBuffer = Copy_pstrI2CHandle->pTxBuffer;
+	Copy_pstrI2CHandle->XferStart.pRxBuffer = Copy_pstrI2CHandle->pRxBuffer;
+	Copy_pstrI2CHandle->XferStart.TxLen = Copy_pstrI2CHandle->TxLen;
+	Copy_pstrI2CHandle->XferStart.RxLen = Copy_pstrI2CHandle->RxLen;
+	Copy_pstrI2CHandle->XferStart.MemAddrLen = Copy_pstrI2CHandle->MemAddrLen;
+	Copy_pstrI2CHandle->XferStart.MemRead = Copy_pstrI2CHandle->MemRead;
+	Copy_pstrI2CHandle->XferStart.SMBusBlock = Copy_pstrI2CHandle->SMBusBlock;
+	Copy_pstrI2CHandle->XferStart.TxRxState = Copy_pstrI2CHandle->TxRxState;
+
+	Copy_pstrI2CHandle->Addr10Done = 0;
+	Copy_pstrI2CHandle->AddrAcked = 0;
+	Copy_pstrI2CHandle->ArloAttempts = 0;
+}
+
+
+/*
+ * Schedules the restart of the running IT transfer, 0 when it is not restarted
+ */
+static u8 I2C_ArloRetry(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	u32 Local_u32Window = 0;
+
+	if(Copy_pstrI2CHandle->TxRxState != I2C_BusyInTx && Copy_pstrI2CHandle->TxRxState != I2C_BusyInRx)
+		return 0;
+
+	if(Copy_pstrI2CHandle->ArloAttempts >= Copy_pstrI2CHandle->I2C_Config.I2C_ArloRetries)
+		return 0;
+
+	Copy_pstrI2CHandle->ArloAttempts++;
+
+	//binary exponential backoff, the other master(s) pick different slots
+	Local_u32Window = 1UL << Copy_pstrI2CHandle->ArloAttempts;
+
+	if(Local_u32Window > I2C_ARLO_MAX_BACKOFF_TICKS)
+	{
+		Local_u32Window = I2C_ARLO_MAX_BACKOFF_TICKS;
 	}
 
-	/***********************Check for Overrun/underrun error************************************/
-	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_OVR);
-	if(temp1  && temp2)
+	SysTick_enuGetTicks(&Copy_pstrI2CHandle->ArloTick);
+
+	Copy_pstrI2CHandle->ArloSeed = (Copy_pstrI2CHandle->ArloSeed ^ Copy_pstrI2CHandle->ArloTick) * 1664525UL + 1013904223UL;
+	Copy_pstrI2CHandle->ArloBackoff = (Copy_pstrI2CHandle->ArloSeed >> 16) % Local_u32Window;
+
+	Copy_pstrI2CHandle->ArloPending = 1;
+
+	return 1;
+}
+
+
+static void I2C_ArloRestart(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	Copy_pstrI2CHandle->pTxBuffer = Copy_pstrI2CHandle->XferStart.pTxBuffer;
+	Copy_pstrI2CHandle->pRxBuffer = Copy_pstrI2CHandle->XferStart.pRxBuffer;
+	Copy_pstrI2CHandle->TxLen = Copy_pstrI2CHandle->XferStart.TxLen;
+	Copy_pstrI2CHandle->RxLen = Copy_pstrI2CHandle->XferStart.RxLen;
+	Copy_pstrI2CHandle->RxSize = Copy_pstrI2CHandle->XferStart.RxLen;
+	Copy_pstrI2CHandle->MemAddrLen = Copy_pstrI2CHandle->XferStart.MemAddrLen;
+	Copy_pstrI2CHandle->MemAddrIdx = 0;
+	Copy_pstrI2CHandle->MemRead = Copy_pstrI2CHandle->XferStart.MemRead;
+	Copy_pstrI2CHandle->SMBusBlock = Copy_pstrI2CHandle->XferStart.SMBusBlock;
+	Copy_pstrI2CHandle->TxRxState = Copy_pstrI2CHandle->XferStart.TxRxState;
+	Copy_pstrI2CHandle->PECLen = 0;
+	Copy_pstrI2CHandle->Addr10Done = 0;
+	Copy_pstrI2CHandle->AddrAcked = 0;
+
+	Copy_pstrI2CHandle->ArloPending = 0;
+
+	//a read may have lost the bus after its NACK was armed
+	if(Copy_pstrI2CHandle->TxRxState == I2C_BusyInRx)
 	{
-		//This is Overrun/underrun
+		MCAL_I2C_AckBitControl(Local_pstrI2CBaseAddr, MCAL_I2C_ACK_ENABLE);
+	}
 
-		//Implement the code to clear the buss error flag
-			MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_OVR);
+	MCAL_I2C_GenerateStartCondition(Local_pstrI2CBaseAddr);
 
-			//Implement the code to notify the application about the error
-			Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorOvr);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITBUFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITEVFEN_INT, ENABLE);
+	MCAL_I2C_InterruptControl(Local_pstrI2CBaseAddr, MCAL_I2C_ITERREN_INT, ENABLE);
+}
+
+
+/*
+ * Polling address phase from SB up to ADDR set (not cleared), 7 or 10 bits
+ */
+static ES_t I2C_AddressPhase(I2C_Handle_t *Copy_pstrI2CHandle, u16 Copy_u16SlaveAddr, u8 Copy_u8Read)
+{
+	ES_t Local_enuErrorState = ES_NOT_OK;
+
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	//the whole sequence is run here, I2C_ClearADDRFlag then only clears the last ADDR
+	Copy_pstrI2CHandle->DevAddr = Copy_u16SlaveAddr;
+	Copy_pstrI2CHandle->Addr10Done = 1;
+
+	if((Copy_u16SlaveAddr & I2C_ADDR_10BITS) == 0)
+	{
+		if(Copy_u8Read)
+		{
+			MCAL_I2C_ExecuteAddressPhaseRead(Local_pstrI2CBaseAddr, (u8)Copy_u16SlaveAddr);
+		}
+		else
+		{
+			MCAL_I2C_ExecuteAddressPhaseWrite(Local_pstrI2CBaseAddr, (u8)Copy_u16SlaveAddr);
+		}
+
+		return I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_ADDR);
 	}
 
-	/***********************Check for Time out error************************************/
-	temp1 = MCAL_I2C_GetFlagStatus(Local_pstrI2CBaseAddr, MCAL_I2C_FLAG_TIMEOUT);
-	if(temp1  && temp2)
+	//header 11110 A9 A8 0, then the low byte once ADD10 is set
+	MCAL_I2C_ExecuteAddressHeader10Bits(Local_pstrI2CBaseAddr, Copy_u16SlaveAddr, 0);
+
+	Local_enuErrorState = I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_ADD10);
+
+	if(Local_enuErrorState != ES_OK)
+		return Local_enuErrorState;
+
+	MCAL_I2C_ExecuteAddressLow10Bits(Local_pstrI2CBaseAddr, Copy_u16SlaveAddr);
+
+	Local_enuErrorState = I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_ADDR);
+
+	if(Local_enuErrorState != ES_OK || Copy_u8Read == 0)
+		return Local_enuErrorState;
+
+	//read: repeated START and the header alone with r/nw = 1
+	MCAL_I2C_ClearADDRFlag(Local_pstrI2CBaseAddr);
+
+	MCAL_I2C_GenerateStartCondition(Local_pstrI2CBaseAddr);
+
+	Local_enuErrorState = I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_SB);
+
+	if(Local_enuErrorState != ES_OK)
+		return Local_enuErrorState;
+
+	MCAL_I2C_ExecuteAddressHeader10Bits(Local_pstrI2CBaseAddr, Copy_u16SlaveAddr, 1);
+
+	return I2C_WaitFlag(Copy_pstrI2CHandle, MCAL_I2C_FLAG_ADDR);
+}
+
+
+/*
+ * Switches the register map to the one of the matched slave address (if it has its own)
+ */
+static void I2C_SlaveRegMapSelect(I2C_Handle_t *Copy_pstrI2CHandle, u8 Copy_u8Slot)
+{
+	I2C_RegMapSlot_t *Local_pstrSlot = &Copy_pstrI2CHandle->RegMapSlot[Copy_u8Slot];
+
+	if(Copy_u8Slot == Copy_pstrI2CHandle->RegMapActive || Local_pstrSlot->pMap == NULL)
+		return;
+
+	Copy_pstrI2CHandle->RegMapSlot[Copy_pstrI2CHandle->RegMapActive].Ptr = Copy_pstrI2CHandle->RegPtr;
+
+	Copy_pstrI2CHandle->pRegMap = Local_pstrSlot->pMap;
+	Copy_pstrI2CHandle->RegMapSize = Local_pstrSlot->Size;
+	Copy_pstrI2CHandle->RegPtr = Local_pstrSlot->Ptr;
+	Copy_pstrI2CHandle->RegMapActive = Copy_u8Slot;
+}
+
+
+/*
+ * Starts both streams from the buffer starts, the first Tx byte is written to DR ahead of the address
+ */
+static void I2C_SlaveNoStretchArm(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	I2C_RegDef_t *Local_pstrI2CBaseAddr = MCAL_I2C_CODE_TO_BASADDR(Copy_pstrI2CHandle->I2C_ID);
+
+	if(Copy_pstrI2CHandle->pRxBuffer != NULL)
 	{
-		//This is Overrun/underrun
+		DMA_enuStop(Copy_pstrI2CHandle->pRxDMAHandle);
 
-		//Implement the code to clear the buss error flag
-			MCAL_I2C_ClearFlag(Local_pstrI2CBaseAddr,MCAL_I2C_FLAG_TIMEOUT);
+		DMA_enuStart(Copy_pstrI2CHandle->pRxDMAHandle, MCAL_I2C_GetDataRegAddress(Local_pstrI2CBaseAddr),
+				(u32)Copy_pstrI2CHandle->pRxBuffer, 0, (u16)Copy_pstrI2CHandle->RxSize);
+	}
 
-			//Implement the code to notify the application about the error
-			Copy_pstrI2CHandle->CallBackFun(I2C_Event_ErrorTimeout);
+	if(Copy_pstrI2CHandle->pTxBuffer != NULL)
+	{
+		DMA_enuStop(Copy_pstrI2CHandle->pTxDMAHandle);
+
+		MCAL_I2C_WriteDataByte(Local_pstrI2CBaseAddr, Copy_pstrI2CHandle->pTxBuffer[0]);
+
+		//the next bytes follow on TXE
+		if(Copy_pstrI2CHandle->TxLen > 1)
+		{
+			DMA_enuStart(Copy_pstrI2CHandle->pTxDMAHandle, MCAL_I2C_GetDataRegAddress(Local_pstrI2CBaseAddr),
+					(u32)(Copy_pstrI2CHandle->pTxBuffer + 1), 0, (u16)(Copy_pstrI2CHandle->TxLen - 1));
+		}
+	}
+}
+
+
+/*
+ * STOP: a master write is counted and notified, then everything is re-armed
+ */
+static void I2C_SlaveNoStretchEnd(I2C_Handle_t *Copy_pstrI2CHandle)
+{
+	u16 Local_u16Remaining = 0;
+	u16 Local_u16Received = 0;
+
+	if(Copy_pstrI2CHandle->pRxBuffer != NULL)
+	{
+		DMA_enuGetRemaining(Copy_pstrI2CHandle->pRxDMAHandle, &Local_u16Remaining);
+
+		Local_u16Received = (u16)Copy_pstrI2CHandle->RxSize - Local_u16Remaining;
+	}
+
+	//a write overwrote the preloaded byte in DR, a read ends at AF and was already re-armed
+	I2C_SlaveNoStretchArm(Copy_pstrI2CHandle);
+
+	if(Local_u16Received > 0)
+	{
+		Copy_pstrI2CHandle->SlaveStats.Transactions++;
+		Copy_pstrI2CHandle->SlaveStats.RxBytes += Local_u16Received;
+		Copy_pstrI2CHandle->SlaveStats.LastRxLen = Local_u16Received;
+
+		Copy_pstrI2CHandle->CallBackFun(I2C_Event_Stop);
 	}
 }
 
 
+#ifdef I2C_TRACE_ENABLE
+
+/*
+ * A few loads and stores per event, the ring keeps the last I2C_TRACE_LEN events
+ */
+static void I2C_TraceRecord(I2C_t Copy_enuI2CId, I2C_RegDef_t *Copy_pstrI2CBaseAddr, I2C_TraceEvent_t Copy_enuEvent)
+{
+	if(! I2C_TraceOn)
+		return;
+
+	//events come from ISRs of different priorities, claim the slot with interrupts masked
+	u32 Local_u32PriMask = MCAL_PRIMASK_DisableIRQ();
+	u32 Local_u32Slot = I2C_TraceHead++;
+	MCAL_PRIMASK_RestoreIRQ(Local_u32PriMask);
+
+	I2C_TraceRecord_t *Local_pstrRecord = &I2C_TraceBuffer[Local_u32Slot & (I2C_TRACE_LEN - 1)];
 
+	Local_pstrRecord->Cycles = MCAL_DWT_GetCycles();
+	Local_pstrRecord->Event = (u8)Copy_enuEvent;
+	Local_pstrRecord->I2C_ID = (u8)Copy_enuI2CId;
+	Local_pstrRecord->SR1 = (u16)Copy_pstrI2CBaseAddr->SR1;
+}
 
+#endif